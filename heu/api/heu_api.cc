@@ -14,6 +14,12 @@
 
 #include "heu/api/heu_api.h"
 
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "heu/library/phe/record_codec.h"
+
 void CheckCall(int ret, const std::string &desc) {
   if (ret != 0) {
     std::cerr << "Failed to call api about heu: " << desc << std::endl;
@@ -471,3 +477,236 @@ HEU_DLL int SumCiphers(DestinationHeKitHandle handle,
     };
   })
 }
+
+namespace {
+
+// run fn(begin, end) over [0, len) in chunks of GRAIN_SIZE elements
+template <typename Fn>
+void ParallelForChunks(const int64_t len, const int32_t n_threads, Fn &&fn) {
+  auto n_chunks = static_cast<int>((len + GRAIN_SIZE - 1) / GRAIN_SIZE);
+  ParallelFor(n_chunks, n_threads, [&](int c) {
+    int64_t begin = static_cast<int64_t>(c) * GRAIN_SIZE;
+    fn(begin, std::min<int64_t>(begin + GRAIN_SIZE, len));
+  });
+}
+
+void CheckRecordBytes(const std::size_t record_bytes) {
+  YACL_ENFORCE(record_bytes > heu::lib::phe::kCipherRecordLengthBytes,
+               "record_bytes {} is too small", record_bytes);
+}
+
+heu::lib::phe::Ciphertext ReadRecord(const uint8_t *record,
+                                     const std::size_t record_bytes) {
+  heu::lib::phe::Ciphertext ct;
+  heu::lib::phe::DecodeCipherRecord(record, record_bytes, &ct);
+  return ct;
+}
+
+std::vector<heu::lib::phe::Ciphertext> ReadRecords(
+    const uint8_t *records, const int64_t begin, const int64_t end,
+    const std::size_t record_bytes) {
+  std::vector<heu::lib::phe::Ciphertext> res;
+  res.reserve(end - begin);
+  for (int64_t i = begin; i < end; ++i) {
+    res.push_back(ReadRecord(records + i * record_bytes, record_bytes));
+  }
+  return res;
+}
+
+void WriteRecords(absl::Span<const heu::lib::phe::Ciphertext> cts,
+                  uint8_t *records, const int64_t begin,
+                  const std::size_t record_bytes) {
+  for (size_t i = 0; i < cts.size(); ++i) {
+    heu::lib::phe::EncodeCipherRecord(
+        cts[i], records + (begin + i) * record_bytes, record_bytes);
+  }
+}
+
+template <typename Kit>
+std::size_t CipherRecordBytes(const Kit *kit) {
+  return heu::lib::phe::SuggestCipherRecordBytes(
+      kit->GetEncryptor()->EncryptZero().Serialize().size());
+}
+
+template <typename Kit, typename T>
+void EncryptRecords(const Kit *kit, const T *data, const int64_t len,
+                    uint8_t *records, const std::size_t record_bytes,
+                    const int64_t scale, const int32_t n_threads) {
+  CheckRecordBytes(record_bytes);
+  auto encrypter = kit->GetEncryptor();
+  auto encoder = kit->template GetEncoder<heu::lib::phe::PlainEncoder>(
+      HE_SCALE(kit));
+  ParallelForChunks(len, n_threads, [&](int64_t begin, int64_t end) {
+    std::vector<heu::lib::phe::Plaintext> pts;
+    pts.reserve(end - begin);
+    for (int64_t i = begin; i < end; ++i) {
+      pts.push_back(encoder.Encode(data[i]));
+    }
+    WriteRecords(encrypter->Encrypt(pts), records, begin, record_bytes);
+  });
+}
+
+template <typename T>
+void DecryptRecords(const heu::lib::phe::HeKit *hekit, const uint8_t *records,
+                    const int64_t len, const std::size_t record_bytes,
+                    T *data, const int64_t scale, const int32_t n_threads) {
+  CheckRecordBytes(record_bytes);
+  auto decrypter = hekit->GetDecryptor();
+  auto encoder =
+      hekit->GetEncoder<heu::lib::phe::PlainEncoder>(HE_SCALE(hekit));
+  ParallelForChunks(len, n_threads, [&](int64_t begin, int64_t end) {
+    auto pts =
+        decrypter->Decrypt(ReadRecords(records, begin, end, record_bytes));
+    for (int64_t i = begin; i < end; ++i) {
+      data[i] = encoder.Decode<T>(pts[i - begin]);
+    }
+  });
+}
+
+// Reduce the records to one ciphertext, map_chunk(begin, end) returns the
+// partial sum of a chunk
+template <typename MapChunk>
+void ReduceRecords(const heu::lib::phe::DestinationHeKit *dhekit,
+                   const int64_t len, uint8_t *out,
+                   const std::size_t record_bytes, const int32_t n_threads,
+                   MapChunk &&map_chunk) {
+  CheckRecordBytes(record_bytes);
+  auto evaluator = dhekit->GetEvaluator();
+  auto n_chunks = (len + GRAIN_SIZE - 1) / GRAIN_SIZE;
+  std::vector<heu::lib::phe::Ciphertext> partials(n_chunks);
+  ParallelForChunks(len, n_threads, [&](int64_t begin, int64_t end) {
+    partials[begin / GRAIN_SIZE] = map_chunk(begin, end);
+  });
+
+  auto res = dhekit->GetEncryptor()->EncryptZero();
+  for (const auto &partial : partials) {
+    evaluator->AddInplace(&res, partial);
+  }
+  heu::lib::phe::EncodeCipherRecord(res, out, record_bytes);
+}
+
+}  // namespace
+
+HEU_DLL int HeKitCipherRecordBytes(HeKitHandle handle, std::size_t *out) {
+  API_HEKIT_HANDLE({ *out = CipherRecordBytes(hekit); })
+}
+
+HEU_DLL int DestinationHeKitCipherRecordBytes(DestinationHeKitHandle handle,
+                                              std::size_t *out) {
+  API_DHEKIT_HANDLE({ *out = CipherRecordBytes(dhekit); })
+}
+
+HEU_DLL int EncryptInt64Records(HeKitHandle handle, const int64_t *data,
+                                const int64_t len, uint8_t *records,
+                                const std::size_t record_bytes,
+                                const int64_t scale, const int32_t n_threads) {
+  API_HEKIT_HANDLE({
+    EncryptRecords(hekit, data, len, records, record_bytes, scale, n_threads);
+  })
+}
+
+HEU_DLL int EncryptDoubleRecords(HeKitHandle handle, const double *data,
+                                 const int64_t len, uint8_t *records,
+                                 const std::size_t record_bytes,
+                                 const int64_t scale, const int32_t n_threads) {
+  API_HEKIT_HANDLE({
+    EncryptRecords(hekit, data, len, records, record_bytes, scale, n_threads);
+  })
+}
+
+HEU_DLL int DestinationHeKitEncryptInt64Records(
+    DestinationHeKitHandle handle, const int64_t *data, const int64_t len,
+    uint8_t *records, const std::size_t record_bytes, const int64_t scale,
+    const int32_t n_threads) {
+  API_DHEKIT_HANDLE({
+    EncryptRecords(dhekit, data, len, records, record_bytes, scale, n_threads);
+  })
+}
+
+HEU_DLL int DestinationHeKitEncryptDoubleRecords(
+    DestinationHeKitHandle handle, const double *data, const int64_t len,
+    uint8_t *records, const std::size_t record_bytes, const int64_t scale,
+    const int32_t n_threads) {
+  API_DHEKIT_HANDLE({
+    EncryptRecords(dhekit, data, len, records, record_bytes, scale, n_threads);
+  })
+}
+
+HEU_DLL int DecryptInt64Records(HeKitHandle handle, const uint8_t *records,
+                                const int64_t len,
+                                const std::size_t record_bytes, int64_t *data,
+                                const int64_t scale, const int32_t n_threads) {
+  API_HEKIT_HANDLE({
+    DecryptRecords(hekit, records, len, record_bytes, data, scale, n_threads);
+  })
+}
+
+HEU_DLL int DecryptDoubleRecords(HeKitHandle handle, const uint8_t *records,
+                                 const int64_t len,
+                                 const std::size_t record_bytes, double *data,
+                                 const int64_t scale, const int32_t n_threads) {
+  API_HEKIT_HANDLE({
+    DecryptRecords(hekit, records, len, record_bytes, data, scale, n_threads);
+  })
+}
+
+HEU_DLL int AddCipherRecords(DestinationHeKitHandle handle,
+                             const uint8_t *records1, const uint8_t *records2,
+                             const int64_t len, const std::size_t record_bytes,
+                             uint8_t *out, const int32_t n_threads) {
+  API_DHEKIT_HANDLE({
+    CheckRecordBytes(record_bytes);
+    auto evaluator = dhekit->GetEvaluator();
+    ParallelForChunks(len, n_threads, [&](int64_t begin, int64_t end) {
+      auto res = evaluator->Add(
+          ReadRecords(records1, begin, end, record_bytes),
+          ReadRecords(records2, begin, end, record_bytes));
+      WriteRecords(res, out, begin, record_bytes);
+    });
+  })
+}
+
+HEU_DLL int SumCipherRecords(DestinationHeKitHandle handle,
+                             const uint8_t *records, const int64_t len,
+                             const std::size_t record_bytes, uint8_t *out,
+                             const int32_t n_threads) {
+  API_DHEKIT_HANDLE({
+    auto evaluator = dhekit->GetEvaluator();
+    ReduceRecords(dhekit, len, out, record_bytes, n_threads,
+                  [&](int64_t begin, int64_t end) {
+                    auto res = ReadRecord(records + begin * record_bytes,
+                                          record_bytes);
+                    for (int64_t i = begin + 1; i < end; ++i) {
+                      evaluator->AddInplace(
+                          &res, ReadRecord(records + i * record_bytes,
+                                           record_bytes));
+                    }
+                    return res;
+                  });
+  })
+}
+
+HEU_DLL int DotCipherRecords(DestinationHeKitHandle handle,
+                             const uint8_t *records, const int64_t *weights,
+                             const int64_t len, const std::size_t record_bytes,
+                             uint8_t *out, const int32_t n_threads) {
+  API_DHEKIT_HANDLE({
+    auto evaluator = dhekit->GetEvaluator();
+    auto schema = dhekit->GetSchemaType();
+    ReduceRecords(
+        dhekit, len, out, record_bytes, n_threads,
+        [&](int64_t begin, int64_t end) {
+          std::vector<heu::lib::phe::Plaintext> pts;
+          pts.reserve(end - begin);
+          for (int64_t i = begin; i < end; ++i) {
+            pts.emplace_back(schema, weights[i]);
+          }
+          auto products = evaluator->Mul(
+              ReadRecords(records, begin, end, record_bytes), pts);
+          for (size_t i = 1; i < products.size(); ++i) {
+            evaluator->AddInplace(&products[0], products[i]);
+          }
+          return products[0];
+        });
+  })
+}
@@ -1183,3 +1183,187 @@ HEU_DLL
                    heu::lib::phe::Ciphertext *ciphers, const int len,
                    heu::lib::phe::Ciphertext *out, int32_t min_work_size = 1000,
                    const int32_t n_threads = omp_get_num_procs());
+
+/*
+ * Columnar API
+ *
+ * The functions below exchange ciphertexts as contiguous buffers of
+ * fixed-width records instead of arrays of heu::lib::phe::Ciphertext, so that
+ * callers from other languages do not construct one C++ object per element.
+ * Record i starts at byte i * record_bytes, it holds a little-endian uint32
+ * length followed by the serialized ciphertext, padded with zeros to
+ * record_bytes. The encoder and the schema dispatch are set up once per
+ * chunk of GRAIN_SIZE elements rather than once per element.
+ */
+
+/*!
+ * \brief get the record width fitting the ciphertexts of hekit
+ * \param handle HeKitHandle
+ * \param out the result of record width in bytes
+ * \return 0 when success, -1 when failure happens
+ */
+HEU_DLL int HeKitCipherRecordBytes(HeKitHandle handle, std::size_t *out);
+
+/*!
+ * \brief get the record width fitting the ciphertexts of DestinationHeKit
+ * \param handle DestinationHeKitHandle
+ * \param out the result of record width in bytes
+ * \return 0 when success, -1 when failure happens
+ */
+HEU_DLL int DestinationHeKitCipherRecordBytes(DestinationHeKitHandle handle,
+                                              std::size_t *out);
+
+/*!
+ * \brief encrypt data into cipher records using hekit
+ * \param handle HeKitHandle
+ * \param data the data to encrypt
+ * \param len the length of data
+ * \param records the result buffer of len * record_bytes bytes
+ * \param record_bytes the record width, see HeKitCipherRecordBytes
+ * \param scale scale of the data
+ * \param n_threads the number of thread
+ * \return 0 when success, -1 when failure happens
+ */
+HEU_DLL int EncryptInt64Records(HeKitHandle handle, const int64_t *data,
+                                const int64_t len, uint8_t *records,
+                                const std::size_t record_bytes,
+                                const int64_t scale = SCALE,
+                                const int32_t n_threads = omp_get_num_procs());
+
+/*!
+ * \brief encrypt data into cipher records using hekit
+ * \param handle HeKitHandle
+ * \param data the data to encrypt
+ * \param len the length of data
+ * \param records the result buffer of len * record_bytes bytes
+ * \param record_bytes the record width, see HeKitCipherRecordBytes
+ * \param scale scale of the data
+ * \param n_threads the number of thread
+ * \return 0 when success, -1 when failure happens
+ */
+HEU_DLL int EncryptDoubleRecords(HeKitHandle handle, const double *data,
+                                 const int64_t len, uint8_t *records,
+                                 const std::size_t record_bytes,
+                                 const int64_t scale = SCALE,
+                                 const int32_t n_threads = omp_get_num_procs());
+
+/*!
+ * \brief encrypt data into cipher records using DestinationHeKit
+ * \param handle DestinationHeKitHandle
+ * \param data the data to encrypt
+ * \param len the length of data
+ * \param records the result buffer of len * record_bytes bytes
+ * \param record_bytes the record width, see
+ * DestinationHeKitCipherRecordBytes
+ * \param scale scale of the data
+ * \param n_threads the number of thread
+ * \return 0 when success, -1 when failure happens
+ */
+HEU_DLL int DestinationHeKitEncryptInt64Records(
+    DestinationHeKitHandle handle, const int64_t *data, const int64_t len,
+    uint8_t *records, const std::size_t record_bytes,
+    const int64_t scale = SCALE,
+    const int32_t n_threads = omp_get_num_procs());
+
+/*!
+ * \brief encrypt data into cipher records using DestinationHeKit
+ * \param handle DestinationHeKitHandle
+ * \param data the data to encrypt
+ * \param len the length of data
+ * \param records the result buffer of len * record_bytes bytes
+ * \param record_bytes the record width, see
+ * DestinationHeKitCipherRecordBytes
+ * \param scale scale of the data
+ * \param n_threads the number of thread
+ * \return 0 when success, -1 when failure happens
+ */
+HEU_DLL int DestinationHeKitEncryptDoubleRecords(
+    DestinationHeKitHandle handle, const double *data, const int64_t len,
+    uint8_t *records, const std::size_t record_bytes,
+    const int64_t scale = SCALE,
+    const int32_t n_threads = omp_get_num_procs());
+
+/*!
+ * \brief decrypt cipher records using hekit
+ * \param handle HeKitHandle
+ * \param records the cipher records to decrypt
+ * \param len the number of records
+ * \param record_bytes the record width
+ * \param data the result of len elements
+ * \param scale scale of the data
+ * \param n_threads the number of thread
+ * \return 0 when success, -1 when failure happens
+ */
+HEU_DLL int DecryptInt64Records(HeKitHandle handle, const uint8_t *records,
+                                const int64_t len,
+                                const std::size_t record_bytes, int64_t *data,
+                                const int64_t scale = SCALE,
+                                const int32_t n_threads = omp_get_num_procs());
+
+/*!
+ * \brief decrypt cipher records using hekit
+ * \param handle HeKitHandle
+ * \param records the cipher records to decrypt
+ * \param len the number of records
+ * \param record_bytes the record width
+ * \param data the result of len elements
+ * \param scale scale of the data
+ * \param n_threads the number of thread
+ * \return 0 when success, -1 when failure happens
+ */
+HEU_DLL int DecryptDoubleRecords(HeKitHandle handle, const uint8_t *records,
+                                 const int64_t len,
+                                 const std::size_t record_bytes, double *data,
+                                 const int64_t scale = SCALE,
+                                 const int32_t n_threads = omp_get_num_procs());
+
+/*!
+ * \brief add the cipher records element-wise using DestinationHeKit
+ * \param handle DestinationHeKitHandle
+ * \param records1 the first cipher records to be added
+ * \param records2 the second cipher records to be added
+ * \param len the number of records
+ * \param record_bytes the record width
+ * \param out the result records, may be records1 or records2
+ * \param n_threads the number of thread
+ * \return 0 when success, -1 when failure happens
+ */
+HEU_DLL int AddCipherRecords(DestinationHeKitHandle handle,
+                             const uint8_t *records1, const uint8_t *records2,
+                             const int64_t len, const std::size_t record_bytes,
+                             uint8_t *out,
+                             const int32_t n_threads = omp_get_num_procs());
+
+/*!
+ * \brief sum the cipher records using DestinationHeKit
+ * \param handle DestinationHeKitHandle
+ * \param records the cipher records to sum
+ * \param len the number of records
+ * \param record_bytes the record width
+ * \param out the result of one record
+ * \param n_threads the number of thread
+ * \return 0 when success, -1 when failure happens
+ */
+HEU_DLL int SumCipherRecords(DestinationHeKitHandle handle,
+                             const uint8_t *records, const int64_t len,
+                             const std::size_t record_bytes, uint8_t *out,
+                             const int32_t n_threads = omp_get_num_procs());
+
+/*!
+ * \brief dot product of the cipher records and plain weights using
+ * DestinationHeKit, the weights are not scaled so the result has the scale
+ * of the records
+ * \param handle DestinationHeKitHandle
+ * \param records the cipher records
+ * \param weights the plain weights
+ * \param len the number of records and weights
+ * \param record_bytes the record width
+ * \param out the result of one record
+ * \param n_threads the number of thread
+ * \return 0 when success, -1 when failure happens
+ */
+HEU_DLL int DotCipherRecords(DestinationHeKitHandle handle,
+                             const uint8_t *records, const int64_t *weights,
+                             const int64_t len, const std::size_t record_bytes,
+                             uint8_t *out,
+                             const int32_t n_threads = omp_get_num_procs());
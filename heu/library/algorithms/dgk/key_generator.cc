@@ -14,6 +14,8 @@
 
 #include "heu/library/algorithms/dgk/key_generator.h"
 
+#include "heu/library/algorithms/util/prime_generator.h"
+
 namespace heu::lib::algorithms::dgk {
 
 void KeyGenerator::Generate(size_t key_size, SecretKey *sk, PublicKey *pk) {
@@ -24,23 +26,28 @@ void KeyGenerator::Generate(size_t key_size, SecretKey *sk, PublicKey *pk) {
   // MPINT_ENFORCE_OK(
   //     mp_prime_rand(reinterpret_cast<mp_int*>(&u), 1, l, MP_PRIME_BBS));
   BigInt u(65423);  // use the largest l(16)-bit prime instead
-  BigInt vp = BigInt::RandPrimeOver(t);
-  BigInt vq = BigInt::RandPrimeOver(t);
+  BigInt vp = ParallelRandPrimeOver(t);
+  BigInt vq = ParallelRandPrimeOver(t);
   // Question: can we consider the following generations of p, q secure?
   // TODO: check NIST.FIPS.186-5 Appendix A.1.1
-  BigInt wp, wq, p, q, gcd;
-  do {
-    wp = BigInt::RandomMonicExactBits(key_size / 2 - t - l);
-    gcd = wp.Gcd(vq);
-    wp *= 2;
-    p = u * vp * wp + 1;
-  } while (!p.IsPrime() || gcd != 1);
-  do {
-    wq = BigInt::RandomMonicExactBits(key_size / 2 - t);
-    gcd = wq.Gcd(vp);
-    wq *= 2;
-    q = vq * wq + 1;
-  } while (!q.IsPrime() || gcd != 1);
+  BigInt p = ParallelSearch([&](BigInt *out) {
+    BigInt w = BigInt::RandomMonicExactBits(key_size / 2 - t - l);
+    if (w.Gcd(vq) != 1) {
+      return false;
+    }
+    *out = u * vp * w * 2 + 1;
+    return out->IsPrime();
+  });
+  BigInt q = ParallelSearch([&](BigInt *out) {
+    BigInt w = BigInt::RandomMonicExactBits(key_size / 2 - t);
+    if (w.Gcd(vp) != 1) {
+      return false;
+    }
+    *out = vq * w * 2 + 1;
+    return out->IsPrime();
+  });
+  BigInt wp = (p - 1) / (u * vp);
+  BigInt wq = (q - 1) / vq;
   BigInt n{p * q}, pp_{p * p.InvMod(q)};
   BigInt gp, gq, gn;  // generators of cyclic groups
   do {
@@ -25,4 +25,43 @@ Plaintext Decryptor::Decrypt(const Ciphertext &ct) const {
   return m > pk_.PlaintextBound() ? m - pk_.PlainModule() : m;
 }
 
+template <typename SPAN>
+void Decryptor::DecryptInto(SPAN cts, DenseSpan<Plaintext> out) const {
+  YACL_ENFORCE(cts.size() == out.size(),
+               "size mismatch, cts.size()={}, out.size()={}", cts.size(),
+               out.size());
+  for (size_t i = 0; i < cts.size(); ++i) {
+    const Ciphertext &ct = Deref(cts[i]);
+    HE_ASSERT(!ct.c_.IsNegative() && ct.c_ < pk_.CipherModule(),
+              "Decryptor: Invalid ciphertext");
+    out[i] = pk_.MapBackToZSpace(ct.c_);
+  }
+  DecryptZSpace(out);
+}
+
+std::vector<Plaintext> Decryptor::Decrypt(ConstSpan<Ciphertext> cts) const {
+  std::vector<Plaintext> res(cts.size());
+  DecryptInto(cts, absl::MakeSpan(res));
+  return res;
+}
+
+void Decryptor::Decrypt(ConstSpan<Ciphertext> cts,
+                        DenseSpan<Plaintext> out) const {
+  DecryptInto(cts, out);
+}
+
+void Decryptor::Decrypt(ConstDenseSpan<Ciphertext> cts,
+                        DenseSpan<Plaintext> out) const {
+  DecryptInto(cts, out);
+}
+
+void Decryptor::DecryptZSpace(absl::Span<BigInt> cs) const {
+  sk_.DecryptInplace(cs);
+  for (auto &m : cs) {
+    if (m > pk_.PlaintextBound()) {
+      m -= pk_.PlainModule();
+    }
+  }
+}
+
 }  // namespace heu::lib::algorithms::dj
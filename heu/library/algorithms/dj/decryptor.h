@@ -15,10 +15,12 @@
 #pragma once
 
 #include <utility>
+#include <vector>
 
 #include "heu/library/algorithms/dj/ciphertext.h"
 #include "heu/library/algorithms/dj/public_key.h"
 #include "heu/library/algorithms/dj/secret_key.h"
+#include "heu/library/algorithms/util/spi_traits.h"
 
 namespace heu::lib::algorithms::dj {
 
@@ -32,8 +34,17 @@ class Decryptor {
   }
 
   Plaintext Decrypt(const Ciphertext &ct) const;
+  std::vector<Plaintext> Decrypt(ConstSpan<Ciphertext> cts) const;
+  // Same as above, but results are written into 'out'
+  void Decrypt(ConstSpan<Ciphertext> cts, DenseSpan<Plaintext> out) const;
+  void Decrypt(ConstDenseSpan<Ciphertext> cts, DenseSpan<Plaintext> out) const;
 
  private:
+  template <typename SPAN>
+  void DecryptInto(SPAN cts, DenseSpan<Plaintext> out) const;
+  // Decrypts ciphertexts already mapped into Z-space, in place
+  void DecryptZSpace(absl::Span<BigInt> cs) const;
+
   PublicKey pk_;
   SecretKey sk_;
 };
@@ -15,6 +15,7 @@
 #include "heu/library/algorithms/dj/dj.h"
 
 #include <string>
+#include <vector>
 
 #include "gtest/gtest.h"
 
@@ -118,6 +119,44 @@ TEST_F(DJTest, MinMaxDecrypt) {
                std::exception);  // too many bits
 }
 
+TEST_F(DJTest, VectorizedEncrypt) {
+  std::vector<Plaintext> pts = {Plaintext(0), Plaintext(-12345),
+                                pk_.PlaintextBound(), -pk_.PlaintextBound()};
+  for (int i = 0; i < 100; ++i) {
+    pts.emplace_back(i * 1000 - 50000);
+  }
+  std::vector<const Plaintext *> pts_ptr;
+  for (const auto &pt : pts) {
+    pts_ptr.push_back(&pt);
+  }
+
+  auto cts = encryptor_->Encrypt(absl::MakeConstSpan(pts_ptr));
+  ASSERT_EQ(cts.size(), pts.size());
+  Plaintext plain;
+  for (size_t i = 0; i < pts.size(); ++i) {
+    decryptor_->Decrypt(cts[i], &plain);
+    EXPECT_EQ(plain, pts[i]);
+  }
+  // ciphertexts of the same plaintext are blinded with different randomness
+  EXPECT_NE(cts[0].c_, encryptor_->Encrypt(pts[0]).c_);
+
+  // the contiguous overloads write into caller-provided buffers
+  std::vector<Ciphertext> dense_cts(pts.size());
+  encryptor_->Encrypt(absl::MakeConstSpan(pts), absl::MakeSpan(dense_cts));
+  std::vector<Plaintext> dense_res(pts.size());
+  decryptor_->Decrypt(absl::MakeConstSpan(dense_cts),
+                      absl::MakeSpan(dense_res));
+  EXPECT_EQ(dense_res, pts);
+  EXPECT_THROW(encryptor_->Encrypt(absl::MakeConstSpan(pts),
+                                   absl::MakeSpan(dense_cts).subspan(1)),
+               std::exception);
+
+  Plaintext too_large = pk_.PlaintextBound() + 1;
+  pts_ptr.push_back(&too_large);
+  EXPECT_THROW(encryptor_->Encrypt(absl::MakeConstSpan(pts_ptr)),
+               std::exception);
+}
+
 TEST_F(DJTest, PlaintextEvaluate1) {
   // base (m0) 为正数
   Plaintext m0(123);
@@ -22,15 +22,50 @@ Ciphertext Encryptor::EncryptZero() const {
   return Ciphertext{pk_.RandomHsR()};
 }
 
-Ciphertext Encryptor::Encrypt(const Plaintext &m) const {
+void Encryptor::CheckRange(const Plaintext &m) const {
   YACL_ENFORCE(m.CompareAbs(pk_.PlaintextBound()) <= 0,
                "message number out of range, message={}, max (abs)={}", m,
                pk_.PlaintextBound());
+}
+
+Ciphertext Encryptor::Encrypt(const Plaintext &m) const {
+  CheckRange(m);
   Ciphertext ctR;
   pk_.MulMod(pk_.Encrypt(m), pk_.RandomHsR(), &ctR.c_);
   return ctR;
 }
 
+template <typename SPAN>
+void Encryptor::EncryptInto(SPAN pts, DenseSpan<Ciphertext> out) const {
+  YACL_ENFORCE(pts.size() == out.size(),
+               "size mismatch, pts.size()={}, out.size()={}", pts.size(),
+               out.size());
+  for (const auto &m : pts) {
+    CheckRange(Deref(m));
+  }
+
+  auto hs_r = pk_.RandomHsR(pts.size());
+  for (size_t i = 0; i < pts.size(); ++i) {
+    pk_.MulMod(pk_.Encrypt(Deref(pts[i])), hs_r[i], &out[i].c_);
+  }
+}
+
+std::vector<Ciphertext> Encryptor::Encrypt(ConstSpan<Plaintext> pts) const {
+  std::vector<Ciphertext> res(pts.size());
+  EncryptInto(pts, absl::MakeSpan(res));
+  return res;
+}
+
+void Encryptor::Encrypt(ConstSpan<Plaintext> pts,
+                        DenseSpan<Ciphertext> out) const {
+  EncryptInto(pts, out);
+}
+
+void Encryptor::Encrypt(ConstDenseSpan<Plaintext> pts,
+                        DenseSpan<Ciphertext> out) const {
+  EncryptInto(pts, out);
+}
+
 std::pair<Ciphertext, std::string> Encryptor::EncryptWithAudit(
     const Plaintext &m) const {
   BigInt g_m{pk_.Encrypt(m)}, r_n_s{pk_.RandomHsR()}, ctR;
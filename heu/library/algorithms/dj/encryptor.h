@@ -20,6 +20,7 @@
 #include "heu/library/algorithms/dj/ciphertext.h"
 #include "heu/library/algorithms/dj/public_key.h"
 #include "heu/library/algorithms/dj/secret_key.h"
+#include "heu/library/algorithms/util/spi_traits.h"
 
 namespace heu::lib::algorithms::dj {
 
@@ -29,10 +30,19 @@ class Encryptor {
 
   Ciphertext EncryptZero() const;
   Ciphertext Encrypt(const Plaintext &m) const;
+  // Batched version, blinding factors are fetched from the pool at once
+  std::vector<Ciphertext> Encrypt(ConstSpan<Plaintext> pts) const;
+  // Same as above, but results are written into 'out'
+  void Encrypt(ConstSpan<Plaintext> pts, DenseSpan<Ciphertext> out) const;
+  void Encrypt(ConstDenseSpan<Plaintext> pts, DenseSpan<Ciphertext> out) const;
 
   std::pair<Ciphertext, std::string> EncryptWithAudit(const Plaintext &m) const;
 
  private:
+  void CheckRange(const Plaintext &m) const;
+  template <typename SPAN>
+  void EncryptInto(SPAN pts, DenseSpan<Ciphertext> out) const;
+
   const PublicKey pk_;
 };
 
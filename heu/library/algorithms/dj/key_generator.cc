@@ -16,17 +16,17 @@
 
 #include "yacl/base/exception.h"
 
+#include "heu/library/algorithms/util/prime_generator.h"
+
 namespace heu::lib::algorithms::dj {
 
 void KeyGenerator::Generate(size_t key_size, SecretKey *sk, PublicKey *pk) {
   YACL_ENFORCE(key_size % 2 == 0, "Key size must be even");
 
-  BigInt q, gcd;
-  BigInt p = BigInt::RandPrimeOver(key_size / 2, PrimeType::BBS);
-  do {
-    q = BigInt::RandPrimeOver(key_size / 2, PrimeType::BBS);
-    gcd = (p - 1).Gcd(q - 1);
-  } while (gcd != 2);
+  auto [p, q] = ParallelRandPrimePair(
+      key_size / 2, PrimeType::BBS, [](const BigInt &a, const BigInt &b) {
+        return (a - 1).Gcd(b - 1) == 2;
+      });
   sk->Init(p, q, s_);
   pk->Init(p * q, s_, BigInt{0});
 }
@@ -18,6 +18,7 @@ namespace heu::lib::algorithms::dj {
 
 namespace {
 constexpr size_t kExpUnitBits = 10;
+constexpr size_t kHsRPoolSize = 1024;
 }  // namespace
 
 void PublicKey::Init(const BigInt &n, uint32_t s, const BigInt &hs) {
@@ -46,12 +47,20 @@ void PublicKey::Init(const BigInt &n, uint32_t s, const BigInt &hs) {
   lut_->n_pow.resize(s + 1);
   lut_->n_pow[0] = BigInt(1);
   lut_->precomp.resize(s + 1);
-  lut_->precomp[0] = lut_->m_space->Identity();
+  lut_->precomp[0] = BigInt(1);
   for (auto i = 1u; i <= s; ++i) {
     lut_->n_pow[i] = lut_->n_pow[i - 1] * n;
     lut_->precomp[i] = lut_->precomp[i - 1].MulMod(n, cmod_).MulMod(
         BigInt{i}.InvMod(cmod_), cmod_);
   }
+
+  // capture the LUT instead of 'this', the LUT is shared by copied keys
+  lut_->hs_r_pool = std::make_unique<RandomPool>(
+      [lut = lut_.get(), bits = n_.BitCount() / 2] {
+        BigInt r = BigInt::RandomExactBits(bits);
+        return lut->m_space->PowMod(*lut->hs_pow, r);
+      },
+      kHsRPoolSize);
 }
 
 bool PublicKey::operator==(const PublicKey &pk) const {
@@ -67,20 +76,24 @@ std::string PublicKey::ToString() const {
       PlaintextBound().BitCount());
 }
 
-BigInt PublicKey::RandomHsR() const {
-  BigInt r = BigInt::RandomExactBits(n_.BitCount() / 2);
-  BigInt hs_r = lut_->m_space->PowMod(*lut_->hs_pow, r);
-  return hs_r;
+BigInt PublicKey::RandomHsR() const { return lut_->hs_r_pool->Get(); }
+
+std::vector<BigInt> PublicKey::RandomHsR(size_t size) const {
+  return lut_->hs_r_pool->Get(size);
 }
 
 BigInt PublicKey::Encrypt(const BigInt &m) const {
-  BigInt ctR{lut_->m_space->Identity()}, tmp{1}, prodR;
+  // (1+n)^m = sum_{i=0}^{s} C(m,i) * n^i mod n^(s+1), where the i-th term only
+  // needs C(m,i) mod n^(s-i+1). Terms are accumulated in Z-space, so only the
+  // final sum is mapped into Montgomery form.
+  BigInt ct{1}, tmp{1};
   for (auto i = 1u; i <= s_; ++i) {
     tmp = tmp.MulMod(m - (i - 1), lut_->n_pow[s_ - i + 1]);
-    prodR = lut_->m_space->MulMod(MapIntoMSpace(tmp), lut_->precomp[i]);
-    ctR += prodR;
+    ct += tmp * lut_->precomp[i];
   }
-  return ctR % cmod_;
+  ct %= cmod_;
+  lut_->m_space->MapIntoMSpace(ct);
+  return ct;
 }
 
 BigInt PublicKey::MapIntoMSpace(const BigInt &x) const {
@@ -16,6 +16,7 @@
 
 #include "heu/library/algorithms/util/big_int.h"
 #include "heu/library/algorithms/util/he_object.h"
+#include "heu/library/algorithms/util/random_pool.h"
 
 namespace heu::lib::algorithms::dj {
 
@@ -41,8 +42,10 @@ class PublicKey : public HeObject<PublicKey> {
   std::string ToString() const override;
 
  public:
-  // Random Zn* element of form r^(n^s) mod n^(s+1)
+  // Random Zn* element of form r^(n^s) mod n^(s+1), in Montgomery form.
+  // Values are taken from a pool filled in background
   BigInt RandomHsR() const;
+  std::vector<BigInt> RandomHsR(size_t size) const;
   // Deterministic encryption
   BigInt Encrypt(const BigInt &) const;
   BigInt MapIntoMSpace(const BigInt &) const;
@@ -61,6 +64,8 @@ class PublicKey : public HeObject<PublicKey> {
     std::unique_ptr<BaseTable> hs_pow;         // powers of h^(n^s) mod n^(s+1)
     std::vector<BigInt> n_pow;                 // powers of n
     std::vector<BigInt> precomp;               // n^i/i! mod n^(s+1)
+    // Must be the last member, the filler thread uses the tables above
+    std::unique_ptr<RandomPool> hs_r_pool;  // cached RandomHsR() values
   };
 
   std::shared_ptr<LUT> lut_;
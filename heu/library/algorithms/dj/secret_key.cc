@@ -48,6 +48,9 @@ void SecretKey::Init(const BigInt &p, const BigInt &q, uint32_t s) {
                                  BigInt{i}.InvMod(qs), qs)};
     }
   }
+  const auto &[ps1, qs1] = lut_->pq_pow[s + 1];
+  lut_->pow_p = std::make_unique<FixedExpPowMod>(lambda_, ps1);
+  lut_->pow_q = std::make_unique<FixedExpPowMod>(lambda_, qs1);
 }
 
 bool SecretKey::operator==(const SecretKey &sk) const {
@@ -63,10 +66,22 @@ std::string SecretKey::ToString() const {
 }
 
 BigInt SecretKey::Decrypt(const BigInt &ct) const {
-  MPInt2 z, ls;
   // compute z = c^d mod n^(s+1)
   const auto &[ps1, qs1] = lut_->pq_pow[s_ + 1];
-  z = {(ct % ps1).PowMod(lambda_, ps1), (ct % qs1).PowMod(lambda_, qs1)};
+  return DecryptPowers(
+      {(ct % ps1).PowMod(lambda_, ps1), (ct % qs1).PowMod(lambda_, qs1)});
+}
+
+void SecretKey::DecryptInplace(absl::Span<BigInt> cts) const {
+  auto zp = lut_->pow_p->PowMod(cts);
+  lut_->pow_q->PowMod(cts, cts);
+  for (size_t i = 0; i < cts.size(); ++i) {
+    cts[i] = DecryptPowers({std::move(zp[i]), std::move(cts[i])});
+  }
+}
+
+BigInt SecretKey::DecryptPowers(const MPInt2 &z) const {
+  MPInt2 ls;
   //  compute ls = L(z) mod n^s
   const auto &[ps, qs] = lut_->pq_pow[s_];
   ls = {inv_pq_.P.MulMod((z.P - 1) / n_.P, ps),
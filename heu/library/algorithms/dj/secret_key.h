@@ -15,6 +15,7 @@
 #pragma once
 
 #include "heu/library/algorithms/util/big_int.h"
+#include "heu/library/algorithms/util/fixed_exp_pow_mod.h"
 #include "heu/library/algorithms/util/he_object.h"
 
 namespace heu::lib::algorithms::dj {
@@ -36,8 +37,14 @@ class SecretKey : public HeObject<SecretKey> {
   std::string ToString() const override;
 
   BigInt Decrypt(const BigInt &ct) const;
+  // Batched version, decrypts 'cts' in place.
+  // c^λ is computed with the precomputed exponent schedule
+  void DecryptInplace(absl::Span<BigInt> cts) const;
 
  private:
+  // z = c^λ mod {p,q}^(s+1)
+  BigInt DecryptPowers(const MPInt2 &z) const;
+
   MPInt2 n_;            // (p, q)
   BigInt lambda_, mu_;  // λ, μ
   BigInt pmod_;         // n^s
@@ -48,6 +55,8 @@ class SecretKey : public HeObject<SecretKey> {
   struct LUT {
     std::vector<MPInt2> pq_pow;                // {p,q}^j
     std::vector<std::vector<MPInt2>> precomp;  // n^(i-1)/i! mod {p,q}^j
+    // c^λ mod {p,q}^(s+1)
+    std::unique_ptr<FixedExpPowMod> pow_p, pow_q;
   };
 
   std::shared_ptr<LUT> lut_;
@@ -27,6 +27,7 @@ Decryptor::Decryptor(PublicKey pk, SecretKey sk)
   YACL_ENFORCE(sk_.p2_ * sk_.q_ == pk_.n_,
                "pk and sk are not paired, {}^2 * {} != {}", sk_.p_, sk_.q_,
                pk_.n_);
+  pow_t_ = std::make_shared<FixedExpPowMod>(sk_.t_, sk_.p2_);
 }
 
 void Decryptor::Decrypt(const Ciphertext &ct, BigInt *out) const {
@@ -34,7 +35,10 @@ void Decryptor::Decrypt(const Ciphertext &ct, BigInt *out) const {
 
   BigInt c(ct.c_);
   pk_.m_space_->MapBackToZSpace(c);
-  c = (c % sk_.p2_).PowMod(sk_.t_, sk_.p2_);
+  Decode((c % sk_.p2_).PowMod(sk_.t_, sk_.p2_), out);
+}
+
+void Decryptor::Decode(BigInt c, BigInt *out) const {
   --c;
   *out = (c / sk_.p_).MulMod(sk_.gp_inv_, sk_.p_);
 
@@ -50,4 +54,41 @@ BigInt Decryptor::Decrypt(const Ciphertext &ct) const {
   return mp;
 }
 
+template <typename SPAN>
+void Decryptor::DecryptInto(SPAN cts, DenseSpan<BigInt> out) const {
+  YACL_ENFORCE(cts.size() == out.size(),
+               "size mismatch, cts.size()={}, out.size()={}", cts.size(),
+               out.size());
+  for (size_t i = 0; i < cts.size(); ++i) {
+    const Ciphertext &ct = Deref(cts[i]);
+    VALIDATE(ct);
+    out[i] = ct.c_;
+    pk_.m_space_->MapBackToZSpace(out[i]);
+  }
+  DecryptZSpace(out);
+}
+
+std::vector<BigInt> Decryptor::Decrypt(ConstSpan<Ciphertext> cts) const {
+  std::vector<BigInt> res(cts.size());
+  DecryptInto(cts, absl::MakeSpan(res));
+  return res;
+}
+
+void Decryptor::Decrypt(ConstSpan<Ciphertext> cts,
+                        DenseSpan<BigInt> out) const {
+  DecryptInto(cts, out);
+}
+
+void Decryptor::Decrypt(ConstDenseSpan<Ciphertext> cts,
+                        DenseSpan<BigInt> out) const {
+  DecryptInto(cts, out);
+}
+
+void Decryptor::DecryptZSpace(absl::Span<BigInt> cs) const {
+  pow_t_->PowMod(cs, cs);
+  for (auto &c : cs) {
+    Decode(std::move(c), &c);
+  }
+}
+
 }  // namespace heu::lib::algorithms::ou
@@ -14,11 +14,15 @@
 
 #pragma once
 
+#include <memory>
 #include <utility>
+#include <vector>
 
 #include "heu/library/algorithms/ou/ciphertext.h"
 #include "heu/library/algorithms/ou/public_key.h"
 #include "heu/library/algorithms/ou/secret_key.h"
+#include "heu/library/algorithms/util/fixed_exp_pow_mod.h"
+#include "heu/library/algorithms/util/spi_traits.h"
 
 namespace heu::lib::algorithms::ou {
 
@@ -28,10 +32,24 @@ class Decryptor {
 
   void Decrypt(const Ciphertext &ct, BigInt *out) const;
   [[nodiscard]] BigInt Decrypt(const Ciphertext &ct) const;
+  // Batched version, the secret exponent is shared by all ciphertexts
+  [[nodiscard]] std::vector<BigInt> Decrypt(ConstSpan<Ciphertext> cts) const;
+  // Same as above, but results are written into 'out'
+  void Decrypt(ConstSpan<Ciphertext> cts, DenseSpan<BigInt> out) const;
+  void Decrypt(ConstDenseSpan<Ciphertext> cts, DenseSpan<BigInt> out) const;
 
  private:
+  template <typename SPAN>
+  void DecryptInto(SPAN cts, DenseSpan<BigInt> out) const;
+  // Decrypts ciphertexts already mapped into Z-space, in place
+  void DecryptZSpace(absl::Span<BigInt> cs) const;
+  // c = ct^t mod p^2
+  void Decode(BigInt c, BigInt *out) const;
+
   PublicKey pk_;
   SecretKey sk_;
+  // c^t mod p^2 for batch decryption
+  std::shared_ptr<const FixedExpPowMod> pow_t_;
 };
 
 }  // namespace heu::lib::algorithms::ou
@@ -15,6 +15,7 @@
 #include "heu/library/algorithms/ou/evaluator.h"
 
 #include "heu/library/algorithms/util/he_assert.h"
+#include "heu/library/algorithms/util/short_pow_mod.h"
 
 namespace heu::lib::algorithms::ou {
 
@@ -113,18 +114,107 @@ Ciphertext Evaluator::Mul(const Ciphertext &a, const BigInt &p) const {
       // p == 1
       return a;
     }
+  } else if (p_bits <= kShortExpBits) {
+    // Small multiplier, stay in Montgomery form
+    Ciphertext out(
+        ShortPowMod(*pk_.m_space_, a.c_, p.Abs().Get<uint64_t>()));
+    return p.IsNegative() ? Negate(out) : out;
   }
 
   Ciphertext out;
   BigInt c(a.c_);
   pk_.m_space_->MapBackToZSpace(c);
-  out.c_ = c.PowMod(p, pk_.n_);
+  out.c_ = pk_.fixed_space_ ? pk_.fixed_space_->PowMod(c, p)
+                            : c.PowMod(p, pk_.n_);
   pk_.m_space_->MapIntoMSpace(out.c_);
   return out;
 }
 
+Ciphertext Evaluator::Mul(const Ciphertext &a, int64_t p) const {
+  // |p|, also right for INT64_MIN
+  uint64_t abs_p = p < 0 ? 0 - static_cast<uint64_t>(p) : p;
+  if (abs_p >> kShortExpBits != 0) {
+    return Mul(a, BigInt(p));
+  }
+
+  VALIDATE(a);
+  if (abs_p == 0) {
+    return Ciphertext(pk_.m_space_->Identity());
+  }
+  Ciphertext out =
+      abs_p == 1 ? a : Ciphertext(ShortPowMod(*pk_.m_space_, a.c_, abs_p));
+  return p < 0 ? Negate(out) : out;
+}
+
 void Evaluator::MulInplace(Ciphertext *a, const BigInt &p) const {
   *a = Mul(*a, p);
 }
 
+std::vector<Ciphertext> Evaluator::Mul(ConstSpan<Ciphertext> a,
+                                       ConstSpan<Plaintext> p) const {
+  std::vector<Ciphertext> out(a.size());
+  Mul(a, p, absl::MakeSpan(out));
+  return out;
+}
+
+void Evaluator::Mul(ConstSpan<Ciphertext> a, ConstSpan<Plaintext> p,
+                    DenseSpan<Ciphertext> out) const {
+  YACL_ENFORCE(a.size() == p.size() && a.size() == out.size(),
+               "size mismatch, a.size()={}, p.size()={}, out.size()={}",
+               a.size(), p.size(), out.size());
+  if (!pk_.multi_buffer_ || a.size() < MultiBufferPowMod::kLanes / 2) {
+    for (size_t i = 0; i < a.size(); ++i) {
+      out[i] = Mul(*a[i], *p[i]);
+    }
+    return;
+  }
+
+  // collect the operands that need a full exponentiation
+  std::vector<size_t> indices;
+  std::vector<BigInt> bases;
+  std::vector<BigInt> exps;
+  for (size_t i = 0; i < a.size(); ++i) {
+    if (p[i]->BitCount() <= kShortExpBits) {
+      out[i] = Mul(*a[i], *p[i]);
+      continue;
+    }
+
+    VALIDATE(*a[i]);
+    BigInt c(a[i]->c_);
+    pk_.m_space_->MapBackToZSpace(c);
+    if (p[i]->IsNegative()) {
+      bases.push_back(c.InvMod(pk_.n_));
+      exps.push_back(-*p[i]);
+    } else {
+      bases.push_back(std::move(c));
+      exps.push_back(*p[i]);
+    }
+    indices.push_back(i);
+  }
+
+  pk_.multi_buffer_->PowMod(bases, exps, absl::MakeSpan(bases));
+  for (size_t j = 0; j < indices.size(); ++j) {
+    pk_.m_space_->MapIntoMSpace(bases[j]);
+    out[indices[j]].c_ = std::move(bases[j]);
+  }
+}
+
+template <typename SPAN>
+Ciphertext Evaluator::ReduceSumImpl(SPAN a) const {
+  YACL_ENFORCE(!a.empty(), "ReduceSum: input is empty");
+  Ciphertext sum = Deref(a[0]);
+  for (size_t i = 1; i < a.size(); ++i) {
+    AddInplace(&sum, Deref(a[i]));
+  }
+  return sum;
+}
+
+Ciphertext Evaluator::ReduceSum(ConstSpan<Ciphertext> a) const {
+  return ReduceSumImpl(a);
+}
+
+Ciphertext Evaluator::ReduceSum(ConstDenseSpan<Ciphertext> a) const {
+  return ReduceSumImpl(a);
+}
+
 }  // namespace heu::lib::algorithms::ou
@@ -67,6 +67,9 @@ class Evaluator {
   // Warning 2:
   // Multiplication is not supported if a is in batch encoding form
   Ciphertext Mul(const Ciphertext &a, const BigInt &p) const;
+  // Same as above for a multiplier held inline, small ones are applied
+  // without building a BigInt
+  Ciphertext Mul(const Ciphertext &a, int64_t p) const;
 
   Plaintext Mul(const Plaintext &a, const Plaintext &b) const { return a * b; };
 
@@ -82,7 +85,22 @@ class Evaluator {
   Ciphertext Negate(const Ciphertext &a) const;
   void NegateInplace(Ciphertext *a) const;
 
+  // Vectorized version of Mul(). If the CPU supports MultiBufferPowMod, the
+  // exponentiations run in SIMD lanes.
+  std::vector<Ciphertext> Mul(ConstSpan<Ciphertext> a,
+                              ConstSpan<Plaintext> p) const;
+  // Same as above, but results are written into 'out', which must not overlap
+  // the inputs
+  void Mul(ConstSpan<Ciphertext> a, ConstSpan<Plaintext> p,
+           DenseSpan<Ciphertext> out) const;
+  // Returns the sum of all ciphertexts, 'a' must not be empty
+  Ciphertext ReduceSum(ConstSpan<Ciphertext> a) const;
+  Ciphertext ReduceSum(ConstDenseSpan<Ciphertext> a) const;
+
  private:
+  template <typename SPAN>
+  Ciphertext ReduceSumImpl(SPAN a) const;
+
   PublicKey pk_;
   Encryptor encryptor_;
 };
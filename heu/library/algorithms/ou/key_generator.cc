@@ -14,6 +14,8 @@
 
 #include "heu/library/algorithms/ou/key_generator.h"
 
+#include "heu/library/algorithms/util/prime_generator.h"
+
 namespace heu::lib::algorithms::ou {
 
 // according to this paper
@@ -39,19 +41,21 @@ void KeyGenerator::Generate(size_t key_size, SecretKey *sk, PublicKey *pk) {
                "Key size must be larger than {} bits",
                prime_factor_size * 2 * 3 - 2);
 
-  BigInt u, prime_factor;
-  do {
-    prime_factor = BigInt::RandPrimeOver(prime_factor_size);
+  BigInt prime_factor = ParallelRandPrimeOver(prime_factor_size);
+  sk->p_ = ParallelSearch([&](BigInt *p) {
     // bits_of(a * b) <= bits_of(a) + bits_of(b),
     // So we add extra two bits to u:
     //    one bit for prime_factor * u; another one bit for p^2;
     // Also, make sure that u > prime_factor
-    u = BigInt::RandomMonicExactBits(secret_size - prime_factor_size + 2);
-    sk->p_ = prime_factor * u + 1;  // p - 1 has a large prime factor
-  } while (!sk->p_.IsPrime());
+    BigInt u =
+        BigInt::RandomMonicExactBits(secret_size - prime_factor_size + 2);
+    *p = prime_factor * u + 1;  // p - 1 has a large prime factor
+    return p->IsPrime();
+  });
+  BigInt u = (sk->p_ - 1) / prime_factor;
   // since bits_of(a * b) <= bits_of(a) + bits_of(b)
   // add another 1 bit for q
-  sk->q_ = BigInt::RandPrimeOver(secret_size + 1);
+  sk->q_ = ParallelRandPrimeOver(secret_size + 1);
   sk->p2_ = sk->p_ * sk->p_;
   sk->p_half_ = sk->p_ >> 1;
   sk->t_ = prime_factor;
@@ -30,6 +30,8 @@ void PublicKey::Init() {
 
   // make cache table
   m_space_ = BigInt::CreateMontgomerySpace(n_);
+  fixed_space_ = FixedMontSpace::Create(n_);
+  multi_buffer_ = MultiBufferPowMod::Create(n_);
   cg_table_ = std::make_shared<BaseTable>();
   cgi_table_ = std::make_shared<BaseTable>();
   ch_table_ = std::make_shared<BaseTable>();
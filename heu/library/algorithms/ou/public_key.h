@@ -19,7 +19,9 @@
 #include "fmt/format.h"
 
 #include "heu/library/algorithms/util/big_int.h"
+#include "heu/library/algorithms/util/fixed_mont_space.h"
 #include "heu/library/algorithms/util/he_object.h"
+#include "heu/library/algorithms/util/multi_buffer_pow_mod.h"
 
 namespace heu::lib::algorithms::ou {
 
@@ -104,6 +106,10 @@ class PublicKey : public HeObject<PublicKey> {
   std::shared_ptr<BaseTable> cg_table_;   // Auxiliary array for capital_g_
   std::shared_ptr<BaseTable> cgi_table_;  // Auxiliary array for capital_g_inv_
   std::shared_ptr<BaseTable> ch_table_;   // Auxiliary array for capital_h_
+  // Fixed-width kernel for mod n, nullptr if the width of n is uncommon
+  std::shared_ptr<FixedMontSpace> fixed_space_;
+  // SIMD engine for mod n, nullptr if the CPU does not support it
+  std::shared_ptr<MultiBufferPowMod> multi_buffer_;
 
   void Init();
   [[nodiscard]] std::string ToString() const override;
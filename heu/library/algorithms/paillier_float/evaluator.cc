@@ -14,6 +14,10 @@
 
 #include "heu/library/algorithms/paillier_float/evaluator.h"
 
+#include <algorithm>
+#include <map>
+#include <vector>
+
 #include "heu/library/algorithms/paillier_float/internal/codec.h"
 
 namespace heu::lib::algorithms::paillier_f {
@@ -137,4 +141,45 @@ void Evaluator::DecreaseExponentTo(Ciphertext *cipher, int new_exp) const {
   cipher->exponent_ = new_exp;
 }
 
+int Evaluator::MinExponent(ConstSpan<Ciphertext> cts) const {
+  YACL_ENFORCE(!cts.empty(), "cannot get min exponent of an empty span");
+
+  int res = cts[0]->exponent_;
+  for (const auto *ct : cts) {
+    res = std::min(res, ct->exponent_);
+  }
+  return res;
+}
+
+void Evaluator::AlignExponents(Span<Ciphertext> cts, int new_exp) const {
+  // group ciphertexts by exponent delta
+  std::map<int, std::vector<Ciphertext *>> groups;
+  for (auto *ct : cts) {
+    YACL_ENFORCE(new_exp <= ct->exponent_,
+                 "new_exp should <= cipher's exponent, new_exp={}, exp={}",
+                 new_exp, ct->exponent_);
+    if (ct->exponent_ != new_exp) {
+      groups[ct->exponent_ - new_exp].push_back(ct);
+    }
+  }
+
+  internal::Codec codec(pk_);
+  for (const auto &[delta, group] : groups) {
+    BigInt factor = internal::Codec::kBaseCache.Pow(delta);
+    internal::EncodedNumber encoded_factor = codec.Encode(factor);
+    for (auto *ct : group) {
+      ct->c_ = MulRaw(ct->c_, encoded_factor.encoding);
+      ct->exponent_ = new_exp;
+    }
+  }
+}
+
+void Evaluator::AlignExponents(Span<Ciphertext> cts) const {
+  if (cts.empty()) {
+    return;
+  }
+  AlignExponents(cts,
+                 MinExponent(ConstSpan<Ciphertext>(cts.data(), cts.size())));
+}
+
 }  // namespace heu::lib::algorithms::paillier_f
@@ -79,6 +79,21 @@ class Evaluator {
   // a = -a
   void NegateInplace(Ciphertext *a) const;
 
+  // Batch exponent alignment.
+  // Add/Sub re-align two ciphertexts with an exponentiation whenever their
+  // exponents differ. Aligning a whole vector once makes all subsequent
+  // Add/Sub between these ciphertexts take the fast path.
+
+  // Returns the smallest exponent in cts
+  int MinExponent(ConstSpan<Ciphertext> cts) const;
+  // Decrease the exponents of all ciphertexts in cts to new_exp.
+  // new_exp must not be larger than any exponent in cts.
+  // Ciphertexts are grouped by exponent delta, so the factor of each group is
+  // encoded only once.
+  void AlignExponents(Span<Ciphertext> cts, int new_exp) const;
+  // Decrease the exponents of all ciphertexts in cts to MinExponent(cts)
+  void AlignExponents(Span<Ciphertext> cts) const;
+
  private:
   BigInt AddRaw(const BigInt &a, const BigInt &b) const;
 
@@ -155,6 +155,44 @@ TEST_F(PaillierTest, CipherMultiplyDoubleWorks) {
             static_cast<int64_t>(p1.Get<double>() * p2));
 }
 
+TEST_F(PaillierTest, AlignExponentsWorks) {
+  std::vector<double> values = {0.5, 3.1415, 1234.5678, 1e-5, -2.75, 7};
+
+  Encryptor encryptor(pub_key_);
+  std::vector<Ciphertext> cts;
+  for (double v : values) {
+    cts.push_back(encryptor.Encrypt(v));
+  }
+  std::vector<Ciphertext *> ptrs;
+  for (auto &ct : cts) {
+    ptrs.push_back(&ct);
+  }
+
+  Evaluator evaluator(pub_key_);
+  int min_exp = evaluator.MinExponent(ptrs);
+  evaluator.AlignExponents(absl::MakeSpan(ptrs));
+  EXPECT_EQ(evaluator.MinExponent(ptrs), min_exp);
+
+  Decryptor decryptor(pub_key_, sec_key_);
+  double sum = 0;
+  Ciphertext ct_sum = encryptor.Encrypt(BigInt(0));
+  for (size_t i = 0; i < values.size(); ++i) {
+    double plain;
+    decryptor.Decrypt(cts[i], &plain);
+    EXPECT_NEAR(plain, values[i], 1e-9);
+
+    sum += values[i];
+    evaluator.AddInplace(&ct_sum, cts[i]);
+  }
+
+  double plain_sum;
+  decryptor.Decrypt(ct_sum, &plain_sum);
+  EXPECT_NEAR(plain_sum, sum, 1e-9);
+
+  // exponent larger than current is not allowed
+  EXPECT_ANY_THROW(evaluator.AlignExponents(absl::MakeSpan(ptrs), 0));
+}
+
 class NegateInplaceTest : public ::testing::TestWithParam<int> {
  protected:
   void SetUp() override { KeyGenerator::Generate(2048, &sk_, &pk_); }
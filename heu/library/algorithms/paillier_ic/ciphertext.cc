@@ -22,7 +22,7 @@ namespace heu::lib::algorithms::paillier_ic {
 
 yacl::Buffer Ciphertext::Serialize() const {
   pb_ns::PaillierCiphertext pb_ct;
-  *pb_ct.mutable_c() = BigInt2PbBigint(c_);
+  BigInt2PbBigint(c_, pb_ct.mutable_c());
 
   yacl::Buffer buffer(pb_ct.ByteSizeLong());
   YACL_ENFORCE(pb_ct.SerializeToArray(buffer.data<uint8_t>(), buffer.size()),
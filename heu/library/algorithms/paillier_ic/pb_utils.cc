@@ -17,15 +17,19 @@
 namespace heu::lib::algorithms::paillier_ic {
 pb_ns::Bigint BigInt2PbBigint(const BigInt &bigint) {
   pb_ns::Bigint bi;
-  bi.set_is_neg(bigint.IsNegative());
-  auto buf_len = bigint.ToMagBytes(nullptr, 0);
-  bi.mutable_little_endian_value()->resize(buf_len);
-  bigint.ToMagBytes(reinterpret_cast<unsigned char *>(
-                        bi.mutable_little_endian_value()->data()),
-                    buf_len, yacl::Endian::little);
+  BigInt2PbBigint(bigint, &bi);
   return bi;
 }
 
+void BigInt2PbBigint(const BigInt &bigint, pb_ns::Bigint *out) {
+  out->set_is_neg(bigint.IsNegative());
+  auto buf_len = bigint.ToMagBytes(nullptr, 0);
+  auto *value = out->mutable_little_endian_value();
+  value->resize(buf_len);
+  bigint.ToMagBytes(reinterpret_cast<unsigned char *>(value->data()), buf_len,
+                    yacl::Endian::little);
+}
+
 void PbBigint2BigInt(const pb_ns::Bigint &bi, BigInt &bigint) {
   bigint.FromMagBytes(bi.little_endian_value(), yacl::Endian::little);
   if (bi.is_neg()) {
@@ -23,6 +23,9 @@ namespace heu::lib::algorithms::paillier_ic {
 namespace pb_ns = ::org::interconnection::v2::runtime;
 
 pb_ns::Bigint BigInt2PbBigint(const BigInt &bi);
+// Writes magnitude bytes directly into 'out', no temporary message is created.
+// 'out' may be a sub-message owned by an arena.
+void BigInt2PbBigint(const BigInt &bi, pb_ns::Bigint *out);
 void PbBigint2BigInt(const pb_ns::Bigint &pb_bi, BigInt &bigint);
 
 }  // namespace heu::lib::algorithms::paillier_ic
@@ -48,8 +48,8 @@ bool PublicKey::operator!=(const PublicKey &other) const {
 
 yacl::Buffer PublicKey::Serialize() const {
   pb_ns::PaillierPublicKey pk_pb;
-  *pk_pb.mutable_n() = BigInt2PbBigint(n_);
-  *pk_pb.mutable_hs() = BigInt2PbBigint(h_s_);
+  BigInt2PbBigint(n_, pk_pb.mutable_n());
+  BigInt2PbBigint(h_s_, pk_pb.mutable_hs());
 
   yacl::Buffer buffer(pk_pb.ByteSizeLong());
   YACL_ENFORCE(pk_pb.SerializeToArray(buffer.data<uint8_t>(), buffer.size()),
@@ -27,6 +27,8 @@ Decryptor::Decryptor(PublicKey pk, SecretKey sk)
   YACL_ENFORCE(sk_.p_ * sk_.q_ == pk_.n_,
                "pk and sk are not paired, {} * {} != {}", sk_.p_, sk_.q_,
                pk_.n_);
+  pow_p_ = std::make_shared<FixedExpPowMod>(sk_.phi_p_, sk_.p_square_);
+  pow_q_ = std::make_shared<FixedExpPowMod>(sk_.phi_q_, sk_.q_square_);
 }
 
 void Decryptor::Decrypt(const Ciphertext &ct, BigInt *out) const {
@@ -35,10 +37,12 @@ void Decryptor::Decrypt(const Ciphertext &ct, BigInt *out) const {
   BigInt c(ct.c_);
   pk_.m_space_->MapBackToZSpace(c);
 
-  BigInt mp = c.PowMod(sk_.phi_p_, sk_.p_square_);
-  mp = ((mp - 1) / sk_.p_).MulMod(sk_.hp_, sk_.p_);
+  DecodeCrt(c.PowMod(sk_.phi_p_, sk_.p_square_),
+            c.PowMod(sk_.phi_q_, sk_.q_square_), out);
+}
 
-  BigInt mq = c.PowMod(sk_.phi_q_, sk_.q_square_);
+void Decryptor::DecodeCrt(BigInt mp, BigInt mq, BigInt *out) const {
+  mp = ((mp - 1) / sk_.p_).MulMod(sk_.hp_, sk_.p_);
   mq = ((mq - 1) / sk_.q_).MulMod(sk_.hq_, sk_.q_);
 
   // Apply the CRT
@@ -58,4 +62,42 @@ BigInt Decryptor::Decrypt(const Ciphertext &ct) const {
   return mp;
 }
 
+template <typename SPAN>
+void Decryptor::DecryptInto(SPAN cts, DenseSpan<BigInt> out) const {
+  YACL_ENFORCE(cts.size() == out.size(),
+               "size mismatch, cts.size()={}, out.size()={}", cts.size(),
+               out.size());
+  for (size_t i = 0; i < cts.size(); ++i) {
+    const Ciphertext &ct = Deref(cts[i]);
+    VALIDATE(ct);
+    out[i] = ct.c_;
+    pk_.m_space_->MapBackToZSpace(out[i]);
+  }
+  DecryptZSpace(out);
+}
+
+std::vector<BigInt> Decryptor::Decrypt(ConstSpan<Ciphertext> cts) const {
+  std::vector<BigInt> res(cts.size());
+  DecryptInto(cts, absl::MakeSpan(res));
+  return res;
+}
+
+void Decryptor::Decrypt(ConstSpan<Ciphertext> cts,
+                        DenseSpan<BigInt> out) const {
+  DecryptInto(cts, out);
+}
+
+void Decryptor::Decrypt(ConstDenseSpan<Ciphertext> cts,
+                        DenseSpan<BigInt> out) const {
+  DecryptInto(cts, out);
+}
+
+void Decryptor::DecryptZSpace(absl::Span<BigInt> cs) const {
+  auto mps = pow_p_->PowMod(cs);
+  pow_q_->PowMod(cs, cs);
+  for (size_t i = 0; i < cs.size(); ++i) {
+    DecodeCrt(std::move(mps[i]), std::move(cs[i]), &cs[i]);
+  }
+}
+
 }  // namespace heu::lib::algorithms::paillier_z
@@ -14,11 +14,15 @@
 
 #pragma once
 
+#include <memory>
 #include <utility>
+#include <vector>
 
 #include "heu/library/algorithms/paillier_zahlen/ciphertext.h"
 #include "heu/library/algorithms/paillier_zahlen/public_key.h"
 #include "heu/library/algorithms/paillier_zahlen/secret_key.h"
+#include "heu/library/algorithms/util/fixed_exp_pow_mod.h"
+#include "heu/library/algorithms/util/spi_traits.h"
 
 namespace heu::lib::algorithms::paillier_z {
 
@@ -28,10 +32,24 @@ class Decryptor {
 
   void Decrypt(const Ciphertext &ct, BigInt *out) const;
   BigInt Decrypt(const Ciphertext &ct) const;
+  // Batched version, the secret exponents are shared by all ciphertexts
+  std::vector<BigInt> Decrypt(ConstSpan<Ciphertext> cts) const;
+  // Same as above, but results are written into 'out'
+  void Decrypt(ConstSpan<Ciphertext> cts, DenseSpan<BigInt> out) const;
+  void Decrypt(ConstDenseSpan<Ciphertext> cts, DenseSpan<BigInt> out) const;
 
  private:
+  template <typename SPAN>
+  void DecryptInto(SPAN cts, DenseSpan<BigInt> out) const;
+  // Decrypts ciphertexts already mapped into Z-space, in place
+  void DecryptZSpace(absl::Span<BigInt> cs) const;
+  // mp = c^phi_p mod p^2, mq = c^phi_q mod q^2
+  void DecodeCrt(BigInt mp, BigInt mq, BigInt *out) const;
+
   PublicKey pk_;
   SecretKey sk_;
+  // c^phi_p mod p^2 and c^phi_q mod q^2 for batch decryption
+  std::shared_ptr<const FixedExpPowMod> pow_p_, pow_q_;
 };
 
 }  // namespace heu::lib::algorithms::paillier_z
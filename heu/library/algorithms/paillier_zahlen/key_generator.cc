@@ -14,8 +14,12 @@
 
 #include "heu/library/algorithms/paillier_zahlen/key_generator.h"
 
+#include <tuple>
+
 #include "yacl/base/exception.h"
 
+#include "heu/library/algorithms/util/prime_generator.h"
+
 namespace heu::lib::algorithms::paillier_z {
 
 namespace {
@@ -31,12 +35,11 @@ void KeyGenerator::Generate(size_t key_size, SecretKey *sk, PublicKey *pk) {
   // large.
   do {
     size_t half = key_size / 2;
-    p = BigInt::RandPrimeOver(half, PrimeType::BBS);
-    do {
-      q = BigInt::RandPrimeOver(half, PrimeType::BBS);
-      c = (p - 1).Gcd(q - 1);
-    } while (c != 2 ||
-             (p - q).BitCount() < key_size / 2 - kPQDifferenceBitLenSub);
+    std::tie(p, q) = ParallelRandPrimePair(
+        half, PrimeType::BBS, [&](const BigInt &a, const BigInt &b) {
+          return (a - 1).Gcd(b - 1) == 2 &&
+                 (a - b).BitCount() >= half - kPQDifferenceBitLenSub;
+        });
     n = p * q;
   } while (n.BitCount() < key_size);
 
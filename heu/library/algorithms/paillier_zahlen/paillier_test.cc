@@ -15,6 +15,7 @@
 #include "heu/library/algorithms/paillier_zahlen/paillier.h"
 
 #include <string>
+#include <vector>
 
 #include "gtest/gtest.h"
 
@@ -118,6 +119,62 @@ TEST_F(ZPaillierTest, MinMaxDecrypt) {
   EXPECT_THROW(encryptor_->Encrypt(plain), std::exception);
 }
 
+TEST_F(ZPaillierTest, VectorizedMul) {
+  std::vector<BigInt> pts;
+  std::vector<BigInt> scalars = {BigInt(0), BigInt(1), BigInt(-1)};
+  for (int i = 0; i < 21; ++i) {
+    pts.emplace_back(i * 7919 - 100000);
+    if (scalars.size() < pts.size()) {
+      BigInt s(i * 104729);
+      if (i % 3 == 0) {
+        s = s << 40;  // too wide for ShortPowMod()
+      }
+      scalars.push_back(i % 2 == 0 ? s : -s);
+    }
+  }
+  std::vector<Ciphertext> cts;
+  for (const auto &pt : pts) {
+    cts.push_back(encryptor_->Encrypt(pt));
+  }
+  std::vector<const Ciphertext *> cts_ptr;
+  std::vector<const Plaintext *> scalars_ptr;
+  for (size_t i = 0; i < cts.size(); ++i) {
+    cts_ptr.push_back(&cts[i]);
+    scalars_ptr.push_back(&scalars[i]);
+  }
+
+  auto res = evaluator_->Mul(absl::MakeConstSpan(cts_ptr),
+                             absl::MakeConstSpan(scalars_ptr));
+  ASSERT_EQ(res.size(), pts.size());
+  for (size_t i = 0; i < pts.size(); ++i) {
+    EXPECT_EQ(decryptor_->Decrypt(res[i]), pts[i] * scalars[i]) << "i=" << i;
+  }
+
+  std::vector<const Ciphertext *> res_ptr;
+  for (const auto &ct : res) {
+    res_ptr.push_back(&ct);
+  }
+  BigInt sum(0);
+  for (size_t i = 0; i < pts.size(); ++i) {
+    sum += pts[i] * scalars[i];
+  }
+  EXPECT_EQ(decryptor_->Decrypt(
+                evaluator_->ReduceSum(absl::MakeConstSpan(res_ptr))),
+            sum);
+
+  // the products are written into a contiguous buffer and summed from there
+  std::vector<Ciphertext> dense_res(pts.size());
+  evaluator_->Mul(absl::MakeConstSpan(cts_ptr),
+                  absl::MakeConstSpan(scalars_ptr), absl::MakeSpan(dense_res));
+  EXPECT_EQ(decryptor_->Decrypt(
+                evaluator_->ReduceSum(absl::MakeConstSpan(dense_res))),
+            sum);
+  EXPECT_THROW(evaluator_->Mul(absl::MakeConstSpan(cts_ptr),
+                               absl::MakeConstSpan(scalars_ptr),
+                               absl::MakeSpan(dense_res).subspan(1)),
+               std::exception);
+}
+
 TEST_F(ZPaillierTest, PlaintextEvaluate1) {
   // base (m0) 为正数
   BigInt m0(123);
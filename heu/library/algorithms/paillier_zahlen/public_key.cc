@@ -31,6 +31,8 @@ void PublicKey::Init() {
   key_size_ = n_.BitCount();
 
   m_space_ = BigInt::CreateMontgomerySpace(n_square_);
+  fixed_space_ = FixedMontSpace::Create(n_square_);
+  multi_buffer_ = MultiBufferPowMod::Create(n_square_);
   hs_table_ = std::make_shared<BaseTable>();
   size_t word_size = m_space_->GetWordBitSize();
   m_space_->MakeBaseTable(
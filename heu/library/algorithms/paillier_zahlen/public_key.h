@@ -15,7 +15,9 @@
 #pragma once
 
 #include "heu/library/algorithms/util/big_int.h"
+#include "heu/library/algorithms/util/fixed_mont_space.h"
 #include "heu/library/algorithms/util/he_object.h"
+#include "heu/library/algorithms/util/multi_buffer_pow_mod.h"
 
 namespace heu::lib::algorithms::paillier_z {
 
@@ -35,6 +37,10 @@ class PublicKey : public HeObject<PublicKey> {
 
   std::shared_ptr<MontgomerySpace> m_space_;  // m-space for mod n^2
   std::shared_ptr<BaseTable> hs_table_;       // h_s_ table mod n^2
+  // Fixed-width kernel for mod n^2, nullptr if the width of n^2 is uncommon
+  std::shared_ptr<FixedMontSpace> fixed_space_;
+  // SIMD engine for mod n^2, nullptr if the CPU does not support it
+  std::shared_ptr<MultiBufferPowMod> multi_buffer_;
 
   // Init pk based on n_
   void Init();
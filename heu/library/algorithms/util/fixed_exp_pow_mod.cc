@@ -0,0 +1,115 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "heu/library/algorithms/util/fixed_exp_pow_mod.h"
+
+#include <algorithm>
+
+namespace heu::lib::algorithms {
+
+namespace {
+
+// Number of bases that walk through the schedule together
+constexpr size_t kLockStepWidth = 8;
+
+}  // namespace
+
+FixedExpPowMod::FixedExpPowMod(const BigInt &exp, const BigInt &mod)
+    : exp_(exp), mod_(mod), schedule_(BuildWindowSchedule(exp)) {
+  multi_buffer_ = MultiBufferPowMod::Create(mod_);
+  fixed_space_ = FixedMontSpace::Create(mod_);
+  if (!fixed_space_) {
+    m_space_ = BigInt::CreateMontgomerySpace(mod_);
+  }
+}
+
+std::vector<BigInt> FixedExpPowMod::PowMod(
+    absl::Span<const BigInt> bases) const {
+  std::vector<BigInt> res(bases.size());
+  PowMod(bases, absl::MakeSpan(res));
+  return res;
+}
+
+void FixedExpPowMod::PowMod(absl::Span<const BigInt> bases,
+                            absl::Span<BigInt> out) const {
+  YACL_ENFORCE(bases.size() == out.size(),
+               "size mismatch, bases.size()={}, out.size()={}", bases.size(),
+               out.size());
+  if (multi_buffer_) {
+    // A partial group costs as much as a full one, so a small remainder is
+    // left to the scalar engines
+    constexpr size_t kLanes = MultiBufferPowMod::kLanes;
+    size_t count = bases.size() % kLanes >= kLanes / 2
+                       ? bases.size()
+                       : bases.size() / kLanes * kLanes;
+    multi_buffer_->PowMod(bases.first(count), exp_, out.first(count));
+    bases.remove_prefix(count);
+    out.remove_prefix(count);
+  }
+  if (fixed_space_) {
+    fixed_space_->PowMod(bases, schedule_, out);
+    return;
+  }
+  if (schedule_.steps.empty()) {
+    // exp == 0
+    std::fill(out.begin(), out.end(), BigInt(1) % mod_);
+    return;
+  }
+
+  // odd powers of each base in the group: base^1, base^3, base^5, ...
+  size_t table_size = size_t{1} << (schedule_.window_bits - 1);
+  std::vector<std::vector<BigInt>> tables(kLockStepWidth,
+                                          std::vector<BigInt>(table_size));
+  auto square_all = [&](BigInt *acc, size_t width, size_t times) {
+    for (size_t t = 0; t < times; ++t) {
+      for (size_t k = 0; k < width; ++k) {
+        acc[k] = m_space_->MulMod(acc[k], acc[k]);
+      }
+    }
+  };
+
+  for (size_t beg = 0; beg < bases.size(); beg += kLockStepWidth) {
+    size_t width = std::min(kLockStepWidth, bases.size() - beg);
+    BigInt *acc = out.data() + beg;
+
+    for (size_t k = 0; k < width; ++k) {
+      auto &table = tables[k];
+      table[0] = bases[beg + k] % mod_;
+      m_space_->MapIntoMSpace(table[0]);
+      if (table_size > 1) {
+        BigInt square = m_space_->MulMod(table[0], table[0]);
+        for (size_t i = 1; i < table_size; ++i) {
+          table[i] = m_space_->MulMod(table[i - 1], square);
+        }
+      }
+      // the accumulator starts from the first window, no squares needed
+      acc[k] = table[schedule_.steps[0].index];
+    }
+
+    for (size_t s = 1; s < schedule_.steps.size(); ++s) {
+      const auto &step = schedule_.steps[s];
+      square_all(acc, width, step.squares);
+      for (size_t k = 0; k < width; ++k) {
+        acc[k] = m_space_->MulMod(acc[k], tables[k][step.index]);
+      }
+    }
+    square_all(acc, width, schedule_.tail_squares);
+
+    for (size_t k = 0; k < width; ++k) {
+      m_space_->MapBackToZSpace(acc[k]);
+    }
+  }
+}
+
+}  // namespace heu::lib::algorithms
@@ -0,0 +1,65 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "absl/types/span.h"
+
+#include "heu/library/algorithms/util/big_int.h"
+#include "heu/library/algorithms/util/fixed_mont_space.h"
+#include "heu/library/algorithms/util/multi_buffer_pow_mod.h"
+
+namespace heu::lib::algorithms {
+
+// Computes base^exp mod m for many bases that share the same exponent, e.g.
+// the secret exponent of a decryptor.
+//
+// The exponent is recoded into a sliding-window schedule once, at
+// construction time, instead of once per PowMod call. Bases are then processed
+// in small groups that walk through the schedule in lock-step, so that the
+// independent Montgomery multiplications of a group are issued back-to-back.
+// Moduli of a common width run on the fixed-width kernels of
+// fixed_mont_space.h, other moduli fall back to yacl's MontgomerySpace.
+// Batches large enough to fill the SIMD lanes run on MultiBufferPowMod if the
+// CPU supports it.
+class FixedExpPowMod {
+ public:
+  // 'mod' must be odd, 'exp' must be non-negative
+  FixedExpPowMod(const BigInt &exp, const BigInt &mod);
+
+  // Returns bases[i]^exp mod m. Bases must be non-negative, they do not need
+  // to be reduced.
+  std::vector<BigInt> PowMod(absl::Span<const BigInt> bases) const;
+  // Same as above, but writes results into 'out', out.size() == bases.size().
+  // 'out' may be the same array as 'bases'
+  void PowMod(absl::Span<const BigInt> bases, absl::Span<BigInt> out) const;
+
+  const BigInt &Exponent() const { return exp_; }
+
+  const BigInt &Modulus() const { return mod_; }
+
+ private:
+  BigInt exp_;
+  BigInt mod_;
+  mont::WindowSchedule schedule_;
+  std::unique_ptr<MultiBufferPowMod> multi_buffer_;  // nullptr if unsupported
+  // fixed-width kernel if one matches the modulus, otherwise m_space_ is used
+  std::unique_ptr<FixedMontSpace> fixed_space_;
+  std::unique_ptr<MontgomerySpace> m_space_;
+};
+
+}  // namespace heu::lib::algorithms
@@ -0,0 +1,62 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "heu/library/algorithms/util/fixed_exp_pow_mod.h"
+
+#include "gtest/gtest.h"
+
+namespace heu::lib::algorithms::test {
+
+namespace {
+
+void CheckPowMod(size_t mod_bits, size_t exp_bits) {
+  BigInt mod = BigInt::RandomExactBits(mod_bits);
+  if ((mod % BigInt(2)).IsZero()) {
+    mod += BigInt(1);
+  }
+  BigInt exp = exp_bits == 0 ? BigInt(0) : BigInt::RandomExactBits(exp_bits);
+  FixedExpPowMod engine(exp, mod);
+
+  // 19 bases: two full lock-step groups and a partial one
+  std::vector<BigInt> bases;
+  for (int i = 0; i < 19; ++i) {
+    bases.push_back(BigInt::RandomExactBits(mod_bits + 476));
+  }
+  bases.push_back(BigInt(0));
+  bases.push_back(BigInt(1));
+  bases.push_back(mod - 1);
+
+  auto res = engine.PowMod(bases);
+  ASSERT_EQ(res.size(), bases.size());
+  for (size_t i = 0; i < bases.size(); ++i) {
+    EXPECT_EQ(res[i], (bases[i] % mod).PowMod(exp, mod)) << "i=" << i;
+  }
+  EXPECT_TRUE(engine.PowMod({}).empty());
+}
+
+}  // namespace
+
+class FixedExpPowModTest : public ::testing::TestWithParam<size_t> {};
+
+INSTANTIATE_TEST_SUITE_P(SubTest, FixedExpPowModTest,
+                         ::testing::Values(0, 1, 17, 64, 200, 512, 1024));
+
+TEST_P(FixedExpPowModTest, PowModWorks) { CheckPowMod(1024, GetParam()); }
+
+// 18 limbs, there is no fixed-width kernel so MontgomerySpace is used
+TEST_P(FixedExpPowModTest, UncommonWidthWorks) {
+  CheckPowMod(1100, GetParam());
+}
+
+}  // namespace heu::lib::algorithms::test
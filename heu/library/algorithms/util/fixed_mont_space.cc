@@ -0,0 +1,132 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "heu/library/algorithms/util/fixed_mont_space.h"
+
+#include <vector>
+
+namespace heu::lib::algorithms {
+
+namespace {
+
+template <size_t kLimbs>
+class FixedMontSpaceImpl : public FixedMontSpace {
+ public:
+  using Kernel = mont::FixedMontKernel<kLimbs>;
+  using Limbs = typename Kernel::Limbs;
+
+  explicit FixedMontSpaceImpl(const BigInt &mod)
+      : mod_(mod),
+        kernel_(ToLimbs(mod),
+                ToLimbs((BigInt(1) << (2 * 64 * kLimbs)) % mod)) {}
+
+  BigInt PowMod(const BigInt &base, const BigInt &exp) const override {
+    if (exp.IsNegative()) {
+      return PowMod(base.InvMod(mod_), -exp);
+    }
+    Limbs limbs = ToLimbs(base % mod_);
+    kernel_.PowMod(&limbs, 1, BuildWindowSchedule(exp), &limbs);
+    return FromLimbs(limbs);
+  }
+
+  void PowMod(absl::Span<const BigInt> bases,
+              const mont::WindowSchedule &schedule,
+              absl::Span<BigInt> out) const override {
+    YACL_ENFORCE(bases.size() == out.size(),
+                 "size mismatch, bases.size()={}, out.size()={}",
+                 bases.size(), out.size());
+    std::vector<Limbs> limbs(bases.size());
+    for (size_t i = 0; i < bases.size(); ++i) {
+      limbs[i] = ToLimbs(bases[i] % mod_);
+    }
+    kernel_.PowMod(limbs.data(), limbs.size(), schedule, limbs.data());
+    for (size_t i = 0; i < limbs.size(); ++i) {
+      out[i] = FromLimbs(limbs[i]);
+    }
+  }
+
+  const BigInt &Modulus() const override { return mod_; }
+
+ private:
+  // 'x' must be non-negative and less than 2^(64 * kLimbs)
+  static Limbs ToLimbs(const BigInt &x) {
+    uint8_t bytes[kLimbs * 8] = {};
+    size_t len = x.ToMagBytes(nullptr, 0);
+    YACL_ENFORCE(len <= sizeof(bytes), "{}-bit value overflows {} limbs",
+                 x.BitCount(), kLimbs);
+    x.ToMagBytes(bytes, len, yacl::Endian::little);
+
+    Limbs res;
+    for (size_t i = 0; i < kLimbs; ++i) {
+      uint64_t limb = 0;
+      for (size_t j = 8; j-- > 0;) {
+        limb = (limb << 8) | bytes[i * 8 + j];
+      }
+      res[i] = limb;
+    }
+    return res;
+  }
+
+  static BigInt FromLimbs(const Limbs &limbs) {
+    uint8_t bytes[kLimbs * 8];
+    for (size_t i = 0; i < kLimbs; ++i) {
+      for (size_t j = 0; j < 8; ++j) {
+        bytes[i * 8 + j] = static_cast<uint8_t>(limbs[i] >> (8 * j));
+      }
+    }
+    BigInt res;
+    res.FromMagBytes(yacl::ByteContainerView(bytes, sizeof(bytes)),
+                     yacl::Endian::little);
+    return res;
+  }
+
+  BigInt mod_;
+  Kernel kernel_;
+};
+
+}  // namespace
+
+std::unique_ptr<FixedMontSpace> FixedMontSpace::Create(const BigInt &mod) {
+  if (mod.IsNegative() || (mod % BigInt(2)).IsZero()) {
+    return nullptr;
+  }
+
+  // Widths are multiples of 4 limbs, as required by the ADX kernel
+  switch ((mod.BitCount() + 63) / 64) {
+    case 16:  // 1024 bits
+      return std::make_unique<FixedMontSpaceImpl<16>>(mod);
+    case 24:  // 1536 bits
+      return std::make_unique<FixedMontSpaceImpl<24>>(mod);
+    case 32:  // 2048 bits
+      return std::make_unique<FixedMontSpaceImpl<32>>(mod);
+    case 48:  // 3072 bits
+      return std::make_unique<FixedMontSpaceImpl<48>>(mod);
+    case 64:  // 4096 bits
+      return std::make_unique<FixedMontSpaceImpl<64>>(mod);
+    case 96:  // 6144 bits
+      return std::make_unique<FixedMontSpaceImpl<96>>(mod);
+    default:
+      return nullptr;
+  }
+}
+
+mont::WindowSchedule BuildWindowSchedule(const BigInt &exp) {
+  YACL_ENFORCE(!exp.IsNegative(), "exponent must be non-negative, exp={}",
+               exp);
+  std::vector<uint8_t> bytes(exp.ToMagBytes(nullptr, 0));
+  exp.ToMagBytes(bytes.data(), bytes.size(), yacl::Endian::little);
+  return mont::WindowSchedule::Build(bytes.data(), bytes.size());
+}
+
+}  // namespace heu::lib::algorithms
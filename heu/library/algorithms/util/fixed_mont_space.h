@@ -0,0 +1,55 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+
+#include "absl/types/span.h"
+
+#include "heu/library/algorithms/util/big_int.h"
+#include "heu/library/algorithms/util/mont_kernel.h"
+
+namespace heu::lib::algorithms {
+
+// BigInt front end of the fixed-width Montgomery kernels (mont_kernel.h).
+//
+// Kernels are instantiated for the moduli used by Paillier-like schemes, i.e.
+// n, p^2 and n^2 of 1024 to 3072-bit keys. Unlike yacl's MontgomerySpace, all
+// inputs and outputs are in Z-space, the Montgomery form only exists inside
+// one call.
+class FixedMontSpace {
+ public:
+  // Returns nullptr if 'mod' is even or no kernel matches the width of 'mod'
+  static std::unique_ptr<FixedMontSpace> Create(const BigInt &mod);
+
+  virtual ~FixedMontSpace() = default;
+
+  // Returns base^exp mod m. 'base' must be non-negative, 'exp' may be
+  // negative if base is invertible.
+  virtual BigInt PowMod(const BigInt &base, const BigInt &exp) const = 0;
+
+  // out[i] = bases[i]^exp mod m, where 'schedule' is the recoded exponent.
+  // Bases must be non-negative, 'out' may be the same array as 'bases'
+  virtual void PowMod(absl::Span<const BigInt> bases,
+                      const mont::WindowSchedule &schedule,
+                      absl::Span<BigInt> out) const = 0;
+
+  virtual const BigInt &Modulus() const = 0;
+};
+
+// Recodes a non-negative exponent
+mont::WindowSchedule BuildWindowSchedule(const BigInt &exp);
+
+}  // namespace heu::lib::algorithms
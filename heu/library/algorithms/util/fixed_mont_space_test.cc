@@ -0,0 +1,88 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "heu/library/algorithms/util/fixed_mont_space.h"
+
+#include "gtest/gtest.h"
+
+namespace heu::lib::algorithms::test {
+
+namespace {
+
+BigInt RandomOddModulus(size_t bits) {
+  BigInt mod = BigInt::RandomExactBits(bits);
+  if ((mod % BigInt(2)).IsZero()) {
+    mod += BigInt(1);
+  }
+  return mod;
+}
+
+}  // namespace
+
+class FixedMontSpaceTest : public ::testing::TestWithParam<size_t> {};
+
+INSTANTIATE_TEST_SUITE_P(SubTest, FixedMontSpaceTest,
+                         ::testing::Values(1024, 2048, 3072, 4096));
+
+TEST_P(FixedMontSpaceTest, PowModWorks) {
+  BigInt mod = RandomOddModulus(GetParam());
+  auto space = FixedMontSpace::Create(mod);
+  ASSERT_NE(space, nullptr);
+  EXPECT_EQ(space->Modulus(), mod);
+
+  for (size_t exp_bits : {0, 1, 30, 300, 2048}) {
+    BigInt exp = exp_bits == 0 ? BigInt(0) : BigInt::RandomExactBits(exp_bits);
+    BigInt base = BigInt::RandomExactBits(GetParam() + 10);
+    EXPECT_EQ(space->PowMod(base, exp), (base % mod).PowMod(exp, mod))
+        << "exp_bits=" << exp_bits;
+  }
+  EXPECT_EQ(space->PowMod(mod - 1, BigInt(2)), BigInt(1));
+  EXPECT_EQ(space->PowMod(BigInt(0), BigInt(5)), BigInt(0));
+
+  // negative exponent
+  BigInt base = BigInt::RandomLtN(mod);
+  BigInt exp = BigInt::RandomExactBits(100);
+  EXPECT_EQ(space->PowMod(base, -exp), base.InvMod(mod).PowMod(exp, mod));
+}
+
+TEST_P(FixedMontSpaceTest, BatchPowModWorks) {
+  BigInt mod = RandomOddModulus(GetParam());
+  auto space = FixedMontSpace::Create(mod);
+  ASSERT_NE(space, nullptr);
+
+  BigInt exp = BigInt::RandomExactBits(GetParam() / 2);
+  auto schedule = BuildWindowSchedule(exp);
+  std::vector<BigInt> bases;
+  for (int i = 0; i < 19; ++i) {
+    bases.push_back(BigInt::RandomLtN(mod));
+  }
+  std::vector<BigInt> res(bases.size());
+  space->PowMod(bases, schedule, absl::MakeSpan(res));
+  for (size_t i = 0; i < bases.size(); ++i) {
+    EXPECT_EQ(res[i], bases[i].PowMod(exp, mod)) << "i=" << i;
+  }
+
+  // in place
+  space->PowMod(bases, schedule, absl::MakeSpan(bases));
+  EXPECT_EQ(bases, res);
+}
+
+TEST(FixedMontSpaceCreateTest, UnsupportedModulus) {
+  // 18 and 33 limbs, no kernel is instantiated for these widths
+  EXPECT_EQ(FixedMontSpace::Create(RandomOddModulus(1100)), nullptr);
+  EXPECT_EQ(FixedMontSpace::Create(RandomOddModulus(2100)), nullptr);
+  EXPECT_EQ(FixedMontSpace::Create(BigInt(1) << 2047), nullptr);
+}
+
+}  // namespace heu::lib::algorithms::test
@@ -0,0 +1,106 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "heu/library/algorithms/util/mont_kernel.h"
+
+#ifdef HEU_MONT_KERNEL_ADX
+#include <cpuid.h>
+#endif
+
+namespace heu::lib::algorithms::mont {
+
+namespace {
+
+// Same thresholds as the sliding window exponentiation of OpenSSL
+size_t WindowBits(size_t exp_bits) {
+  if (exp_bits > 671) {
+    return 6;
+  }
+  if (exp_bits > 239) {
+    return 5;
+  }
+  if (exp_bits > 79) {
+    return 4;
+  }
+  if (exp_bits > 23) {
+    return 3;
+  }
+  return 1;
+}
+
+}  // namespace
+
+WindowSchedule WindowSchedule::Build(const uint8_t *exp, size_t exp_bytes) {
+  while (exp_bytes > 0 && exp[exp_bytes - 1] == 0) {
+    --exp_bytes;
+  }
+  size_t exp_bits = 0;
+  if (exp_bytes > 0) {
+    exp_bits = exp_bytes * 8;
+    for (uint8_t top = exp[exp_bytes - 1]; (top & 0x80) == 0; top <<= 1) {
+      --exp_bits;
+    }
+  }
+
+  WindowSchedule res;
+  res.window_bits = WindowBits(exp_bits);
+  auto bit = [&](int64_t i) { return (exp[i / 8] >> (i % 8)) & 1; };
+
+  size_t squares = 0;
+  for (int64_t i = static_cast<int64_t>(exp_bits) - 1; i >= 0;) {
+    if (bit(i) == 0) {
+      ++squares;
+      --i;
+      continue;
+    }
+
+    int64_t j =
+        std::max<int64_t>(i - static_cast<int64_t>(res.window_bits) + 1, 0);
+    while (bit(j) == 0) {
+      ++j;
+    }
+    size_t digit = 0;
+    for (int64_t k = i; k >= j; --k) {
+      digit = (digit << 1) | bit(k);
+    }
+    res.steps.push_back(
+        {squares + static_cast<size_t>(i - j + 1), digit >> 1});
+    squares = 0;
+    i = j - 1;
+  }
+  res.tail_squares = squares;
+  return res;
+}
+
+bool CpuHasAdx() {
+#ifdef HEU_MONT_KERNEL_ADX
+  static const bool has_adx = [] {
+    unsigned int eax;
+    unsigned int ebx;
+    unsigned int ecx;
+    unsigned int edx;
+    if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) == 0) {
+      return false;
+    }
+    constexpr unsigned int kBmi2 = 1U << 8;
+    constexpr unsigned int kAdx = 1U << 19;
+    return (ebx & kBmi2) != 0 && (ebx & kAdx) != 0;
+  }();
+  return has_adx;
+#else
+  return false;
+#endif
+}
+
+}  // namespace heu::lib::algorithms::mont
@@ -0,0 +1,302 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define HEU_MONT_KERNEL_ADX 1
+#endif
+
+// Montgomery arithmetic over moduli of a fixed, compile-time number of 64-bit
+// limbs. All loop bounds are constants, so the compiler fully unrolls and
+// schedules the CIOS inner loops, which a generic bigint library cannot do.
+//
+// This header does not depend on any bigint library, conversion from/to
+// BigInt lives in fixed_mont_space.h.
+
+namespace heu::lib::algorithms::mont {
+
+// Left-to-right sliding-window recoding of an exponent. Each window starts and
+// ends with a 1 bit, so only odd powers of the base are needed:
+//   acc = table[steps[0].index]
+//   for each following step: square acc 'squares' times, then multiply it by
+//                            table[index]
+//   square acc 'tail_squares' times
+// where table[i] = base^(2i+1)
+struct WindowSchedule {
+  struct Step {
+    size_t squares;
+    size_t index;
+  };
+
+  size_t window_bits = 1;
+  std::vector<Step> steps;  // empty if exp == 0
+  size_t tail_squares = 0;
+
+  // 'exp' is the little-endian magnitude of the exponent
+  static WindowSchedule Build(const uint8_t *exp, size_t exp_bytes);
+};
+
+// Returns true if the CPU supports MULX (BMI2) and ADCX/ADOX (ADX)
+bool CpuHasAdx();
+
+namespace internal {
+
+using u128 = unsigned __int128;
+
+// out = t - n if t >= n, else t. 't' has kLimbs + 1 limbs and t < 2n.
+template <size_t kLimbs>
+inline void FinalSubtract(const uint64_t *t, const uint64_t *n,
+                          uint64_t *out) {
+  bool ge = t[kLimbs] != 0;
+  if (!ge) {
+    ge = true;  // t == n
+    for (size_t i = kLimbs; i-- > 0;) {
+      if (t[i] != n[i]) {
+        ge = t[i] > n[i];
+        break;
+      }
+    }
+  }
+  if (!ge) {
+    std::copy(t, t + kLimbs, out);
+    return;
+  }
+  uint64_t borrow = 0;
+  for (size_t i = 0; i < kLimbs; ++i) {
+    u128 d = static_cast<u128>(t[i]) - n[i] - borrow;
+    out[i] = static_cast<uint64_t>(d);
+    borrow = static_cast<uint64_t>(d >> 64) & 1;
+  }
+}
+
+// Coarsely Integrated Operand Scanning Montgomery multiplication:
+// out = a * b / R mod n, where R = 2^(64 * kLimbs) and n0inv = -n^-1 mod 2^64.
+// Inputs must be less than n, 'out' may alias 'a' or 'b'.
+template <size_t kLimbs>
+void MontMulPortable(const uint64_t *a, const uint64_t *b, const uint64_t *n,
+                     uint64_t n0inv, uint64_t *out) {
+  uint64_t t[kLimbs + 2] = {};
+  for (size_t i = 0; i < kLimbs; ++i) {
+    // t += a * b[i]
+    uint64_t c = 0;
+    for (size_t j = 0; j < kLimbs; ++j) {
+      u128 u = static_cast<u128>(a[j]) * b[i] + t[j] + c;
+      t[j] = static_cast<uint64_t>(u);
+      c = static_cast<uint64_t>(u >> 64);
+    }
+    u128 u = static_cast<u128>(t[kLimbs]) + c;
+    t[kLimbs] = static_cast<uint64_t>(u);
+    t[kLimbs + 1] = static_cast<uint64_t>(u >> 64);
+
+    // t = (t + m * n) / 2^64
+    uint64_t m = t[0] * n0inv;
+    u = static_cast<u128>(m) * n[0] + t[0];
+    c = static_cast<uint64_t>(u >> 64);
+    for (size_t j = 1; j < kLimbs; ++j) {
+      u = static_cast<u128>(m) * n[j] + t[j] + c;
+      t[j - 1] = static_cast<uint64_t>(u);
+      c = static_cast<uint64_t>(u >> 64);
+    }
+    u = static_cast<u128>(t[kLimbs]) + c;
+    t[kLimbs - 1] = static_cast<uint64_t>(u);
+    t[kLimbs] = t[kLimbs + 1] + static_cast<uint64_t>(u >> 64);
+  }
+  FinalSubtract<kLimbs>(t, n, out);
+}
+
+#ifdef HEU_MONT_KERNEL_ADX
+
+// t[0..n+1] += a[0..n-1] * b, n must be a positive multiple of 4.
+// The low and high halves of each MULX product are accumulated by two
+// independent carry chains, ADCX only touches CF and ADOX only touches OF, so
+// the loop control must not modify flags either (LEA and JRCXZ).
+inline void AddMulRowAdx(uint64_t *t, const uint64_t *a, uint64_t b,
+                         size_t n) {
+  uint64_t lo;
+  uint64_t hi;
+  uint64_t acc;
+  uint64_t zero;
+  size_t rounds = n / 4;
+  __asm__ volatile(
+      "xorl %k[zero], %k[zero]\n\t"  // also clears CF and OF
+      "movq (%[t]), %[acc]\n\t"
+      "1:\n\t"
+      "mulxq (%[a]), %[lo], %[hi]\n\t"
+      "adcxq %[acc], %[lo]\n\t"
+      "movq %[lo], 0(%[t])\n\t"
+      "adoxq 8(%[t]), %[hi]\n\t"
+      "movq %[hi], %[acc]\n\t"
+      "mulxq 8(%[a]), %[lo], %[hi]\n\t"
+      "adcxq %[acc], %[lo]\n\t"
+      "movq %[lo], 8(%[t])\n\t"
+      "adoxq 16(%[t]), %[hi]\n\t"
+      "movq %[hi], %[acc]\n\t"
+      "mulxq 16(%[a]), %[lo], %[hi]\n\t"
+      "adcxq %[acc], %[lo]\n\t"
+      "movq %[lo], 16(%[t])\n\t"
+      "adoxq 24(%[t]), %[hi]\n\t"
+      "movq %[hi], %[acc]\n\t"
+      "mulxq 24(%[a]), %[lo], %[hi]\n\t"
+      "adcxq %[acc], %[lo]\n\t"
+      "movq %[lo], 24(%[t])\n\t"
+      "adoxq 32(%[t]), %[hi]\n\t"
+      "movq %[hi], %[acc]\n\t"
+      "leaq 32(%[a]), %[a]\n\t"
+      "leaq 32(%[t]), %[t]\n\t"
+      "leaq -1(%[rounds]), %[rounds]\n\t"
+      "jrcxz 2f\n\t"
+      "jmp 1b\n\t"
+      "2:\n\t"
+      // CF belongs to t[n], OF belongs to t[n + 1]
+      "adcxq %[zero], %[acc]\n\t"
+      "movq %[acc], (%[t])\n\t"
+      "movq 8(%[t]), %[hi]\n\t"
+      "adoxq %[zero], %[hi]\n\t"
+      "adcxq %[zero], %[hi]\n\t"
+      "movq %[hi], 8(%[t])\n\t"
+      : [t] "+r"(t), [a] "+r"(a), [rounds] "+c"(rounds), [lo] "=&r"(lo),
+        [hi] "=&r"(hi), [acc] "=&r"(acc), [zero] "=&r"(zero)
+      : "d"(b)
+      : "cc", "memory");
+}
+
+// Same result as MontMulPortable. Each row is accumulated into a window of
+// 't' that slides by one limb, so the division by 2^64 costs nothing.
+template <size_t kLimbs>
+void MontMulAdx(const uint64_t *a, const uint64_t *b, const uint64_t *n,
+                uint64_t n0inv, uint64_t *out) {
+  static_assert(kLimbs % 4 == 0, "rows are unrolled by 4 limbs");
+  uint64_t t[2 * kLimbs + 2] = {};
+  for (size_t i = 0; i < kLimbs; ++i) {
+    AddMulRowAdx(t + i, a, b[i], kLimbs);
+    AddMulRowAdx(t + i, n, t[i] * n0inv, kLimbs);
+  }
+  FinalSubtract<kLimbs>(t + kLimbs, n, out);
+}
+
+#endif
+
+}  // namespace internal
+
+template <size_t kLimbs>
+class FixedMontKernel {
+ public:
+  using Limbs = std::array<uint64_t, kLimbs>;
+
+  // 'mod' must be odd and 'r2' must be R^2 mod 'mod', where
+  // R = 2^(64 * kLimbs)
+  FixedMontKernel(const Limbs &mod, const Limbs &r2) : mod_(mod), r2_(r2) {
+    // Newton iteration, each round doubles the number of correct low bits.
+    // mod[0] * mod[0] = 1 (mod 8) gives the first 3 bits.
+    uint64_t inv = mod[0];
+    for (int i = 0; i < 5; ++i) {
+      inv *= 2 - mod[0] * inv;
+    }
+    n0inv_ = ~inv + 1;
+    one_.fill(0);
+    one_[0] = 1;
+
+    mul_ = &internal::MontMulPortable<kLimbs>;
+#ifdef HEU_MONT_KERNEL_ADX
+    if (CpuHasAdx()) {
+      mul_ = &internal::MontMulAdx<kLimbs>;
+    }
+#endif
+  }
+
+  // out = a * b / R mod m. Inputs must be reduced, 'out' may alias inputs.
+  void Mul(const Limbs &a, const Limbs &b, Limbs *out) const {
+    mul_(a.data(), b.data(), mod_.data(), n0inv_, out->data());
+  }
+
+  void ToMont(const Limbs &a, Limbs *out) const { Mul(a, r2_, out); }
+
+  void FromMont(const Limbs &a, Limbs *out) const { Mul(a, one_, out); }
+
+  // out[i] = bases[i]^exp mod m, where 'schedule' is the recoded exponent.
+  // Bases must be reduced, 'out' may be the same array as 'bases'.
+  void PowMod(const Limbs *bases, size_t count, const WindowSchedule &schedule,
+              Limbs *out) const {
+    if (schedule.steps.empty()) {
+      // exp == 0
+      std::fill(out, out + count, one_);
+      return;
+    }
+
+    size_t table_size = size_t{1} << (schedule.window_bits - 1);
+    std::vector<Limbs> tables(kLockStepWidth * table_size);
+    Limbs acc[kLockStepWidth];
+    for (size_t beg = 0; beg < count; beg += kLockStepWidth) {
+      size_t width = std::min(kLockStepWidth, count - beg);
+      for (size_t k = 0; k < width; ++k) {
+        Limbs *table = tables.data() + k * table_size;
+        ToMont(bases[beg + k], &table[0]);
+        if (table_size > 1) {
+          Limbs square;
+          Mul(table[0], table[0], &square);
+          for (size_t i = 1; i < table_size; ++i) {
+            Mul(table[i - 1], square, &table[i]);
+          }
+        }
+        acc[k] = table[schedule.steps[0].index];
+      }
+
+      // the accumulator starts from the first window, no squares needed
+      for (size_t s = 1; s < schedule.steps.size(); ++s) {
+        const auto &step = schedule.steps[s];
+        SquareAll(acc, width, step.squares);
+        for (size_t k = 0; k < width; ++k) {
+          Mul(acc[k], tables[k * table_size + step.index], &acc[k]);
+        }
+      }
+      SquareAll(acc, width, schedule.tail_squares);
+
+      for (size_t k = 0; k < width; ++k) {
+        FromMont(acc[k], &out[beg + k]);
+      }
+    }
+  }
+
+  const Limbs &Modulus() const { return mod_; }
+
+ private:
+  // Number of bases that walk through the schedule together
+  static constexpr size_t kLockStepWidth = 8;
+
+  using MulFn = void (*)(const uint64_t *a, const uint64_t *b,
+                         const uint64_t *n, uint64_t n0inv, uint64_t *out);
+
+  void SquareAll(Limbs *acc, size_t width, size_t times) const {
+    for (size_t t = 0; t < times; ++t) {
+      for (size_t k = 0; k < width; ++k) {
+        Mul(acc[k], acc[k], &acc[k]);
+      }
+    }
+  }
+
+  Limbs mod_;
+  Limbs r2_;
+  Limbs one_;
+  uint64_t n0inv_;
+  MulFn mul_;
+};
+
+}  // namespace heu::lib::algorithms::mont
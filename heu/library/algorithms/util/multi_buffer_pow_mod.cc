@@ -0,0 +1,350 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "heu/library/algorithms/util/multi_buffer_pow_mod.h"
+
+#include <algorithm>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <cpuid.h>
+#include <immintrin.h>
+#define HEU_MULTI_BUFFER_IFMA 1
+#define HEU_IFMA_TARGET __attribute__((target("avx512f,avx512ifma")))
+#endif
+
+namespace heu::lib::algorithms {
+
+namespace {
+
+using Lanes = MultiBufferPowMod::Lanes;
+
+constexpr size_t kDigitBits = 52;
+constexpr uint64_t kDigitMask = (uint64_t{1} << kDigitBits) - 1;
+constexpr size_t kMaxModulusBits = 8192;
+
+// Fixed window size, chosen by the longest exponent of a group. Lanes may
+// have different exponents, so sliding windows are not applicable.
+size_t WindowBits(size_t exp_bits) {
+  if (exp_bits > 256) {
+    return 5;
+  }
+  if (exp_bits > 32) {
+    return 4;
+  }
+  return 1;
+}
+
+#ifdef HEU_MULTI_BUFFER_IFMA
+
+// Almost Montgomery multiplication of all lanes:
+// out = a * b / R mod n, where inputs are less than 2n and so is the output.
+// Digits of inputs must be normalized (less than 2^52), the output is
+// normalized as well. 't' is a scratch buffer of 2 * k digits.
+HEU_IFMA_TARGET void AmmIfma(const Lanes *a, const Lanes *b, const Lanes *n,
+                             uint64_t n0inv, size_t k, Lanes *t, Lanes *out) {
+  const auto *va = reinterpret_cast<const __m512i *>(a);
+  const auto *vb = reinterpret_cast<const __m512i *>(b);
+  const auto *vn = reinterpret_cast<const __m512i *>(n);
+  auto *vt = reinterpret_cast<__m512i *>(t);
+  const __m512i zero = _mm512_setzero_si512();
+  const __m512i vn0inv = _mm512_set1_epi64(static_cast<int64_t>(n0inv));
+
+  for (size_t j = 0; j < 2 * k; ++j) {
+    vt[j] = zero;
+  }
+  // Each row adds a * b[i] + m * n to a window of 't' that slides by one
+  // digit, 64-bit accumulators leave enough room for the carries of all rows
+  for (size_t i = 0; i < k; ++i) {
+    __m512i *row = vt + i;
+    __m512i bi = vb[i];
+    row[0] = _mm512_madd52lo_epu64(row[0], va[0], bi);
+    __m512i m = _mm512_madd52lo_epu64(zero, row[0], vn0inv);
+    row[0] = _mm512_madd52lo_epu64(row[0], vn[0], m);
+    row[1] = _mm512_madd52hi_epu64(row[1], va[0], bi);
+    row[1] = _mm512_madd52hi_epu64(row[1], vn[0], m);
+    for (size_t j = 1; j < k; ++j) {
+      row[j] = _mm512_madd52lo_epu64(row[j], va[j], bi);
+      row[j] = _mm512_madd52lo_epu64(row[j], vn[j], m);
+      row[j + 1] = _mm512_madd52hi_epu64(row[j + 1], va[j], bi);
+      row[j + 1] = _mm512_madd52hi_epu64(row[j + 1], vn[j], m);
+    }
+    // the low 52 bits of row[0] are zero now
+    row[1] = _mm512_add_epi64(row[1], _mm512_srli_epi64(row[0], kDigitBits));
+  }
+
+  const __m512i mask = _mm512_set1_epi64(static_cast<int64_t>(kDigitMask));
+  __m512i *res = vt + k;
+  auto *vout = reinterpret_cast<__m512i *>(out);
+  for (size_t j = 0; j + 1 < k; ++j) {
+    res[j + 1] =
+        _mm512_add_epi64(res[j + 1], _mm512_srli_epi64(res[j], kDigitBits));
+    vout[j] = _mm512_and_si512(res[j], mask);
+  }
+  vout[k - 1] = res[k - 1];
+}
+
+// out = table[index[lane]] for every lane, without data-dependent memory
+// access
+HEU_IFMA_TARGET void SelectIfma(const Lanes *table, size_t table_size,
+                                const Lanes &index, size_t k, Lanes *out) {
+  const auto *vtable = reinterpret_cast<const __m512i *>(table);
+  auto *vout = reinterpret_cast<__m512i *>(out);
+  __m512i vidx = _mm512_load_si512(index.v);
+  for (size_t j = 0; j < k; ++j) {
+    vout[j] = _mm512_setzero_si512();
+  }
+  for (size_t d = 0; d < table_size; ++d) {
+    __mmask8 hit = _mm512_cmpeq_epi64_mask(
+        vidx, _mm512_set1_epi64(static_cast<int64_t>(d)));
+    const __m512i *entry = vtable + d * k;
+    for (size_t j = 0; j < k; ++j) {
+      vout[j] = _mm512_mask_mov_epi64(vout[j], hit, entry[j]);
+    }
+  }
+}
+
+#else
+
+void AmmIfma(const Lanes *, const Lanes *, const Lanes *, uint64_t, size_t,
+             Lanes *, Lanes *) {
+  YACL_THROW("AVX-512 IFMA is not available on this platform");
+}
+
+void SelectIfma(const Lanes *, size_t, const Lanes &, size_t, Lanes *) {
+  YACL_THROW("AVX-512 IFMA is not available on this platform");
+}
+
+#endif
+
+// Fixed-window exponentiation of all lanes. 'windows' holds the exponent
+// digits of each lane, most significant window first.
+// 'base' and 'out' are in Z-space, bases must be less than n.
+void PowModLanes(const Lanes *base, const std::vector<Lanes> &windows,
+                 size_t window_bits, const Lanes *n, const Lanes *r2,
+                 uint64_t n0inv, size_t k, Lanes *out) {
+  size_t table_size = size_t{1} << window_bits;
+  std::vector<Lanes> table(table_size * k);
+  std::vector<Lanes> t(2 * k);
+  std::vector<Lanes> one(k, Lanes{});
+  std::fill_n(one[0].v, MultiBufferPowMod::kLanes, 1);
+  auto amm = [&](const Lanes *a, const Lanes *b, Lanes *res) {
+    AmmIfma(a, b, n, n0inv, k, t.data(), res);
+  };
+
+  // table[d] = base^d in Montgomery form
+  amm(one.data(), r2, table.data());
+  amm(base, r2, table.data() + k);
+  for (size_t d = 2; d < table_size; ++d) {
+    amm(table.data() + (d - 1) * k, table.data() + k, table.data() + d * k);
+  }
+
+  std::vector<Lanes> acc(k);
+  std::vector<Lanes> factor(k);
+  SelectIfma(table.data(), table_size, windows[0], k, acc.data());
+  for (size_t w = 1; w < windows.size(); ++w) {
+    for (size_t s = 0; s < window_bits; ++s) {
+      amm(acc.data(), acc.data(), acc.data());
+    }
+    const auto &digits = windows[w].v;
+    if (std::all_of(digits, digits + MultiBufferPowMod::kLanes,
+                    [](uint64_t d) { return d == 0; })) {
+      continue;
+    }
+    SelectIfma(table.data(), table_size, windows[w], k, factor.data());
+    amm(acc.data(), factor.data(), acc.data());
+  }
+  amm(acc.data(), one.data(), out);
+}
+
+// Writes the radix-2^52 digits of 'x' into lane 'lane' of 'out'
+void ToDigits(const BigInt &x, size_t k, size_t lane, Lanes *out) {
+  // spare bytes, so that every digit can be read with one 64-bit word
+  std::vector<uint8_t> bytes(k * kDigitBits / 8 + 16, 0);
+  size_t len = x.ToMagBytes(nullptr, 0);
+  YACL_ENFORCE(len + 8 <= bytes.size(), "{}-bit value overflows {} digits",
+               x.BitCount(), k);
+  x.ToMagBytes(bytes.data(), len, yacl::Endian::little);
+
+  for (size_t j = 0; j < k; ++j) {
+    size_t bit = j * kDigitBits;
+    uint64_t word = 0;
+    for (size_t b = 8; b-- > 0;) {
+      word = (word << 8) | bytes[bit / 8 + b];
+    }
+    out[j].v[lane] = (word >> (bit % 8)) & kDigitMask;
+  }
+}
+
+BigInt FromDigits(const Lanes *digits, size_t k, size_t lane) {
+  std::vector<uint8_t> bytes;
+  bytes.reserve(k * kDigitBits / 8 + 8);
+  unsigned __int128 acc = 0;
+  size_t acc_bits = 0;
+  for (size_t j = 0; j < k; ++j) {
+    acc |= static_cast<unsigned __int128>(digits[j].v[lane]) << acc_bits;
+    acc_bits += kDigitBits;
+    while (acc_bits >= 8) {
+      bytes.push_back(static_cast<uint8_t>(acc));
+      acc >>= 8;
+      acc_bits -= 8;
+    }
+  }
+  bytes.push_back(static_cast<uint8_t>(acc));
+
+  BigInt res;
+  res.FromMagBytes(yacl::ByteContainerView(bytes.data(), bytes.size()),
+                   yacl::Endian::little);
+  return res;
+}
+
+}  // namespace
+
+bool MultiBufferPowMod::IsSupported() {
+#ifdef HEU_MULTI_BUFFER_IFMA
+  static const bool supported = [] {
+    unsigned int eax;
+    unsigned int ebx;
+    unsigned int ecx;
+    unsigned int edx;
+    // OSXSAVE: XGETBV is available to query the states saved by the OS
+    if (__get_cpuid(1, &eax, &ebx, &ecx, &edx) == 0 ||
+        (ecx & (1U << 27)) == 0) {
+      return false;
+    }
+    uint32_t xcr0_lo;
+    uint32_t xcr0_hi;
+    __asm__("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+    // SSE, AVX, opmask, upper halves of ZMM0-15 and ZMM16-31
+    constexpr uint32_t kZmmStates = 0xE6;
+    if ((xcr0_lo & kZmmStates) != kZmmStates) {
+      return false;
+    }
+
+    if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) == 0) {
+      return false;
+    }
+    constexpr unsigned int kAvx512F = 1U << 16;
+    constexpr unsigned int kAvx512Ifma = 1U << 21;
+    return (ebx & kAvx512F) != 0 && (ebx & kAvx512Ifma) != 0;
+  }();
+  return supported;
+#else
+  return false;
+#endif
+}
+
+std::unique_ptr<MultiBufferPowMod> MultiBufferPowMod::Create(
+    const BigInt &mod) {
+  if (!IsSupported() || mod.IsNegative() || (mod % BigInt(2)).IsZero() ||
+      mod.BitCount() > kMaxModulusBits) {
+    return nullptr;
+  }
+  return std::unique_ptr<MultiBufferPowMod>(new MultiBufferPowMod(mod));
+}
+
+MultiBufferPowMod::MultiBufferPowMod(const BigInt &mod) : mod_(mod) {
+  // 4 * mod < R keeps the results of almost Montgomery multiplications below
+  // 2 * mod, so no final subtraction is needed between multiplications
+  digits_ = (mod_.BitCount() + 2 + kDigitBits - 1) / kDigitBits;
+
+  // Newton iteration, each round doubles the number of correct low bits
+  uint64_t n0 = (mod_ % (BigInt(1) << 64)).Get<uint64_t>();
+  uint64_t inv = n0;
+  for (int i = 0; i < 5; ++i) {
+    inv *= 2 - n0 * inv;
+  }
+  n0inv_ = (~inv + 1) & kDigitMask;
+
+  BigInt r2 = (BigInt(1) << (2 * kDigitBits * digits_)) % mod_;
+  n_.resize(digits_);
+  r2_.resize(digits_);
+  for (size_t lane = 0; lane < kLanes; ++lane) {
+    ToDigits(mod_, digits_, lane, n_.data());
+    ToDigits(r2, digits_, lane, r2_.data());
+  }
+}
+
+void MultiBufferPowMod::PowMod(absl::Span<const BigInt> bases,
+                               absl::Span<const BigInt> exps,
+                               absl::Span<BigInt> out) const {
+  YACL_ENFORCE(bases.size() == exps.size(),
+               "size mismatch, bases.size()={}, exps.size()={}",
+               bases.size(), exps.size());
+  PowModImpl(
+      bases, [&](size_t i) -> const BigInt & { return exps[i]; }, out);
+}
+
+void MultiBufferPowMod::PowMod(absl::Span<const BigInt> bases,
+                               const BigInt &exp,
+                               absl::Span<BigInt> out) const {
+  PowModImpl(
+      bases, [&](size_t) -> const BigInt & { return exp; }, out);
+}
+
+void MultiBufferPowMod::PowModImpl(
+    absl::Span<const BigInt> bases,
+    const std::function<const BigInt &(size_t)> &exp_at,
+    absl::Span<BigInt> out) const {
+  YACL_ENFORCE(bases.size() == out.size(),
+               "size mismatch, bases.size()={}, out.size()={}",
+               bases.size(), out.size());
+
+  std::vector<Lanes> base(digits_);
+  std::vector<Lanes> res(digits_);
+  std::vector<std::vector<uint8_t>> exp_bytes(kLanes);
+  for (size_t beg = 0; beg < bases.size(); beg += kLanes) {
+    size_t width = std::min(kLanes, bases.size() - beg);
+
+    // unused lanes compute 0^0
+    std::fill(base.begin(), base.end(), Lanes{});
+    size_t exp_bits = 0;
+    for (size_t lane = 0; lane < width; ++lane) {
+      ToDigits(bases[beg + lane] % mod_, digits_, lane, base.data());
+      const BigInt &exp = exp_at(beg + lane);
+      YACL_ENFORCE(!exp.IsNegative(), "exponent must be non-negative, exp={}",
+                   exp);
+      exp_bytes[lane].assign(exp.ToMagBytes(nullptr, 0), 0);
+      exp.ToMagBytes(exp_bytes[lane].data(), exp_bytes[lane].size(),
+                     yacl::Endian::little);
+      exp_bits = std::max(exp_bits, exp.BitCount());
+    }
+
+    // split exponents into windows, most significant window first
+    size_t window_bits = WindowBits(exp_bits);
+    size_t num_windows =
+        std::max<size_t>((exp_bits + window_bits - 1) / window_bits, 1);
+    std::vector<Lanes> windows(num_windows, Lanes{});
+    for (size_t lane = 0; lane < width; ++lane) {
+      const auto &bytes = exp_bytes[lane];
+      for (size_t bit = 0; bit < bytes.size() * 8; ++bit) {
+        if ((bytes[bit / 8] >> (bit % 8)) & 1) {
+          windows[num_windows - 1 - bit / window_bits].v[lane] |=
+              uint64_t{1} << (bit % window_bits);
+        }
+      }
+    }
+
+    PowModLanes(base.data(), windows, window_bits, n_.data(), r2_.data(),
+                n0inv_, digits_, res.data());
+    for (size_t lane = 0; lane < width; ++lane) {
+      BigInt r = FromDigits(res.data(), digits_, lane);
+      if (r >= mod_) {
+        r -= mod_;
+      }
+      out[beg + lane] = std::move(r);
+    }
+  }
+}
+
+}  // namespace heu::lib::algorithms
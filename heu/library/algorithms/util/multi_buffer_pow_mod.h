@@ -0,0 +1,76 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "absl/types/span.h"
+
+#include "heu/library/algorithms/util/big_int.h"
+
+namespace heu::lib::algorithms {
+
+// Multi-buffer modular exponentiation: independent exponentiations that share
+// a modulus run together, one per SIMD lane.
+//
+// Numbers are kept in radix 2^52 and multiplied with the AVX-512 IFMA
+// instructions (VPMADD52LUQ/VPMADD52HUQ), 8 lanes per instruction. The engine
+// is only available if the CPU supports AVX-512 IFMA, which is detected at
+// runtime, so binaries built for generic x86-64 still use it.
+class MultiBufferPowMod {
+ public:
+  // Number of exponentiations processed together
+  static constexpr size_t kLanes = 8;
+
+  // Returns true if the CPU (and OS) support AVX-512 IFMA
+  static bool IsSupported();
+
+  // Returns nullptr if the engine is not supported on this CPU, or 'mod' is
+  // even or too large (> 8192 bits)
+  static std::unique_ptr<MultiBufferPowMod> Create(const BigInt &mod);
+
+  // out[i] = bases[i]^exps[i] mod m.
+  // Bases and exponents must be non-negative, bases do not need to be
+  // reduced. 'out' may be the same array as 'bases'
+  void PowMod(absl::Span<const BigInt> bases, absl::Span<const BigInt> exps,
+              absl::Span<BigInt> out) const;
+  // Same as above, but all bases share the exponent 'exp'
+  void PowMod(absl::Span<const BigInt> bases, const BigInt &exp,
+              absl::Span<BigInt> out) const;
+
+  const BigInt &Modulus() const { return mod_; }
+
+  // Digit i of all lanes, aligned for one 512-bit load
+  struct alignas(64) Lanes {
+    uint64_t v[kLanes];
+  };
+
+ private:
+  explicit MultiBufferPowMod(const BigInt &mod);
+
+  void PowModImpl(absl::Span<const BigInt> bases,
+                  const std::function<const BigInt &(size_t)> &exp_at,
+                  absl::Span<BigInt> out) const;
+
+  BigInt mod_;
+  size_t digits_;          // number of 52-bit digits, 4 * mod < 2^(52*digits)
+  uint64_t n0inv_;         // -mod^-1 mod 2^52
+  std::vector<Lanes> n_;   // mod, broadcast to all lanes
+  std::vector<Lanes> r2_;  // R^2 mod m, where R = 2^(52*digits)
+};
+
+}  // namespace heu::lib::algorithms
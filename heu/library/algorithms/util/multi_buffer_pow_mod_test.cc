@@ -0,0 +1,66 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "heu/library/algorithms/util/multi_buffer_pow_mod.h"
+
+#include "gtest/gtest.h"
+
+namespace heu::lib::algorithms::test {
+
+class MultiBufferPowModTest : public ::testing::TestWithParam<size_t> {};
+
+INSTANTIATE_TEST_SUITE_P(SubTest, MultiBufferPowModTest,
+                         ::testing::Values(1000, 2048, 4096));
+
+TEST_P(MultiBufferPowModTest, PowModWorks) {
+  BigInt mod = BigInt::RandomExactBits(GetParam());
+  if ((mod % BigInt(2)).IsZero()) {
+    mod += BigInt(1);
+  }
+  auto engine = MultiBufferPowMod::Create(mod);
+  if (!MultiBufferPowMod::IsSupported()) {
+    EXPECT_EQ(engine, nullptr);
+    GTEST_SKIP() << "AVX-512 IFMA is not supported";
+  }
+  ASSERT_NE(engine, nullptr);
+
+  // 19 items: two full groups and a partial one
+  std::vector<BigInt> bases = {BigInt(0), BigInt(1), mod - 1};
+  std::vector<BigInt> exps = {BigInt(3), BigInt(0), BigInt(2)};
+  for (int i = 0; i < 16; ++i) {
+    bases.push_back(BigInt::RandomExactBits(GetParam() + 10));
+    exps.push_back(BigInt::RandomExactBits(i * 100 + 1));
+  }
+
+  std::vector<BigInt> res(bases.size());
+  engine->PowMod(bases, exps, absl::MakeSpan(res));
+  for (size_t i = 0; i < bases.size(); ++i) {
+    EXPECT_EQ(res[i], (bases[i] % mod).PowMod(exps[i], mod)) << "i=" << i;
+  }
+
+  // shared exponent, in place
+  BigInt exp = BigInt::RandomExactBits(GetParam() / 2);
+  std::vector<BigInt> expected;
+  for (const auto &base : bases) {
+    expected.push_back((base % mod).PowMod(exp, mod));
+  }
+  engine->PowMod(bases, exp, absl::MakeSpan(bases));
+  EXPECT_EQ(bases, expected);
+}
+
+TEST_F(MultiBufferPowModTest, RejectsEvenModulus) {
+  EXPECT_EQ(MultiBufferPowMod::Create(BigInt(1) << 2048), nullptr);
+}
+
+}  // namespace heu::lib::algorithms::test
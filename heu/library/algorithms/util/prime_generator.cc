@@ -0,0 +1,216 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "heu/library/algorithms/util/prime_generator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <mutex>
+#include <vector>
+
+#include "yacl/utils/parallel.h"
+
+namespace heu::lib::algorithms {
+
+namespace {
+
+// Odd primes below this bound are used to sieve candidates
+constexpr uint32_t kSmallPrimeBound = 1 << 14;
+// Number of candidates sieved at once, candidate i is 'base + step * i'
+constexpr uint32_t kSieveWindow = 4096;
+// Small primes themselves may be candidates if bit_size is too small, so the
+// sieve is only enabled for large primes
+constexpr size_t kMinSieveBits = 64;
+
+// Small primes are grouped so that the product of each group fits in 64 bits,
+// thus we only need one bigint reduction per group.
+struct SmallPrimeGroup {
+  uint64_t product;
+  std::vector<uint32_t> primes;
+};
+
+const std::vector<SmallPrimeGroup> &SmallPrimeGroups() {
+  static const std::vector<SmallPrimeGroup> groups = [] {
+    std::vector<bool> composite(kSmallPrimeBound, false);
+    std::vector<SmallPrimeGroup> res;
+    SmallPrimeGroup group{1, {}};
+    // skip 2 since all candidates are odd
+    for (uint32_t i = 3; i < kSmallPrimeBound; i += 2) {
+      if (composite[i]) {
+        continue;
+      }
+      for (uint64_t j = static_cast<uint64_t>(i) * i; j < kSmallPrimeBound;
+           j += 2 * i) {
+        composite[j] = true;
+      }
+
+      if (group.product > std::numeric_limits<uint64_t>::max() / i) {
+        res.push_back(std::move(group));
+        group = SmallPrimeGroup{1, {}};
+      }
+      group.product *= i;
+      group.primes.push_back(i);
+    }
+    res.push_back(std::move(group));
+    return res;
+  }();
+  return groups;
+}
+
+uint64_t ModSmall(const BigInt &a, uint64_t m) {
+  return (a % BigInt(m)).Get<uint64_t>();
+}
+
+// Sieve one random window and test the survivors.
+// Returns false if the window is exhausted or the search is cancelled.
+bool SearchWindow(size_t bit_size, PrimeType prime_type,
+                  const std::atomic<bool> &stop, BigInt *out) {
+  if (bit_size < kMinSieveBits ||
+      (prime_type != PrimeType::Normal && prime_type != PrimeType::BBS)) {
+    // Safe primes need a different sieve, just race the default generator
+    *out = BigInt::RandPrimeOver(bit_size, prime_type);
+    return true;
+  }
+
+  // BBS primes are 3 mod 4, normal primes are only required to be odd
+  const uint64_t step = prime_type == PrimeType::BBS ? 4 : 2;
+  BigInt base = BigInt::RandomMonicExactBits(bit_size);
+  base += BigInt((step - 1 + step - ModSmall(base, step)) % step);
+
+  std::vector<uint8_t> composite(kSieveWindow, 0);
+  for (const auto &group : SmallPrimeGroups()) {
+    uint64_t r_group = ModSmall(base, group.product);
+    for (uint32_t sp : group.primes) {
+      // find the first i such that base + step * i = 0 (mod sp)
+      uint64_t inv_step = (sp + 1) / 2;  // 2^{-1} mod sp
+      if (step == 4) {
+        inv_step = inv_step * inv_step % sp;
+      }
+      uint64_t r = r_group % sp;
+      for (uint64_t i = (sp - r) % sp * inv_step % sp; i < kSieveWindow;
+           i += sp) {
+        composite[i] = 1;
+      }
+    }
+  }
+
+  for (uint32_t i = 0; i < kSieveWindow; ++i) {
+    if (composite[i]) {
+      continue;
+    }
+    if (stop.load(std::memory_order_relaxed)) {
+      return false;
+    }
+
+    BigInt candidate = base + BigInt(step * i);
+    if (candidate.BitCount() != bit_size) {
+      return false;
+    }
+    if (candidate.IsPrime()) {
+      *out = std::move(candidate);
+      return true;
+    }
+  }
+  return false;
+}
+
+// Calls 'round' on every thread until one of the rounds returns true.
+// A round must return soon after 'stop' is set.
+void RunUntilFound(
+    const std::function<bool(const std::atomic<bool> &stop)> &round) {
+  std::atomic<bool> stop{false};
+  int64_t workers = std::max(yacl::get_num_threads(), 1);
+  yacl::parallel_for(0, workers, 1, [&](int64_t, int64_t) {
+    while (!stop.load(std::memory_order_relaxed)) {
+      if (round(stop)) {
+        stop.store(true);
+      }
+    }
+  });
+}
+
+}  // namespace
+
+BigInt ParallelRandPrimeOver(size_t bit_size, PrimeType prime_type) {
+  std::mutex mutex;
+  BigInt res;
+  bool found = false;
+  RunUntilFound([&](const std::atomic<bool> &stop) {
+    BigInt prime;
+    if (!SearchWindow(bit_size, prime_type, stop, &prime)) {
+      return false;
+    }
+
+    std::lock_guard<std::mutex> guard(mutex);
+    if (!found) {
+      res = std::move(prime);
+      found = true;
+    }
+    return true;
+  });
+  return res;
+}
+
+std::pair<BigInt, BigInt> ParallelRandPrimePair(size_t bit_size,
+                                                PrimeType prime_type,
+                                                const PrimePairFilter &accept) {
+  std::mutex mutex;
+  std::vector<BigInt> primes;  // all primes found so far
+  std::pair<BigInt, BigInt> res;
+  bool found = false;
+  RunUntilFound([&](const std::atomic<bool> &stop) {
+    BigInt prime;
+    if (!SearchWindow(bit_size, prime_type, stop, &prime)) {
+      return false;
+    }
+
+    std::lock_guard<std::mutex> guard(mutex);
+    if (found) {
+      return true;
+    }
+    for (const auto &p : primes) {
+      if (accept(p, prime)) {
+        res = {p, std::move(prime)};
+        found = true;
+        return true;
+      }
+    }
+    primes.push_back(std::move(prime));
+    return false;
+  });
+  return res;
+}
+
+BigInt ParallelSearch(const std::function<bool(BigInt *out)> &trial) {
+  std::mutex mutex;
+  BigInt res;
+  bool found = false;
+  RunUntilFound([&](const std::atomic<bool> &) {
+    BigInt value;
+    if (!trial(&value)) {
+      return false;
+    }
+
+    std::lock_guard<std::mutex> guard(mutex);
+    if (!found) {
+      res = std::move(value);
+      found = true;
+    }
+    return true;
+  });
+  return res;
+}
+
+}  // namespace heu::lib::algorithms
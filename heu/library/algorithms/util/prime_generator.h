@@ -0,0 +1,52 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <functional>
+#include <utility>
+
+#include "heu/library/algorithms/util/big_int.h"
+
+// Parallel prime search engine used by key generators.
+//
+// Every worker thread of the yacl thread pool picks a random starting point,
+// sieves a window of candidates with small primes and runs the Miller-Rabin
+// test (BigInt::IsPrime) only on the survivors. The first worker that finds a
+// qualifying result cancels all the others.
+
+namespace heu::lib::algorithms {
+
+// Same contract as BigInt::RandPrimeOver(): returns a random prime of
+// 'bit_size' bits, but the search runs on all threads.
+BigInt ParallelRandPrimeOver(size_t bit_size,
+                             PrimeType prime_type = PrimeType::BBS);
+
+// Returns true if (p, q) is an acceptable prime pair.
+// The filter is called under a lock, it does not need to be thread safe.
+using PrimePairFilter = std::function<bool(const BigInt &p, const BigInt &q)>;
+
+// Searches two primes of 'bit_size' bits such that accept(p, q) == true.
+// Constraints are checked as soon as a new prime arrives, so the new prime is
+// paired with every prime found before instead of discarding the whole pair.
+std::pair<BigInt, BigInt> ParallelRandPrimePair(size_t bit_size,
+                                                PrimeType prime_type,
+                                                const PrimePairFilter &accept);
+
+// Runs 'trial' concurrently on all threads until one of them returns true,
+// then returns the value written by the winning trial.
+// 'trial' is called concurrently, so it must be thread safe.
+BigInt ParallelSearch(const std::function<bool(BigInt *out)> &trial);
+
+}  // namespace heu::lib::algorithms
@@ -0,0 +1,58 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "heu/library/algorithms/util/prime_generator.h"
+
+#include "gtest/gtest.h"
+
+namespace heu::lib::algorithms::test {
+
+class PrimeGeneratorTest : public ::testing::TestWithParam<size_t> {};
+
+INSTANTIATE_TEST_SUITE_P(SubTest, PrimeGeneratorTest,
+                         ::testing::Values(32, 160, 512, 1024));
+
+TEST_P(PrimeGeneratorTest, RandPrimeWorks) {
+  auto p = ParallelRandPrimeOver(GetParam(), PrimeType::Normal);
+  EXPECT_EQ(p.BitCount(), GetParam());
+  EXPECT_TRUE(p.IsPrime());
+
+  p = ParallelRandPrimeOver(GetParam(), PrimeType::BBS);
+  EXPECT_EQ(p.BitCount(), GetParam());
+  EXPECT_TRUE(p.IsPrime());
+  EXPECT_EQ(p % BigInt(4), BigInt(3));
+}
+
+TEST_P(PrimeGeneratorTest, PrimePairWorks) {
+  auto [p, q] = ParallelRandPrimePair(
+      GetParam(), PrimeType::BBS, [](const BigInt &a, const BigInt &b) {
+        return (a - 1).Gcd(b - 1) == 2;
+      });
+  EXPECT_TRUE(p.IsPrime());
+  EXPECT_TRUE(q.IsPrime());
+  EXPECT_NE(p, q);
+  EXPECT_EQ((p - 1).Gcd(q - 1), BigInt(2));
+}
+
+TEST(PrimeSearchTest, SearchWorks) {
+  BigInt factor = ParallelRandPrimeOver(160);
+  BigInt p = ParallelSearch([&](BigInt *out) {
+    *out = factor * BigInt::RandomMonicExactBits(352) + 1;
+    return out->IsPrime();
+  });
+  EXPECT_TRUE(p.IsPrime());
+  EXPECT_TRUE(((p - 1) % factor).IsZero());
+}
+
+}  // namespace heu::lib::algorithms::test
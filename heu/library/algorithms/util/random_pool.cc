@@ -0,0 +1,210 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "heu/library/algorithms/util/random_pool.h"
+
+#include <pthread.h>
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <thread>
+#include <utility>
+
+namespace heu::lib::algorithms {
+
+// The background thread shared by all RandomPools
+class RandomPoolFiller {
+ public:
+  // Leaked on purpose, pools may be destroyed after static destruction
+  static RandomPoolFiller &Instance() {
+    static auto *filler = new RandomPoolFiller();
+    return *filler;
+  }
+
+  void Register(RandomPool *pool) {
+    std::lock_guard<std::mutex> guard(mu_);
+    pools_.push_back(pool);
+  }
+
+  // Returns once the background thread does not touch 'pool' anymore
+  void Unregister(RandomPool *pool) {
+    std::unique_lock<std::mutex> lock(mu_);
+    pools_.erase(std::find(pools_.begin(), pools_.end(), pool));
+    requests_.erase(std::remove(requests_.begin(), requests_.end(), pool),
+                    requests_.end());
+    idle_cv_->wait(lock, [&] { return filling_ != pool; });
+  }
+
+  void RequestRefill(RandomPool *pool) {
+    {
+      std::lock_guard<std::mutex> guard(mu_);
+      if (pool->refill_requested_) {
+        return;
+      }
+      pool->refill_requested_ = true;
+      requests_.push_back(pool);
+      if (thread_ == nullptr) {
+        // runs until the process exits, never joined
+        thread_ = new std::thread([this] { FillLoop(); });
+      }
+    }
+    cv_->notify_one();
+  }
+
+ private:
+  RandomPoolFiller() {
+    pthread_atfork(&BeforeFork, &AfterForkInParent, &AfterForkInChild);
+  }
+
+  // Hold all locks across fork(), so the child gets consistent pools and
+  // unlocked mutexes
+  static void BeforeFork() {
+    auto &filler = Instance();
+    filler.mu_.lock();
+    for (auto *pool : filler.pools_) {
+      pool->mutex_.lock();
+    }
+  }
+
+  static void AfterForkInParent() {
+    auto &filler = Instance();
+    for (auto *pool : filler.pools_) {
+      pool->mutex_.unlock();
+    }
+    filler.mu_.unlock();
+  }
+
+  static void AfterForkInChild() {
+    auto &filler = Instance();
+    // The parent hands out the cached values too, reusing them in the child
+    // would encrypt with the same randomness as the parent
+    for (auto *pool : filler.pools_) {
+      pool->pool_.clear();
+      pool->refill_requested_ = false;
+      pool->mutex_.unlock();
+    }
+    filler.requests_.clear();
+    filler.filling_ = nullptr;
+    // Only the forking thread exists in the child. Abandon the objects the
+    // parent's filler thread was using, it is restarted on demand.
+    filler.thread_ = nullptr;
+    filler.cv_ = new std::condition_variable();
+    filler.idle_cv_ = new std::condition_variable();
+    filler.mu_.unlock();
+  }
+
+  void FillLoop() {
+    std::unique_lock<std::mutex> lock(mu_);
+    while (true) {
+      cv_->wait(lock, [this] { return !requests_.empty(); });
+      RandomPool *pool = requests_.front();
+      requests_.pop_front();
+      pool->refill_requested_ = false;
+      filling_ = pool;
+
+      lock.unlock();
+      Fill(pool);
+      lock.lock();
+
+      filling_ = nullptr;
+      idle_cv_->notify_all();
+    }
+  }
+
+  static void Fill(RandomPool *pool) {
+    while (true) {
+      {
+        std::lock_guard<std::mutex> guard(pool->mutex_);
+        if (pool->stop_ || pool->pool_.size() >= pool->capacity_) {
+          return;
+        }
+      }
+      BigInt value = pool->generator_();
+      std::lock_guard<std::mutex> guard(pool->mutex_);
+      pool->pool_.push_back(std::move(value));
+    }
+  }
+
+  std::mutex mu_;
+  // Pointers, so that a forked child can replace them, see AfterForkInChild()
+  std::condition_variable *cv_ = new std::condition_variable();
+  std::condition_variable *idle_cv_ = new std::condition_variable();
+  std::thread *thread_ = nullptr;
+
+  std::vector<RandomPool *> pools_;
+  std::deque<RandomPool *> requests_;
+  RandomPool *filling_ = nullptr;
+};
+
+RandomPool::RandomPool(Generator generator, size_t capacity)
+    : generator_(std::move(generator)), capacity_(capacity) {
+  pool_.reserve(capacity_);
+  RandomPoolFiller::Instance().Register(this);
+}
+
+RandomPool::~RandomPool() {
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    stop_ = true;
+  }
+  RandomPoolFiller::Instance().Unregister(this);
+}
+
+BigInt RandomPool::Get() {
+  BigInt res;
+  bool hit = false;
+  size_t left = 0;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (!pool_.empty()) {
+      res = std::move(pool_.back());
+      pool_.pop_back();
+      hit = true;
+      left = pool_.size();
+    }
+  }
+  // Refill only after half of the pool is consumed, so the filler does not
+  // wake up for every single Get()
+  if (left < capacity_ / 2 || !hit) {
+    RandomPoolFiller::Instance().RequestRefill(this);
+  }
+  if (!hit) {
+    return generator_();
+  }
+  return res;
+}
+
+std::vector<BigInt> RandomPool::Get(size_t size) {
+  std::vector<BigInt> res;
+  res.reserve(size);
+  size_t left = 0;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    while (res.size() < size && !pool_.empty()) {
+      res.push_back(std::move(pool_.back()));
+      pool_.pop_back();
+    }
+    left = pool_.size();
+  }
+  if (left < capacity_ / 2) {
+    RandomPoolFiller::Instance().RequestRefill(this);
+  }
+  while (res.size() < size) {
+    res.push_back(generator_());
+  }
+  return res;
+}
+
+}  // namespace heu::lib::algorithms
@@ -0,0 +1,69 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include "heu/library/algorithms/util/big_int.h"
+
+namespace heu::lib::algorithms {
+
+class RandomPoolFiller;
+
+// Caches the output of an expensive random generator, such as the blinding
+// factor h^r of Paillier-like schemes.
+//
+// All pools of the process are refilled by one shared background thread,
+// which is started by the first Get() call, so objects that never consume
+// randomness (e.g. a deserialized public key only used for evaluation) cost
+// nothing and many keys do not mean many threads.
+// If the pool is drained, Get() falls back to calling the generator in the
+// caller's thread, so a consumer never waits for the background thread.
+//
+// Fork safe: the cached values are dropped in a forked child, so parent and
+// child never hand out the same random value, and the child restarts the
+// background thread on demand.
+class RandomPool {
+ public:
+  using Generator = std::function<BigInt()>;
+
+  // 'generator' must be thread safe
+  RandomPool(Generator generator, size_t capacity);
+  ~RandomPool();
+
+  RandomPool(const RandomPool &) = delete;
+  RandomPool &operator=(const RandomPool &) = delete;
+
+  BigInt Get();
+  // Takes 'size' values at once, with only one lock acquisition.
+  std::vector<BigInt> Get(size_t size);
+
+ private:
+  friend class RandomPoolFiller;
+
+  const Generator generator_;
+  const size_t capacity_;
+
+  std::mutex mutex_;
+  std::vector<BigInt> pool_;
+  bool stop_ = false;  // set by the destructor
+
+  // guarded by the filler's mutex
+  bool refill_requested_ = false;
+};
+
+}  // namespace heu::lib::algorithms
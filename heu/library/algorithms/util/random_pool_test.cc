@@ -0,0 +1,114 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "heu/library/algorithms/util/random_pool.h"
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+namespace heu::lib::algorithms::test {
+
+TEST(RandomPoolTest, GetWorks) {
+  std::atomic<int64_t> counter{0};
+  {
+    RandomPool pool([&] { return BigInt(++counter); }, 64);
+    std::vector<BigInt> values;
+    for (int i = 0; i < 100; ++i) {
+      values.push_back(pool.Get());
+    }
+    auto batch = pool.Get(200);
+    EXPECT_EQ(batch.size(), 200U);
+    values.insert(values.end(), batch.begin(), batch.end());
+
+    // every value is generated exactly once
+    std::sort(values.begin(), values.end());
+    for (size_t i = 1; i < values.size(); ++i) {
+      EXPECT_NE(values[i - 1], values[i]);
+    }
+  }
+  // the filler thread is stopped when the pool is destroyed
+  EXPECT_GE(counter.load(), 300);
+}
+
+TEST(RandomPoolTest, UnusedPoolWorks) {
+  bool called = false;
+  {
+    RandomPool pool(
+        [&] {
+          called = true;
+          return BigInt(1);
+        },
+        16);
+  }
+  EXPECT_FALSE(called);
+}
+
+TEST(RandomPoolTest, PoolsShareOneFiller) {
+  std::atomic<int64_t> counter{0};
+  std::vector<std::unique_ptr<RandomPool>> pools;
+  for (int i = 0; i < 16; ++i) {
+    pools.push_back(
+        std::make_unique<RandomPool>([&] { return BigInt(++counter); }, 8));
+  }
+  for (auto &pool : pools) {
+    pool->Get(8);
+  }
+  // destroying pools that are being refilled is safe
+  pools.clear();
+  EXPECT_GE(counter.load(), 16 * 8);
+}
+
+TEST(RandomPoolTest, ForkedChildDropsCachedValues) {
+  std::atomic<int64_t> calls{0};
+  // tag every value with the pid of the generating process
+  RandomPool pool(
+      [&] {
+        ++calls;
+        return BigInt(static_cast<int64_t>(getpid()));
+      },
+      64);
+  pool.Get();
+  // wait for the background thread to cache some values
+  for (int i = 0; i < 100 && calls.load() < 32; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  pid_t child = fork();
+  ASSERT_GE(child, 0);
+  if (child == 0) {
+    auto self = BigInt(static_cast<int64_t>(getpid()));
+    bool ok = pool.Get() == self;
+    for (const auto &v : pool.Get(100)) {
+      ok = ok && v == self;
+    }
+    _exit(ok ? 0 : 1);
+  }
+
+  int status = 0;
+  ASSERT_EQ(waitpid(child, &status, 0), child);
+  ASSERT_TRUE(WIFEXITED(status));
+  EXPECT_EQ(WEXITSTATUS(status), 0)
+      << "forked child reused values cached by the parent";
+  // the parent keeps its own values
+  EXPECT_EQ(pool.Get(), BigInt(static_cast<int64_t>(getpid())));
+}
+
+}  // namespace heu::lib::algorithms::test
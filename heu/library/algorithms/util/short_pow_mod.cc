@@ -0,0 +1,40 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "heu/library/algorithms/util/short_pow_mod.h"
+
+namespace heu::lib::algorithms {
+
+BigInt ShortPowMod(const MontgomerySpace &m_space, const BigInt &base,
+                   uint64_t exp) {
+  if (exp == 0) {
+    return m_space.Identity();
+  }
+
+  int top = 63;
+  while (((exp >> top) & 1) == 0) {
+    --top;
+  }
+
+  BigInt res(base);
+  for (int i = top - 1; i >= 0; --i) {
+    res = m_space.MulMod(res, res);
+    if ((exp >> i) & 1) {
+      res = m_space.MulMod(res, base);
+    }
+  }
+  return res;
+}
+
+}  // namespace heu::lib::algorithms
@@ -0,0 +1,34 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+
+#include "heu/library/algorithms/util/big_int.h"
+
+namespace heu::lib::algorithms {
+
+// Exponents up to this many bits go through ShortPowMod()
+inline constexpr size_t kShortExpBits = 32;
+
+// Returns base^exp, where 'base' and the result are both in Montgomery form.
+//
+// Meant for small multipliers such as encoded int64 scalars: plain binary
+// square-and-multiply needs at most 2 * log2(exp) MulMod and skips the
+// Z-space round trip and window precomputation of a generic PowMod.
+BigInt ShortPowMod(const MontgomerySpace &m_space, const BigInt &base,
+                   uint64_t exp);
+
+}  // namespace heu::lib::algorithms
@@ -0,0 +1,52 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "heu/library/algorithms/util/short_pow_mod.h"
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace heu::lib::algorithms::test {
+
+class ShortPowModTest : public ::testing::TestWithParam<size_t> {};
+
+INSTANTIATE_TEST_SUITE_P(SubTest, ShortPowModTest,
+                         ::testing::Values(1024, 2048, 4096));
+
+TEST_P(ShortPowModTest, MatchesPowMod) {
+  BigInt mod = BigInt::RandomExactBits(GetParam());
+  if ((mod % BigInt(2)).IsZero()) {
+    mod += BigInt(1);
+  }
+  auto m_space = BigInt::CreateMontgomerySpace(mod);
+
+  std::vector<uint64_t> exps = {0, 1, 2, 3, 255, 256, 65537, 104729,
+                                std::numeric_limits<uint32_t>::max(),
+                                std::numeric_limits<uint64_t>::max()};
+  for (int i = 0; i < 3; ++i) {
+    BigInt base = BigInt::RandomLtN(mod);
+    BigInt base_mont(base);
+    m_space->MapIntoMSpace(base_mont);
+    for (uint64_t exp : exps) {
+      BigInt res = ShortPowMod(*m_space, base_mont, exp);
+      m_space->MapBackToZSpace(res);
+      EXPECT_EQ(res, base.PowMod(BigInt(exp), mod)) << "exp=" << exp;
+    }
+  }
+}
+
+}  // namespace heu::lib::algorithms::test
@@ -14,17 +14,42 @@
 
 #pragma once
 
+#include <type_traits>
+
 #include "absl/types/span.h"
 #include "yacl/utils/spi/type_traits.h"
 
 namespace heu::lib::algorithms {
 
+// Vectorized SPI takes spans of pointers, so that callers holding elements
+// inside other containers (e.g. numpy matrices of variants) do not need to copy
+// them into a contiguous buffer.
 template <typename T>
 using Span = absl::Span<T *const>;
 
 template <typename T>
 using ConstSpan = absl::Span<const T *const>;
 
+// Contiguous variants of the above. Algorithms may additionally provide
+// overloads that write results into a caller-provided DenseSpan instead of
+// returning a std::vector, and that read a ConstDenseSpan when the caller
+// holds the inputs contiguously, e.g. in a scratch buffer reused across calls.
+template <typename T>
+using DenseSpan = absl::Span<T>;
+
+template <typename T>
+using ConstDenseSpan = absl::Span<const T>;
+
+// Element access shared by the pointer and the contiguous overloads
+template <typename T>
+const auto &Deref(const T &v) {
+  if constexpr (std::is_pointer_v<T>) {
+    return *v;
+  } else {
+    return v;
+  }
+}
+
 using yacl::Endian;
 
 }  // namespace heu::lib::algorithms
@@ -0,0 +1,359 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Throughput, latency and scaling of phe/numpy ops over thread count, batch
+// size and key size.
+//
+// For every (schema, key size, op, batch, threads) case it reports:
+//   ops/s       total throughput
+//   ops/s/core  throughput divided by the number of threads
+//   p50/p90/p99 latency of a single op in microseconds (phe ops only)
+//   efficiency  ops/s / (threads * ops/s of the same op with 1 thread)
+//
+// The phe ops split the batch over 'threads' std::threads, each running the
+// op serially, so the sweep measures how the schema itself scales with cores.
+// The numpy ops use the yacl thread pool, whose size is fixed per process,
+// so they are swept over batch size only and compared with the 1 thread phe
+// baseline of the same op.
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "absl/strings/str_split.h"
+#include "benchmark/benchmark.h"
+#include "fmt/ranges.h"
+#include "gflags/gflags.h"
+#include "yacl/utils/parallel.h"
+
+#include "heu/library/numpy/numpy.h"
+#include "heu/library/phe/encoding/encoding.h"
+#include "heu/library/phe/phe.h"
+
+namespace heu::lib::bench {
+
+constexpr int kRandomScale = 8011;
+
+// A reusable barrier for 'parties' threads (std::barrier is C++20)
+class Barrier {
+ public:
+  explicit Barrier(int64_t parties) : parties_(parties) {}
+
+  void Wait() {
+    std::unique_lock<std::mutex> lock(mu_);
+    auto generation = generation_;
+    if (++arrived_ == parties_) {
+      arrived_ = 0;
+      ++generation_;
+      cv_.notify_all();
+      return;
+    }
+    cv_.wait(lock, [&]() { return generation != generation_; });
+  }
+
+ private:
+  std::mutex mu_;
+  std::condition_variable cv_;
+  const int64_t parties_;
+  int64_t arrived_ = 0;
+  uint64_t generation_ = 0;
+};
+
+class ScalingBenchmarks {
+ public:
+  void SetupAndRegister(phe::SchemaType schema_type, int key_size,
+                        const std::vector<int64_t> &batch_sizes,
+                        const std::vector<int64_t> &threads) {
+    he_kit_ = std::make_unique<phe::HeKit>(schema_type, key_size);
+    np_kit_ = std::make_unique<numpy::HeKit>(*he_kit_);
+    key_size_ = key_size;
+
+    auto max_batch = *std::max_element(batch_sizes.begin(), batch_sizes.end());
+    auto edr = he_kit_->GetEncoder<phe::PlainEncoder>(kRandomScale);
+    pts_ = numpy::PMatrix(max_batch);
+    cts_ = numpy::CMatrix(max_batch);
+    yacl::parallel_for(0, max_batch, 1, [&](int64_t beg, int64_t end) {
+      for (int64_t i = beg; i < end; ++i) {
+        pts_(i) = edr.Encode(i);
+        cts_(i) = he_kit_->GetEncryptor()->Encrypt(pts_(i));
+      }
+    });
+    out_cts_ = numpy::CMatrix(max_batch);
+    out_pts_ = numpy::PMatrix(max_batch);
+
+    const auto &encryptor = he_kit_->GetEncryptor();
+    const auto &evaluator = he_kit_->GetEvaluator();
+    const auto &decryptor = he_kit_->GetDecryptor();
+    RegisterPhe("Encrypt", batch_sizes, threads, [this, encryptor](int64_t i) {
+      out_cts_(i) = encryptor->Encrypt(pts_(i));
+    });
+    RegisterPhe("CT+CT", batch_sizes, threads, [this, evaluator](int64_t i) {
+      out_cts_(i) = evaluator->Add(cts_(i), cts_(i));
+    });
+    RegisterPhe("CT*PT", batch_sizes, threads, [this, evaluator](int64_t i) {
+      out_cts_(i) = evaluator->Mul(cts_(i), pts_(i));
+    });
+    RegisterPhe("Decrypt", batch_sizes, threads, [this, decryptor](int64_t i) {
+      decryptor->Decrypt(cts_(i), &out_pts_(i));
+    });
+
+    RegisterNumpy("Encrypt", batch_sizes,
+                  [this](const numpy::PMatrix &pts, const numpy::CMatrix &) {
+                    benchmark::DoNotOptimize(
+                        np_kit_->GetEncryptor()->Encrypt(pts));
+                  });
+    RegisterNumpy("CT+CT", batch_sizes,
+                  [this](const numpy::PMatrix &, const numpy::CMatrix &cts) {
+                    benchmark::DoNotOptimize(
+                        np_kit_->GetEvaluator()->Add(cts, cts));
+                  });
+    RegisterNumpy("CT*PT", batch_sizes,
+                  [this](const numpy::PMatrix &pts, const numpy::CMatrix &cts) {
+                    benchmark::DoNotOptimize(
+                        np_kit_->GetEvaluator()->Mul(cts, pts));
+                  });
+    RegisterNumpy("Decrypt", batch_sizes,
+                  [this](const numpy::PMatrix &, const numpy::CMatrix &cts) {
+                    benchmark::DoNotOptimize(
+                        np_kit_->GetDecryptor()->Decrypt(cts));
+                  });
+  }
+
+ private:
+  using BaselineKey = std::tuple<std::string, int64_t>;
+  using NumpyFn =
+      std::function<void(const numpy::PMatrix &, const numpy::CMatrix &)>;
+
+  std::string Name(const std::string &layer, const std::string &op) const {
+    return fmt::format("{:^9}|{}|{}|key={}", he_kit_->GetSchemaType(), layer,
+                       op, key_size_);
+  }
+
+  void RegisterPhe(const std::string &op, const std::vector<int64_t> &batches,
+                   const std::vector<int64_t> &threads,
+                   std::function<void(int64_t)> fn) {
+    auto *bm = benchmark::RegisterBenchmark(
+        Name("phe", op).c_str(),
+        [this, op, fn](benchmark::State &st) { RunPhe(st, op, fn); });
+    // cases run in the order of registration, so the 1 thread baselines are
+    // measured before the other thread counts
+    for (auto t : threads) {
+      for (auto batch : batches) {
+        bm->Args({batch, t});
+      }
+    }
+    bm->ArgNames({"batch", "threads"})
+        ->UseManualTime()
+        ->Unit(benchmark::kMillisecond);
+  }
+
+  void RegisterNumpy(const std::string &op,
+                     const std::vector<int64_t> &batches, NumpyFn fn) {
+    benchmark::RegisterBenchmark(
+        Name("numpy", op).c_str(),
+        [this, op, fn](benchmark::State &st) { RunNumpy(st, op, fn); })
+        ->ArgsProduct({batches})
+        ->ArgNames({"batch"})
+        ->UseManualTime()
+        ->Unit(benchmark::kMillisecond);
+  }
+
+  void RunPhe(benchmark::State &state, const std::string &op,
+              const std::function<void(int64_t)> &fn) {
+    std::call_once(flag_, []() { fmt::print("{:-^80}\n", ""); });
+    auto batch = state.range(0);
+    auto n_threads = state.range(1);
+
+    // The workers are started once per case and parked at the barrier, so
+    // thread creation is not timed. Each iteration passes three phases: all
+    // workers parked, released (the clock starts just before) and all done.
+    Barrier barrier(n_threads + 1);
+    bool stop = false;
+    // latencies of the current iteration, one slot per element
+    std::vector<std::vector<int64_t>> latencies(n_threads);
+    std::vector<std::thread> workers;
+    for (int64_t t = 0; t < n_threads; ++t) {
+      auto begin = batch * t / n_threads;
+      auto end = batch * (t + 1) / n_threads;
+      latencies[t].resize(end - begin);
+      workers.emplace_back([&, t, begin, end]() {
+        auto &lat = latencies[t];
+        while (true) {
+          barrier.Wait();
+          if (stop) {
+            break;
+          }
+          barrier.Wait();
+          for (int64_t i = begin; i < end; ++i) {
+            auto tick = std::chrono::steady_clock::now();
+            fn(i);
+            lat[i - begin] =
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - tick)
+                    .count();
+          }
+          barrier.Wait();
+        }
+      });
+    }
+
+    std::vector<int64_t> all;
+    double seconds = 0;
+    for (auto _ : state) {
+      barrier.Wait();
+      auto start = std::chrono::steady_clock::now();
+      barrier.Wait();
+      barrier.Wait();
+      std::chrono::duration<double> elapsed =
+          std::chrono::steady_clock::now() - start;
+      state.SetIterationTime(elapsed.count());
+      seconds += elapsed.count();
+
+      for (const auto &lat : latencies) {
+        all.insert(all.end(), lat.begin(), lat.end());
+      }
+    }
+    stop = true;
+    barrier.Wait();
+    for (auto &worker : workers) {
+      worker.join();
+    }
+
+    const std::pair<const char *, double> percentiles[] = {
+        {"p50_us", 0.5}, {"p90_us", 0.9}, {"p99_us", 0.99}};
+    for (const auto &[name, q] : percentiles) {
+      if (all.empty()) {
+        break;
+      }
+      auto nth = all.begin() + static_cast<int64_t>(q * (all.size() - 1));
+      std::nth_element(all.begin(), nth, all.end());
+      state.counters[name] = *nth / 1e3;
+    }
+    Report(state, op, batch, n_threads, seconds);
+  }
+
+  void RunNumpy(benchmark::State &state, const std::string &op,
+                const NumpyFn &fn) {
+    auto batch = state.range(0);
+    auto pts = numpy::PMatrixView(pts_).Slice({0, batch}).Materialize();
+    auto cts = numpy::CMatrixView(cts_).Slice({0, batch}).Materialize();
+    double seconds = 0;
+    for (auto _ : state) {
+      auto start = std::chrono::steady_clock::now();
+      fn(pts, cts);
+      std::chrono::duration<double> elapsed =
+          std::chrono::steady_clock::now() - start;
+      state.SetIterationTime(elapsed.count());
+      seconds += elapsed.count();
+    }
+    Report(state, op, batch, yacl::get_num_threads(), seconds);
+  }
+
+  void Report(benchmark::State &state, const std::string &op, int64_t batch,
+              int64_t n_threads, double seconds) {
+    if (seconds <= 0) {
+      return;
+    }
+    double rate = batch * state.iterations() / seconds;
+    state.counters["threads"] = n_threads;
+    state.counters["ops/s"] = rate;
+    state.counters["ops/s/core"] = rate / n_threads;
+
+    BaselineKey key{op, batch};
+    if (n_threads == 1 && baselines_.count(key) == 0) {
+      baselines_[key] = rate;
+    }
+    auto it = baselines_.find(key);
+    if (it != baselines_.end()) {
+      state.counters["efficiency"] = rate / (n_threads * it->second);
+    }
+  }
+
+  std::once_flag flag_;
+  std::unique_ptr<phe::HeKit> he_kit_;
+  std::unique_ptr<numpy::HeKit> np_kit_;
+  int key_size_ = 0;
+  numpy::PMatrix pts_{1};
+  numpy::CMatrix cts_{1};
+  numpy::PMatrix out_pts_{1};
+  numpy::CMatrix out_cts_{1};
+  // 1 thread phe throughput of (op, batch)
+  std::map<BaselineKey, double> baselines_;
+};
+
+std::vector<int64_t> ParseList(const std::string &list) {
+  std::vector<int64_t> res;
+  for (auto item : absl::StrSplit(list, ',', absl::SkipEmpty())) {
+    res.push_back(std::stoll(std::string(item)));
+  }
+  return res;
+}
+
+// 1, 2, 4, ... up to max_threads, max_threads itself included
+std::vector<int64_t> ThreadSweep(int64_t max_threads) {
+  std::vector<int64_t> res;
+  for (int64_t t = 1; t < max_threads; t *= 2) {
+    res.push_back(t);
+  }
+  res.push_back(max_threads);
+  return res;
+}
+
+}  // namespace heu::lib::bench
+
+DEFINE_string(schema, ".+", "Run selected schemas, default to all.");
+DEFINE_string(key_sizes, "2048", "Comma separated key sizes to sweep.");
+DEFINE_string(batch_sizes, "1000,10000",
+              "Comma separated batch sizes to sweep.");
+DEFINE_int32(max_threads, 0,
+             "Max number of threads to sweep, default to all cores.");
+
+int main(int argc, char **argv) {
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  benchmark::Initialize(&argc, argv);
+
+  auto key_sizes = heu::lib::bench::ParseList(FLAGS_key_sizes);
+  auto batch_sizes = heu::lib::bench::ParseList(FLAGS_batch_sizes);
+  int64_t max_threads = FLAGS_max_threads > 0
+                            ? FLAGS_max_threads
+                            : std::max(std::thread::hardware_concurrency(), 1U);
+  auto threads = heu::lib::bench::ThreadSweep(max_threads);
+  benchmark::AddCustomContext("Key sizes", FLAGS_key_sizes);
+  benchmark::AddCustomContext("Batch sizes", FLAGS_batch_sizes);
+  benchmark::AddCustomContext("Threads", fmt::format("{}", threads));
+  benchmark::AddCustomContext(
+      "Numpy threads", fmt::format("{}", yacl::get_num_threads()));
+
+  auto schemas = heu::lib::phe::SelectSchemas(FLAGS_schema);
+  fmt::print("Schemas to bench: {}\n", schemas);
+  std::vector<heu::lib::bench::ScalingBenchmarks> bms(schemas.size() *
+                                                       key_sizes.size());
+  for (size_t i = 0; i < schemas.size(); ++i) {
+    for (size_t j = 0; j < key_sizes.size(); ++j) {
+      bms[i * key_sizes.size() + j].SetupAndRegister(
+          schemas[i], key_sizes[j], batch_sizes, threads);
+    }
+  }
+
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
@@ -0,0 +1,303 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Throughput of the serialization paths: Ciphertext, DenseMatrix in both
+// MatrixSerializeFormat and the keys of HeKit.
+//
+// Besides the time, every case reports:
+//   bytes_per_second  serialized bytes written or parsed per second
+//   allocs/elem       heap allocations per element made by the benchmark
+//                     thread (glibc only)
+//   peak_rss_mb       peak resident memory of the process during the case
+//                     (Linux only)
+//
+// Python pickling is covered by serialize_bench.py in the same directory.
+
+#include <cerrno>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "fmt/ranges.h"
+#include "gflags/gflags.h"
+
+#include "heu/library/numpy/numpy.h"
+#include "heu/library/phe/encoding/encoding.h"
+#include "heu/library/phe/phe.h"
+
+namespace heu::lib::bench {
+
+// Only the allocations of the thread running a case are counted, so those of
+// background threads, e.g. the DJ randomness filler, do not pollute the
+// numbers. Work handed to the yacl thread pool is not counted either.
+thread_local bool t_count_allocs = false;
+thread_local int64_t t_num_allocs = 0;
+
+inline void CountAlloc() {
+  if (t_count_allocs) {
+    ++t_num_allocs;
+  }
+}
+
+}  // namespace heu::lib::bench
+
+// Count the heap allocations by interposing the glibc allocator, operator
+// new (including the over-aligned one) ends up here too.
+#if defined(__GLIBC__) && !defined(__SANITIZE_ADDRESS__)
+#define HEU_BENCH_COUNT_ALLOCS 1
+
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t num, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+void *__libc_memalign(size_t alignment, size_t size);
+
+void *malloc(size_t size) noexcept {
+  heu::lib::bench::CountAlloc();
+  return __libc_malloc(size);
+}
+
+void *calloc(size_t num, size_t size) noexcept {
+  heu::lib::bench::CountAlloc();
+  return __libc_calloc(num, size);
+}
+
+void *realloc(void *ptr, size_t size) noexcept {
+  heu::lib::bench::CountAlloc();
+  return __libc_realloc(ptr, size);
+}
+
+void *memalign(size_t alignment, size_t size) noexcept {
+  heu::lib::bench::CountAlloc();
+  return __libc_memalign(alignment, size);
+}
+
+void *aligned_alloc(size_t alignment, size_t size) noexcept {
+  heu::lib::bench::CountAlloc();
+  return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void **ptr, size_t alignment, size_t size) noexcept {
+  if (alignment % sizeof(void *) != 0 ||
+      (alignment & (alignment - 1)) != 0) {
+    return EINVAL;
+  }
+  heu::lib::bench::CountAlloc();
+  void *res = __libc_memalign(alignment, size);
+  if (res == nullptr) {
+    return ENOMEM;
+  }
+  *ptr = res;
+  return 0;
+}
+}
+#else
+#define HEU_BENCH_COUNT_ALLOCS 0
+#endif
+
+namespace heu::lib::bench {
+
+constexpr int kRandomScale = 8011;
+
+// Reset the peak resident memory (VmHWM) of the process, Linux 4.0+
+bool ResetPeakRss() {
+  std::ofstream clear_refs("/proc/self/clear_refs");
+  clear_refs << "5";
+  clear_refs.flush();
+  return clear_refs.good();
+}
+
+// The peak resident memory in kilobytes, or -1 if unknown
+int64_t ReadPeakRssKb() {
+  std::ifstream status("/proc/self/status");
+  std::string key;
+  while (status >> key) {
+    if (key == "VmHWM:") {
+      int64_t kb;
+      return status >> kb ? kb : -1;
+    }
+    status.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+  }
+  return -1;
+}
+
+class SerializeBenchmarks {
+ public:
+  void SetupAndRegister(phe::SchemaType schema_type, int key_size) {
+    he_kit_ = std::make_unique<phe::HeKit>(schema_type, key_size);
+    auto np_kit = numpy::HeKit(*he_kit_);
+    auto edr = he_kit_->GetEncoder<phe::PlainEncoder>(kRandomScale);
+    for (const auto &shape : {numpy::Shape{1024}, numpy::Shape{256, 32}}) {
+      numpy::PMatrix pts(shape);
+      pts.ForEach([&](int64_t row, int64_t col, phe::Plaintext *pt) {
+        *pt = edr.Encode(row * 1000 + col);
+      });
+      ct_matrixs_.push_back(np_kit.GetEncryptor()->Encrypt(pts));
+    }
+
+    // single ciphertexts
+    const auto &cts = ct_matrixs_[0];
+    std::vector<yacl::Buffer> ct_bufs(cts.size());
+    for (int64_t i = 0; i < cts.size(); ++i) {
+      ct_bufs[i] = cts.data()[i].Serialize();
+    }
+    Register(fmt::format("Ciphertext.Serialize(n={})", cts.size()),
+             cts.size(), [&cts]() {
+               size_t bytes = 0;
+               for (int64_t i = 0; i < cts.size(); ++i) {
+                 auto buf = cts.data()[i].Serialize();
+                 bytes += buf.size();
+                 benchmark::DoNotOptimize(buf);
+               }
+               return bytes;
+             });
+    Register(fmt::format("Ciphertext.Deserialize(n={})", cts.size()),
+             cts.size(), [ct_bufs]() {
+               size_t bytes = 0;
+               for (const auto &buf : ct_bufs) {
+                 phe::Ciphertext ct;
+                 ct.Deserialize(buf);
+                 bytes += buf.size();
+                 benchmark::DoNotOptimize(ct);
+               }
+               return bytes;
+             });
+
+    // matrices
+    for (const auto &m : ct_matrixs_) {
+      for (auto format : {numpy::MatrixSerializeFormat::Best,
+                          numpy::MatrixSerializeFormat::Interconnection}) {
+        auto name = fmt::format(
+            "(shape={},format={})", m.shape().ToString(),
+            format == numpy::MatrixSerializeFormat::Best ? "Best" : "Ic");
+        yacl::Buffer buf;
+        try {
+          buf = m.Serialize(format);
+        } catch (const std::exception &e) {
+          fmt::print("Skip CMatrix{} of {}: {}\n", name,
+                     he_kit_->GetSchemaType(), e.what());
+          continue;
+        }
+        Register("CMatrix.Serialize" + name, m.size(), [&m, format]() {
+          auto buf = m.Serialize(format);
+          benchmark::DoNotOptimize(buf);
+          return static_cast<size_t>(buf.size());
+        });
+        Register("CMatrix.LoadFrom" + name, m.size(), [buf, format]() {
+          benchmark::DoNotOptimize(numpy::CMatrix::LoadFrom(buf, format));
+          return static_cast<size_t>(buf.size());
+        });
+      }
+    }
+
+    // keys
+    auto pk_buf = he_kit_->GetPublicKey()->Serialize();
+    auto sk_buf = he_kit_->GetSecretKey()->Serialize();
+    Register("PublicKey.Serialize", 1, [this]() {
+      return static_cast<size_t>(he_kit_->GetPublicKey()->Serialize().size());
+    });
+    Register("PublicKey.Deserialize", 1, [pk_buf]() {
+      phe::PublicKey pk;
+      pk.Deserialize(pk_buf);
+      benchmark::DoNotOptimize(pk);
+      return static_cast<size_t>(pk_buf.size());
+    });
+    Register("SecretKey.Serialize", 1, [this]() {
+      return static_cast<size_t>(he_kit_->GetSecretKey()->Serialize().size());
+    });
+    Register("SecretKey.Deserialize", 1, [sk_buf]() {
+      phe::SecretKey sk;
+      sk.Deserialize(sk_buf);
+      benchmark::DoNotOptimize(sk);
+      return static_cast<size_t>(sk_buf.size());
+    });
+    // a full HeKit setup from the serialized keys, as a receiving party does
+    Register("HeKit.Load", 1, [pk_buf, sk_buf]() {
+      phe::HeKit kit(pk_buf, sk_buf);
+      benchmark::DoNotOptimize(kit);
+      return static_cast<size_t>(pk_buf.size() + sk_buf.size());
+    });
+  }
+
+ private:
+  // 'round' handles 'elements' elements once and returns the number of
+  // serialized bytes written or parsed
+  void Register(const std::string &name, int64_t elements,
+                std::function<size_t()> round) {
+    benchmark::RegisterBenchmark(
+        fmt::format("{:^9}|{}", he_kit_->GetSchemaType(), name).c_str(),
+        [this, elements, round](benchmark::State &st) {
+          Run(st, elements, round);
+        })
+        ->Unit(benchmark::kMicrosecond);
+  }
+
+  void Run(benchmark::State &state, int64_t elements,
+           const std::function<size_t()> &round) {
+    std::call_once(flag_, []() { fmt::print("{:-^80}\n", ""); });
+    bool rss_reset = ResetPeakRss();
+    int64_t bytes = 0;
+    t_num_allocs = 0;
+    t_count_allocs = true;
+    for (auto _ : state) {
+      bytes += round();
+    }
+    t_count_allocs = false;
+    auto allocs = t_num_allocs;
+
+    state.SetBytesProcessed(bytes);
+    state.SetItemsProcessed(elements * state.iterations());
+    if (HEU_BENCH_COUNT_ALLOCS && state.iterations() > 0) {
+      state.counters["allocs/elem"] =
+          static_cast<double>(allocs) / (elements * state.iterations());
+    }
+    auto peak_rss_kb = ReadPeakRssKb();
+    if (rss_reset && peak_rss_kb >= 0) {
+      state.counters["peak_rss_mb"] = peak_rss_kb / 1024.0;
+    }
+  }
+
+  std::once_flag flag_;
+  std::unique_ptr<phe::HeKit> he_kit_;
+  std::vector<numpy::CMatrix> ct_matrixs_;
+};
+
+}  // namespace heu::lib::bench
+
+DEFINE_string(schema, ".+", "Run selected schemas, default to all.");
+DEFINE_int32(key_size, 2048, "Key size of phe schema.");
+
+int main(int argc, char **argv) {
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  benchmark::Initialize(&argc, argv);
+  benchmark::AddCustomContext("Key size", fmt::format("{}", FLAGS_key_size));
+  benchmark::AddCustomContext("Count allocations",
+                              HEU_BENCH_COUNT_ALLOCS ? "yes" : "no");
+
+  auto schemas = heu::lib::phe::SelectSchemas(FLAGS_schema);
+  fmt::print("Schemas to bench: {}\n", schemas);
+  std::vector<heu::lib::bench::SerializeBenchmarks> bms(schemas.size());
+  for (size_t i = 0; i < schemas.size(); ++i) {
+    bms[i].SetupAndRegister(schemas[i], FLAGS_key_size);
+  }
+
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
@@ -0,0 +1,153 @@
+#  Copyright 2024 Ant Group Co., Ltd.
+#
+#  Licensed under the Apache License, Version 2.0 (the "License");
+#  you may not use this file except in compliance with the License.
+#  You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+#  Unless required by applicable law or agreed to in writing, software
+#  distributed under the License is distributed on an "AS IS" BASIS,
+#  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#  See the License for the specific language governing permissions and
+#  limitations under the License.
+
+# Throughput of pickling HEU arrays, the python counterpart of
+# serialize_bench.cc. Needs the heu and google-benchmark pip packages:
+#   python serialize_bench.py --schema=zpaillier --benchmark_counters_tabular=true
+
+import argparse
+import pickle
+import re
+import sys
+
+import google_benchmark as benchmark
+import numpy as np
+
+from heu import numpy as hnp
+from heu import phe
+
+K_KEY_SIZE = 2048
+K_SHAPES = [(1024,), (256, 32)]
+
+
+def reset_peak_rss():
+    """Reset the peak resident memory (VmHWM) of the process, Linux 4.0+"""
+    try:
+        with open("/proc/self/clear_refs", "w") as f:
+            f.write("5")
+        return True
+    except OSError:
+        return False
+
+
+def read_peak_rss_kb():
+    """The peak resident memory in kilobytes, or None if unknown"""
+    try:
+        with open("/proc/self/status") as f:
+            for line in f:
+                if line.startswith("VmHWM:"):
+                    return int(line.split()[1])
+    except OSError:
+        pass
+    return None
+
+
+def report(state, nbytes, size, rss_reset):
+    state.bytes_processed = nbytes * state.iterations
+    state.items_processed = size * state.iterations
+    peak_rss_kb = read_peak_rss_kb()
+    if rss_reset and peak_rss_kb is not None:
+        state.counters["peak_rss_mb"] = peak_rss_kb / 1024
+
+
+def pickle_dumps(arrays):
+    def case(state):
+        arr = arrays[state.range(0)]
+        rss_reset = reset_peak_rss()
+        nbytes = 0
+        while state:
+            nbytes = len(pickle.dumps(arr, protocol=4))
+        report(state, nbytes, arr.size, rss_reset)
+
+    return case
+
+
+def pickle_loads(arrays):
+    def case(state):
+        arr = arrays[state.range(0)]
+        data = pickle.dumps(arr, protocol=4)
+        rss_reset = reset_peak_rss()
+        while state:
+            pickle.loads(data)
+        report(state, len(data), arr.size, rss_reset)
+
+    return case
+
+
+def pickle5_out_of_band_dumps(arrays):
+    def case(state):
+        arr = arrays[state.range(0)]
+        rss_reset = reset_peak_rss()
+        nbytes = 0
+        while state:
+            buffers = []
+            data = pickle.dumps(arr, protocol=5, buffer_callback=buffers.append)
+            nbytes = len(data) + sum(len(b.raw()) for b in buffers)
+        report(state, nbytes, arr.size, rss_reset)
+
+    return case
+
+
+def pickle5_out_of_band_loads(arrays):
+    def case(state):
+        arr = arrays[state.range(0)]
+        buffers = []
+        data = pickle.dumps(arr, protocol=5, buffer_callback=buffers.append)
+        nbytes = len(data) + sum(len(b.raw()) for b in buffers)
+        rss_reset = reset_peak_rss()
+        while state:
+            pickle.loads(data, buffers=buffers)
+        report(state, nbytes, arr.size, rss_reset)
+
+    return case
+
+
+def register(schema_name, schema):
+    try:
+        kit = hnp.setup(schema, K_KEY_SIZE)
+        arrays = [
+            kit.encryptor().encrypt(kit.array(np.arange(np.prod(s)).reshape(s)))
+            for s in K_SHAPES
+        ]
+    except Exception as e:
+        print(f"Skip {schema_name}: {e}")
+        return
+
+    for case in [
+        pickle_dumps,
+        pickle_loads,
+        pickle5_out_of_band_dumps,
+        pickle5_out_of_band_loads,
+    ]:
+        fn = benchmark.option.unit(benchmark.kMicrosecond)(case(arrays))
+        fn = benchmark.option.dense_range(0, len(K_SHAPES) - 1)(fn)
+        benchmark.register(fn, name=f"{schema_name}|{case.__name__}")
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser()
+    parser.add_argument(
+        "--schema", default=".+", help="Run selected schemas, default to all."
+    )
+    args, rest = parser.parse_known_args()
+    schemas = [
+        (name, schema)
+        for name, schema in phe.SchemaType.__members__.items()
+        if re.fullmatch(args.schema, name, re.IGNORECASE)
+    ]
+    print(f"Schemas to bench: {[name for name, _ in schemas]}")
+    for name, schema in schemas:
+        register(name, schema)
+    sys.argv = sys.argv[:1] + rest
+    benchmark.main()
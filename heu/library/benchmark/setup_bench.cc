@@ -0,0 +1,192 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Cold-start latency: key generation, key loading and the precomputed tables
+// built along with the keys.
+//
+// Every case also reports footprint_mb, the heap memory held by the object it
+// creates (glibc only), e.g. the base tables of an OU public key.
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "absl/strings/str_split.h"
+#include "benchmark/benchmark.h"
+#include "fmt/ranges.h"
+#include "gflags/gflags.h"
+
+#include "heu/library/algorithms/dgk/dgk.h"
+#include "heu/library/algorithms/elgamal/elgamal.h"
+#include "heu/library/algorithms/ou/ou.h"
+#include "heu/library/phe/phe.h"
+
+#if defined(__GLIBC__) && \
+    (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+#define HEU_BENCH_HAS_MALLINFO2 1
+#include <malloc.h>
+#else
+#define HEU_BENCH_HAS_MALLINFO2 0
+#endif
+
+namespace heu::lib::bench {
+
+// Heap bytes in use by the process, 0 if unknown
+int64_t HeapBytesInUse() {
+#if HEU_BENCH_HAS_MALLINFO2
+  auto info = mallinfo2();
+  return static_cast<int64_t>(info.uordblks + info.hblkhd);
+#else
+  return 0;
+#endif
+}
+
+class SetupBenchmarks {
+ public:
+  void SetupAndRegister(phe::SchemaType schema_type, int key_size) {
+    try {
+      he_kit_ = std::make_unique<phe::HeKit>(schema_type, key_size);
+    } catch (const std::exception &e) {
+      fmt::print("Skip {} with key size {}: {}\n", schema_type, key_size,
+                 e.what());
+      return;
+    }
+    key_size_ = key_size;
+    auto pk_buf = he_kit_->GetPublicKey()->Serialize();
+    auto sk_buf = he_kit_->GetSecretKey()->Serialize();
+
+    // the keys are Init()-ed when they are deserialized, so these cases
+    // include the precomputed tables of every schema
+    Register("KeyGen", [schema_type, key_size]() {
+      return std::make_shared<phe::HeKit>(schema_type, key_size);
+    });
+    Register("PublicKey.Deserialize", [pk_buf]() {
+      auto pk = std::make_shared<phe::PublicKey>();
+      pk->Deserialize(pk_buf);
+      return pk;
+    });
+    Register("SecretKey.Deserialize", [sk_buf]() {
+      auto sk = std::make_shared<phe::SecretKey>();
+      sk->Deserialize(sk_buf);
+      return sk;
+    });
+    Register("HeKit.Load", [pk_buf, sk_buf]() {
+      return std::make_shared<phe::HeKit>(pk_buf, sk_buf);
+    });
+    Register("DestinationHeKit.Load", [pk_buf]() {
+      return std::make_shared<phe::DestinationHeKit>(pk_buf);
+    });
+
+    // the table construction alone
+    switch (schema_type) {
+      case phe::SchemaType::OU: {
+        const auto &pk =
+            he_kit_->GetPublicKey()->As<algorithms::ou::PublicKey>();
+        Register("ou::PublicKey::Init", [pk]() {
+          auto res = std::make_shared<algorithms::ou::PublicKey>(pk);
+          res->Init();
+          return res;
+        });
+        break;
+      }
+      case phe::SchemaType::ElGamal: {
+        auto curve = he_kit_->GetPublicKey()
+                         ->As<algorithms::elgamal::PublicKey>()
+                         .GetCurve();
+        Register("elgamal::LookupTable::Init", [curve]() {
+          auto res = std::make_shared<algorithms::elgamal::LookupTable>();
+          res->Init(curve);
+          return res;
+        });
+        break;
+      }
+      case phe::SchemaType::DGK: {
+        const auto &sk =
+            he_kit_->GetSecretKey()->As<algorithms::dgk::SecretKey>();
+        Register("dgk::SecretKey::Init", [sk]() {
+          auto res = std::make_shared<algorithms::dgk::SecretKey>();
+          res->Init(sk.P(), sk.Q(), sk.Vp(), sk.Vq(), sk.U(), sk.G());
+          return res;
+        });
+        break;
+      }
+      default:
+        break;
+    }
+  }
+
+ private:
+  // 'create' builds the object under test, which is kept alive until its
+  // footprint is measured
+  void Register(const std::string &name,
+                std::function<std::shared_ptr<void>()> create) {
+    benchmark::RegisterBenchmark(
+        fmt::format("{:^9}|{}|key={}", he_kit_->GetSchemaType(), name,
+                    key_size_)
+            .c_str(),
+        [this, create](benchmark::State &st) { Run(st, create); })
+        ->Unit(benchmark::kMillisecond);
+  }
+
+  void Run(benchmark::State &state,
+           const std::function<std::shared_ptr<void>()> &create) {
+    std::call_once(flag_, []() { fmt::print("{:-^80}\n", ""); });
+    int64_t footprint = 0;
+    for (auto _ : state) {
+      auto before = HeapBytesInUse();
+      auto obj = create();
+      footprint = HeapBytesInUse() - before;
+      benchmark::DoNotOptimize(obj);
+    }
+    if (HEU_BENCH_HAS_MALLINFO2) {
+      state.counters["footprint_mb"] = footprint / (1024.0 * 1024.0);
+    }
+  }
+
+  std::once_flag flag_;
+  std::unique_ptr<phe::HeKit> he_kit_;
+  int key_size_ = 0;
+};
+
+}  // namespace heu::lib::bench
+
+DEFINE_string(schema, ".+", "Run selected schemas, default to all.");
+DEFINE_string(key_sizes, "2048", "Comma separated key sizes to bench.");
+
+int main(int argc, char **argv) {
+  google::ParseCommandLineFlags(&argc, &argv, true);
+  benchmark::Initialize(&argc, argv);
+  benchmark::AddCustomContext("Key sizes", FLAGS_key_sizes);
+
+  std::vector<int> key_sizes;
+  for (auto item : absl::StrSplit(FLAGS_key_sizes, ',', absl::SkipEmpty())) {
+    key_sizes.push_back(std::stoi(std::string(item)));
+  }
+  auto schemas = heu::lib::phe::SelectSchemas(FLAGS_schema);
+  fmt::print("Schemas to bench: {}\n", schemas);
+  std::vector<heu::lib::bench::SetupBenchmarks> bms(schemas.size() *
+                                                     key_sizes.size());
+  for (size_t i = 0; i < schemas.size(); ++i) {
+    for (size_t j = 0; j < key_sizes.size(); ++j) {
+      bms[i * key_sizes.size() + j].SetupAndRegister(schemas[i],
+                                                     key_sizes[j]);
+    }
+  }
+
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
@@ -19,6 +19,9 @@ namespace heu::lib::numpy {
 template <typename CLAZZ, typename PT>
 using kHasVectorizedEncrypt = decltype(std::declval<const CLAZZ &>().Encrypt(
     absl::Span<const PT *const>()));
+template <typename CLAZZ, typename PT, typename CT>
+using kHasDenseOutEncrypt = decltype(std::declval<const CLAZZ &>().Encrypt(
+    absl::Span<const PT *const>(), absl::Span<CT>()));
 
 // PT is each algorithm's Plaintext
 template <typename CLAZZ, typename PT>
@@ -31,7 +34,15 @@ auto DoCallEncrypt(const CLAZZ &sub_encryptor, const PMatrix &in, CMatrix *out)
     for (int64_t i = beg; i < end; ++i) {
       pts.push_back(&(in.data()[i].As<PT>()));
     }
-    auto res = sub_encryptor.Encrypt(pts);
+    using CT = typename decltype(sub_encryptor.Encrypt(pts))::value_type;
+    std::vector<CT> res;
+    if constexpr (std::experimental::is_detected_v<kHasDenseOutEncrypt, CLAZZ,
+                                                   PT, CT>) {
+      res.resize(end - beg);
+      sub_encryptor.Encrypt(pts, absl::MakeSpan(res));
+    } else {
+      res = sub_encryptor.Encrypt(pts);
+    }
     for (int64_t i = beg; i < end; ++i) {
       out->data()[i] = phe::Ciphertext(std::move(res[i - beg]));
     }
@@ -13,6 +13,10 @@
 // limitations under the License.
 #include "heu/library/numpy/evaluator.h"
 
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <optional>
 #include <type_traits>
 #include <typeinfo>
 
@@ -20,6 +24,7 @@
 #include "yacl/utils/parallel.h"
 
 #include "heu/library/numpy/shape.h"
+#include "heu/library/numpy/trace.h"
 
 namespace heu::lib::numpy {
 
@@ -68,6 +73,37 @@ std::array<int64_t, 2> ComputeCastStride(const std::array<int64_t, 2> &strides,
   return {stride0, stride1};
 }
 
+// True if 'view' reads any element stored in 'm'. Ops writing all of 'm' in
+// place rely on their inputs not changing underneath them.
+template <typename T, typename U>
+bool SharesStorage(const DenseMatrix<T> &m, const DenseMatrixView<U> &view) {
+  if constexpr (!std::is_same_v<T, U>) {
+    return false;
+  } else {
+    if (m.size() == 0 || view.size() == 0) {
+      return false;
+    }
+    const T *first = view.data();
+    const T *last = view.data();
+    for (auto extent : {(view.rows() - 1) * view.strides()[0],
+                        (view.cols() - 1) * view.strides()[1]}) {
+      (extent < 0 ? first : last) += extent;
+    }
+    std::less<const T *> less;
+    return !less(last, m.data()) && !less(m.data() + m.size() - 1, first);
+  }
+}
+
+// Number of element multiplications of x @ y, for op stats
+template <typename MX, typename MY>
+int64_t MatMulElements(const MX &x, const MY &y) {
+  if (x.ndim() == 0 || y.ndim() == 0) {
+    return std::max(x.size(), y.size());
+  }
+  int64_t k = x.shape()[-1];
+  return k == 0 ? 0 : x.size() * y.size() / k;
+}
+
 int64_t MatmulDim(const Shape &x, const Shape &y) {
   int64_t newd;
   auto mind = std::min(x.Ndim(), y.Ndim());
@@ -102,6 +138,34 @@ using kHasVectorizedMul = decltype(std::declval<const CLAZZ &>().Mul(
 template <typename CLAZZ, typename T>
 using kHasReduceSum = decltype(std::declval<const CLAZZ &>().ReduceSum(
     absl::Span<const T *const>()));
+// The variants that write into (or read from) contiguous buffers
+template <typename CLAZZ, typename SUB_TX, typename SUB_TY, typename SUB_RET>
+using kHasDenseOutAdd = decltype(std::declval<const CLAZZ &>().Add(
+    absl::Span<const SUB_TX *const>(), absl::Span<const SUB_TY *const>(),
+    absl::Span<SUB_RET>()));
+template <typename CLAZZ, typename SUB_TX, typename SUB_TY, typename SUB_RET>
+using kHasDenseOutSub = decltype(std::declval<const CLAZZ &>().Sub(
+    absl::Span<const SUB_TX *const>(), absl::Span<const SUB_TY *const>(),
+    absl::Span<SUB_RET>()));
+template <typename CLAZZ, typename SUB_TX, typename SUB_TY, typename SUB_RET>
+using kHasDenseOutMul = decltype(std::declval<const CLAZZ &>().Mul(
+    absl::Span<const SUB_TX *const>(), absl::Span<const SUB_TY *const>(),
+    absl::Span<SUB_RET>()));
+template <typename CLAZZ, typename T>
+using kHasDenseReduceSum = decltype(std::declval<const CLAZZ &>().ReduceSum(
+    absl::Span<const T>()));
+template <typename CLAZZ, typename SUB_TX, typename SUB_TY>
+using kHasVectorizedAddInplace =
+    decltype(std::declval<const CLAZZ &>().AddInplace(
+        absl::Span<SUB_TX *const>(), absl::Span<const SUB_TY *const>()));
+template <typename CLAZZ, typename SUB_TX, typename SUB_TY>
+using kHasVectorizedSubInplace =
+    decltype(std::declval<const CLAZZ &>().SubInplace(
+        absl::Span<SUB_TX *const>(), absl::Span<const SUB_TY *const>()));
+template <typename CLAZZ, typename SUB_TX, typename SUB_TY>
+using kHasVectorizedMulInplace =
+    decltype(std::declval<const CLAZZ &>().MulInplace(
+        absl::Span<SUB_TX *const>(), absl::Span<const SUB_TY *const>()));
 
 #define DO_CALL_OP(ns, OP, TX, TY)                                           \
   [&](const ns::Evaluator &sub_encryptor) {                                  \
@@ -111,9 +175,10 @@ using kHasReduceSum = decltype(std::declval<const CLAZZ &>().ReduceSum(
 
 #define IMPLEMENT_DENSE_OP(OP, RET, TX, TY)                                  \
   template <typename CLAZZ, typename SUB_TX, typename SUB_TY>                \
-  auto DoCall##OP(const CLAZZ &sub_evaluator, const DenseMatrix<phe::TX> &x, \
+  auto DoCall##OP(const CLAZZ &sub_evaluator,                                \
+                  const DenseMatrixView<phe::TX> &x,                         \
                   std::array<int64_t, 2> x_stride,                           \
-                  const DenseMatrix<phe::TY> &y,                             \
+                  const DenseMatrixView<phe::TY> &y,                         \
                   std::array<int64_t, 2> y_stride, RET *out)                 \
       ->std::enable_if_t<std::experimental::is_detected_v<                   \
           kHasVectorized##OP, CLAZZ, SUB_TX, SUB_TY>> {                      \
@@ -121,7 +186,9 @@ using kHasReduceSum = decltype(std::declval<const CLAZZ &>().ReduceSum(
     const auto *y_base = y.data();                                           \
     RET::value_type *out_base = out->data();                                 \
     int64_t rows = out->rows();                                              \
+    HEU_TRACE_CAPTURE(trace_ctx);                                            \
     yacl::parallel_for(0, out->size(), 1, [&](int64_t beg, int64_t end) {    \
+      HEU_TRACE_CHUNK(trace_ctx, beg, end);                                  \
       std::vector<const SUB_TX *> in_x;                                      \
       std::vector<const SUB_TY *> in_y;                                      \
       in_x.reserve(end - beg);                                               \
@@ -134,7 +201,16 @@ using kHasReduceSum = decltype(std::declval<const CLAZZ &>().ReduceSum(
         in_y.push_back(                                                      \
             &(y_base[row * y_stride[0] + col * y_stride[1]].As<SUB_TY>()));  \
       }                                                                      \
-      auto res = sub_evaluator.OP(in_x, in_y);                               \
+      using SUB_RET =                                                        \
+          typename decltype(sub_evaluator.OP(in_x, in_y))::value_type;       \
+      std::vector<SUB_RET> res;                                              \
+      if constexpr (std::experimental::is_detected_v<                        \
+                        kHasDenseOut##OP, CLAZZ, SUB_TX, SUB_TY, SUB_RET>) { \
+        res.resize(end - beg);                                               \
+        sub_evaluator.OP(in_x, in_y, absl::MakeSpan(res));                   \
+      } else {                                                               \
+        res = sub_evaluator.OP(in_x, in_y);                                  \
+      }                                                                      \
       for (int64_t i = beg; i < end; ++i) {                                  \
         out_base[i] = RET::value_type(std::move(res[i - beg]));              \
       }                                                                      \
@@ -142,9 +218,10 @@ using kHasReduceSum = decltype(std::declval<const CLAZZ &>().ReduceSum(
   }                                                                          \
                                                                              \
   template <typename CLAZZ, typename SUB_TX, typename SUB_TY>                \
-  auto DoCall##OP(const CLAZZ &sub_evaluator, const DenseMatrix<phe::TX> &x, \
+  auto DoCall##OP(const CLAZZ &sub_evaluator,                                \
+                  const DenseMatrixView<phe::TX> &x,                         \
                   std::array<int64_t, 2> x_stride,                           \
-                  const DenseMatrix<phe::TY> &y,                             \
+                  const DenseMatrixView<phe::TY> &y,                         \
                   std::array<int64_t, 2> y_stride, RET *out)                 \
       ->std::enable_if_t<!std::experimental::is_detected_v<                  \
           kHasVectorized##OP, CLAZZ, SUB_TX, SUB_TY>> {                      \
@@ -152,7 +229,9 @@ using kHasReduceSum = decltype(std::declval<const CLAZZ &>().ReduceSum(
     const auto *y_base = y.data();                                           \
     RET::value_type *out_base = out->data();                                 \
     int64_t rows = out->rows();                                              \
+    HEU_TRACE_CAPTURE(trace_ctx);                                            \
     yacl::parallel_for(0, out->size(), 1, [&](int64_t beg, int64_t end) {    \
+      HEU_TRACE_CHUNK(trace_ctx, beg, end);                                  \
       for (int64_t i = beg; i < end; ++i) {                                  \
         int64_t row = i % rows;                                              \
         int64_t col = i / rows;                                              \
@@ -167,6 +246,11 @@ using kHasReduceSum = decltype(std::declval<const CLAZZ &>().ReduceSum(
                                                                              \
   RET Evaluator::OP(const DenseMatrix<phe::TX> &x,                           \
                     const DenseMatrix<phe::TY> &y) const {                   \
+    return OP(DenseMatrixView<phe::TX>(x), DenseMatrixView<phe::TY>(y));     \
+  }                                                                          \
+                                                                             \
+  RET Evaluator::OP(const DenseMatrixView<phe::TX> &x,                       \
+                    const DenseMatrixView<phe::TY> &y) const {               \
     Dimension sx(x);                                                         \
     Dimension sy(y);                                                         \
     YACL_ENFORCE(sx.IsCompatibleShape(sy),                                   \
@@ -174,11 +258,12 @@ using kHasReduceSum = decltype(std::declval<const CLAZZ &>().ReduceSum(
                  (x).shape().ToString(), (y).shape().ToString());            \
                                                                              \
     auto sz = sx.ComputeCastShape(sy);                                       \
+    phe::OpStatsScope stats(phe::OpSource::kNumpy, phe::OpKind::k##OP,       \
+                            sz.rows * sz.cols);                              \
+    HEU_TRACE_KERNEL(#OP, GetSchemaType(), sz.rows * sz.cols);               \
                                                                              \
-    std::array<int64_t, 2> x_old_stride = {1, x.rows()};                     \
-    std::array<int64_t, 2> y_old_stride = {1, y.rows()};                     \
-    const auto x_stride = ComputeCastStride(x_old_stride, sx, sz);           \
-    const auto y_stride = ComputeCastStride(y_old_stride, sy, sz);           \
+    const auto x_stride = ComputeCastStride(x.strides(), sx, sz);            \
+    const auto y_stride = ComputeCastStride(y.strides(), sy, sz);            \
                                                                              \
     RET out(sz.rows, sz.cols, sz.ndim);                                      \
     std::visit(HE_DISPATCH(DO_CALL_OP, OP, TX, TY), evaluator_ptr_);         \
@@ -193,6 +278,10 @@ CMatrix Evaluator::Add(const PMatrix &x, const CMatrix &y) const {
   return Add(y, x);
 };
 
+CMatrix Evaluator::Add(const PMatrixView &x, const CMatrixView &y) const {
+  return Add(y, x);
+}
+
 IMPLEMENT_DENSE_OP(Sub, CMatrix, Ciphertext, Ciphertext);
 IMPLEMENT_DENSE_OP(Sub, CMatrix, Ciphertext, Plaintext);
 IMPLEMENT_DENSE_OP(Sub, CMatrix, Plaintext, Ciphertext);
@@ -205,40 +294,448 @@ CMatrix Evaluator::Mul(const PMatrix &x, const CMatrix &y) const {
   return Mul(y, x);
 };
 
+CMatrix Evaluator::Mul(const PMatrixView &x, const CMatrixView &y) const {
+  return Mul(y, x);
+}
+
+/*********   In-place cwise ops  ***********/
+// x[i] = x[i] OP y[i] for a chunk of elements, using the vectorized in-place
+// API if the sub-evaluator has one, then the vectorized out-of-place API,
+// then the scalar in-place API.
+#define IMPLEMENT_CHUNK_INPLACE_OP(OP)                                        \
+  template <typename CLAZZ, typename SUB_TX, typename SUB_TY>                 \
+  void OP##ChunkInplace(const CLAZZ &sub_evaluator,                           \
+                        const std::vector<SUB_TX *> &x,                       \
+                        const std::vector<const SUB_TY *> &y) {               \
+    if constexpr (std::experimental::is_detected_v<                           \
+                      kHasVectorized##OP##Inplace, CLAZZ, SUB_TX, SUB_TY>) {  \
+      sub_evaluator.OP##Inplace(absl::MakeConstSpan(x),                       \
+                                absl::MakeConstSpan(y));                      \
+    } else if constexpr (std::experimental::is_detected_v<                    \
+                             kHasVectorized##OP, CLAZZ, SUB_TX, SUB_TY>) {    \
+      std::vector<const SUB_TX *> in_x(x.begin(), x.end());                   \
+      auto res = sub_evaluator.OP(in_x, y);                                   \
+      for (size_t i = 0; i < x.size(); ++i) {                                 \
+        *x[i] = std::move(res[i]);                                            \
+      }                                                                       \
+    } else {                                                                  \
+      for (size_t i = 0; i < x.size(); ++i) {                                 \
+        sub_evaluator.OP##Inplace(x[i], *y[i]);                               \
+      }                                                                       \
+    }                                                                         \
+  }                                                                           \
+                                                                              \
+  template <typename CLAZZ, typename SUB_TX, typename SUB_TY, typename MX,    \
+            typename MY>                                                      \
+  void DoCall##OP##Inplace(const CLAZZ &sub_evaluator, MX *x, const MY &y,    \
+                           std::array<int64_t, 2> y_stride) {                 \
+    auto *x_base = x->data();                                                 \
+    const auto *y_base = y.data();                                            \
+    int64_t rows = x->rows();                                                 \
+    HEU_TRACE_CAPTURE(trace_ctx);                                             \
+    yacl::parallel_for(0, x->size(), 1, [&](int64_t beg, int64_t end) {       \
+      HEU_TRACE_CHUNK(trace_ctx, beg, end);                                   \
+      std::vector<SUB_TX *> in_x;                                             \
+      std::vector<const SUB_TY *> in_y;                                       \
+      in_x.reserve(end - beg);                                                \
+      in_y.reserve(end - beg);                                                \
+      for (int64_t i = beg; i < end; ++i) {                                   \
+        int64_t row = i % rows;                                               \
+        int64_t col = i / rows;                                               \
+        in_x.push_back(&(x_base[i].template As<SUB_TX>()));                   \
+        in_y.push_back(&(y_base[row * y_stride[0] + col * y_stride[1]]        \
+                             .template As<SUB_TY>()));                        \
+      }                                                                       \
+      OP##ChunkInplace(sub_evaluator, in_x, in_y);                            \
+    });                                                                       \
+  }
+
+IMPLEMENT_CHUNK_INPLACE_OP(Add);
+IMPLEMENT_CHUNK_INPLACE_OP(Sub);
+IMPLEMENT_CHUNK_INPLACE_OP(Mul);
+
+#define DO_CALL_INPLACE_OP(ns, OP, TX, TY)                                    \
+  [&](const ns::Evaluator &sub_evaluator) {                                   \
+    DoCall##OP##Inplace<ns::Evaluator, ns::TX, ns::TY>(sub_evaluator, x, y,   \
+                                                       y_stride);             \
+  }
+
+#define IMPLEMENT_DENSE_INPLACE_OP(OP, TX, TY)                                 \
+  void Evaluator::OP##Inplace(DenseMatrix<phe::TX> *x,                         \
+                              const DenseMatrixView<phe::TY> &y) const {       \
+    Dimension sx(*x);                                                          \
+    Dimension sy(y);                                                           \
+    YACL_ENFORCE(sx.IsCompatibleShape(sy) && sy.rows <= sx.rows &&             \
+                     sy.cols <= sx.cols,                                       \
+                 "{} not supported for dim(x)={}, dim(y)={}, y must be "       \
+                 "broadcastable to x",                                         \
+                 __func__, x->shape().ToString(), y.shape().ToString());       \
+    YACL_ENFORCE(!SharesStorage(*x, y), "{}: y must not overlap with x",       \
+                 __func__);                                                    \
+    if (x->size() == 0) {                                                      \
+      return;                                                                  \
+    }                                                                          \
+    phe::OpStatsScope stats(phe::OpSource::kNumpy, phe::OpKind::k##OP,         \
+                            x->size());                                        \
+    HEU_TRACE_KERNEL(#OP "Inplace", GetSchemaType(), x->size());               \
+                                                                               \
+    const auto y_stride = ComputeCastStride(y.strides(), sy, sx);              \
+    std::visit(HE_DISPATCH(DO_CALL_INPLACE_OP, OP, TX, TY), evaluator_ptr_);   \
+  }
+
+IMPLEMENT_DENSE_INPLACE_OP(Add, Ciphertext, Ciphertext);
+IMPLEMENT_DENSE_INPLACE_OP(Add, Ciphertext, Plaintext);
+IMPLEMENT_DENSE_INPLACE_OP(Add, Plaintext, Plaintext);
+
+IMPLEMENT_DENSE_INPLACE_OP(Sub, Ciphertext, Ciphertext);
+IMPLEMENT_DENSE_INPLACE_OP(Sub, Ciphertext, Plaintext);
+IMPLEMENT_DENSE_INPLACE_OP(Sub, Plaintext, Plaintext);
+
+IMPLEMENT_DENSE_INPLACE_OP(Mul, Ciphertext, Plaintext);
+IMPLEMENT_DENSE_INPLACE_OP(Mul, Plaintext, Plaintext);
+
+/*********   Axpy  ***********/
+template <typename CLAZZ, typename SUB_CT, typename SUB_PT>
+void DoCallAxpy(const CLAZZ &sub_evaluator, const PMatrixView &a,
+                std::array<int64_t, 2> a_stride, const CMatrixView &x,
+                std::array<int64_t, 2> x_stride, CMatrix *y) {
+  const auto *a_base = a.data();
+  const auto *x_base = x.data();
+  auto *y_base = y->data();
+  int64_t rows = y->rows();
+  yacl::parallel_for(0, y->size(), 1, [&](int64_t beg, int64_t end) {
+    if constexpr (std::experimental::is_detected_v<kHasVectorizedMul, CLAZZ,
+                                                   SUB_CT, SUB_PT>) {
+      std::vector<const SUB_CT *> in_x;
+      std::vector<const SUB_PT *> in_a;
+      in_x.reserve(end - beg);
+      in_a.reserve(end - beg);
+      for (int64_t i = beg; i < end; ++i) {
+        int64_t row = i % rows;
+        int64_t col = i / rows;
+        in_x.push_back(&(x_base[row * x_stride[0] + col * x_stride[1]]
+                             .template As<SUB_CT>()));
+        in_a.push_back(&(a_base[row * a_stride[0] + col * a_stride[1]]
+                             .template As<SUB_PT>()));
+      }
+      auto ax = sub_evaluator.Mul(in_x, in_a);
+
+      std::vector<SUB_CT *> out;
+      std::vector<const SUB_CT *> in_ax;
+      out.reserve(end - beg);
+      in_ax.reserve(end - beg);
+      for (int64_t i = beg; i < end; ++i) {
+        out.push_back(&(y_base[i].template As<SUB_CT>()));
+        in_ax.push_back(&ax[i - beg]);
+      }
+      AddChunkInplace(sub_evaluator, out, in_ax);
+    } else {
+      for (int64_t i = beg; i < end; ++i) {
+        int64_t row = i % rows;
+        int64_t col = i / rows;
+        auto ax = sub_evaluator.Mul(
+            x_base[row * x_stride[0] + col * x_stride[1]]
+                .template As<SUB_CT>(),
+            a_base[row * a_stride[0] + col * a_stride[1]]
+                .template As<SUB_PT>());
+        sub_evaluator.AddInplace(&(y_base[i].template As<SUB_CT>()), ax);
+      }
+    }
+  });
+}
+
+#define DO_CALL_AXPY(ns)                                                    \
+  [&](const ns::Evaluator &sub_evaluator) {                                 \
+    DoCallAxpy<ns::Evaluator, ns::Ciphertext, ns::Plaintext>(               \
+        sub_evaluator, a, a_stride, x, x_stride, y);                        \
+  }
+
+void Evaluator::Axpy(const PMatrixView &a, const CMatrixView &x,
+                     CMatrix *y) const {
+  Dimension sa(a);
+  Dimension sx(x);
+  Dimension sy(*y);
+  YACL_ENFORCE(sa.IsCompatibleShape(sy) && sa.rows <= sy.rows &&
+                   sa.cols <= sy.cols && sx.IsCompatibleShape(sy) &&
+                   sx.rows <= sy.rows && sx.cols <= sy.cols,
+               "Axpy not supported for dim(a)={}, dim(x)={}, dim(y)={}, a and "
+               "x must be broadcastable to y",
+               a.shape().ToString(), x.shape().ToString(),
+               y->shape().ToString());
+  YACL_ENFORCE(!SharesStorage(*y, x), "Axpy: x must not overlap with y");
+  if (y->size() == 0) {
+    return;
+  }
+
+  const auto a_stride = ComputeCastStride(a.strides(), sa, sy);
+  const auto x_stride = ComputeCastStride(x.strides(), sx, sy);
+  std::visit(HE_DISPATCH(DO_CALL_AXPY), evaluator_ptr_);
+}
+
+/*********   Fused element-wise ops  ***********/
+// out[i] = x[i] OP y[i] for a chunk of elements, vectorized if possible
+#define IMPLEMENT_CHUNK_OP(OP)                                                 \
+  template <typename CLAZZ, typename SUB_TX, typename SUB_TY>                  \
+  auto OP##Chunk(const CLAZZ &sub_evaluator,                                   \
+                 const std::vector<const SUB_TX *> &x,                         \
+                 const std::vector<const SUB_TY *> &y) {                       \
+    if constexpr (std::experimental::is_detected_v<kHasVectorized##OP, CLAZZ,  \
+                                                   SUB_TX, SUB_TY>) {          \
+      return sub_evaluator.OP(x, y);                                           \
+    } else {                                                                   \
+      std::vector<decltype(sub_evaluator.OP(*x[0], *y[0]))> res;               \
+      res.reserve(x.size());                                                   \
+      for (size_t i = 0; i < x.size(); ++i) {                                  \
+        res.push_back(sub_evaluator.OP(*x[i], *y[i]));                         \
+      }                                                                        \
+      return res;                                                              \
+    }                                                                          \
+  }
+
+IMPLEMENT_CHUNK_OP(Add);
+IMPLEMENT_CHUNK_OP(Sub);
+IMPLEMENT_CHUNK_OP(Mul);
+
+// One register of ElementwiseProgram, holding the values of a chunk.
+// Registers of inputs point into the input matrices, the others own values.
+template <typename CT, typename PT>
+struct ChunkRegister {
+  bool is_cipher = false;
+  std::vector<const CT *> ct;
+  std::vector<const PT *> pt;
+  std::vector<CT> ct_store;
+  std::vector<PT> pt_store;
+
+  void StoreCiphertexts(std::vector<CT> &&values) {
+    is_cipher = true;
+    ct_store = std::move(values);
+    ct.reserve(ct_store.size());
+    for (const auto &v : ct_store) {
+      ct.push_back(&v);
+    }
+  }
+
+  void StorePlaintexts(std::vector<PT> &&values) {
+    pt_store = std::move(values);
+    pt.reserve(pt_store.size());
+    for (const auto &v : pt_store) {
+      pt.push_back(&v);
+    }
+  }
+};
+
+template <typename CLAZZ, typename CT, typename PT>
+void RunInstr(const CLAZZ &sub_evaluator, ElementwiseProgram::Op op,
+              const ChunkRegister<CT, PT> &x, const ChunkRegister<CT, PT> &y,
+              ChunkRegister<CT, PT> *out) {
+  using Op = ElementwiseProgram::Op;
+  if (x.is_cipher && y.is_cipher) {
+    YACL_ENFORCE(op != Op::kMul, "cannot multiply two ciphertexts");
+    out->StoreCiphertexts(op == Op::kAdd ? AddChunk(sub_evaluator, x.ct, y.ct)
+                                         : SubChunk(sub_evaluator, x.ct, y.ct));
+  } else if (x.is_cipher) {
+    switch (op) {
+      case Op::kAdd:
+        out->StoreCiphertexts(AddChunk(sub_evaluator, x.ct, y.pt));
+        break;
+      case Op::kSub:
+        out->StoreCiphertexts(SubChunk(sub_evaluator, x.ct, y.pt));
+        break;
+      case Op::kMul:
+        out->StoreCiphertexts(MulChunk(sub_evaluator, x.ct, y.pt));
+        break;
+    }
+  } else if (y.is_cipher) {
+    YACL_ENFORCE(op == Op::kSub,
+                 "the ciphertext operand of add/mul must be the lhs");
+    out->StoreCiphertexts(SubChunk(sub_evaluator, x.pt, y.ct));
+  } else {
+    switch (op) {
+      case Op::kAdd:
+        out->StorePlaintexts(AddChunk(sub_evaluator, x.pt, y.pt));
+        break;
+      case Op::kSub:
+        out->StorePlaintexts(SubChunk(sub_evaluator, x.pt, y.pt));
+        break;
+      case Op::kMul:
+        out->StorePlaintexts(MulChunk(sub_evaluator, x.pt, y.pt));
+        break;
+    }
+  }
+}
+
+template <typename CLAZZ, typename CT, typename PT, typename RET>
+void DoCallElementwise(const CLAZZ &sub_evaluator,
+                       const ElementwiseProgram &program,
+                       const std::vector<std::array<int64_t, 2>> &strides,
+                       RET *out) {
+  auto *out_base = out->data();
+  int64_t rows = out->rows();
+  size_t num_inputs = program.inputs.size();
+  yacl::parallel_for(0, out->size(), 1, [&](int64_t beg, int64_t end) {
+    std::vector<ChunkRegister<CT, PT>> regs(num_inputs +
+                                            program.instrs.size());
+    for (size_t k = 0; k < num_inputs; ++k) {
+      auto &reg = regs[k];
+      std::visit(
+          [&](const auto &view) {
+            using T = typename std::decay_t<decltype(view)>::value_type;
+            const T *base = view.data();
+            for (int64_t i = beg; i < end; ++i) {
+              int64_t row = i % rows;
+              int64_t col = i / rows;
+              const T &e = base[row * strides[k][0] + col * strides[k][1]];
+              if constexpr (std::is_same_v<T, phe::Ciphertext>) {
+                reg.is_cipher = true;
+                reg.ct.push_back(&(e.template As<CT>()));
+              } else {
+                reg.pt.push_back(&(e.template As<PT>()));
+              }
+            }
+          },
+          program.inputs[k]);
+    }
+
+    for (size_t k = 0; k < program.instrs.size(); ++k) {
+      const auto &instr = program.instrs[k];
+      RunInstr(sub_evaluator, instr.op, regs[instr.lhs], regs[instr.rhs],
+               &regs[num_inputs + k]);
+    }
+
+    auto &res = regs.back();
+    for (int64_t i = beg; i < end; ++i) {
+      if constexpr (std::is_same_v<typename RET::value_type, phe::Ciphertext>) {
+        out_base[i] = res.ct_store.empty()
+                          ? phe::Ciphertext(*res.ct[i - beg])
+                          : phe::Ciphertext(std::move(res.ct_store[i - beg]));
+      } else {
+        out_base[i] = res.pt_store.empty()
+                          ? phe::Plaintext(*res.pt[i - beg])
+                          : phe::Plaintext(std::move(res.pt_store[i - beg]));
+      }
+    }
+  });
+}
+
+// Validate the program and compute the broadcast strides of inputs
+template <typename T>
+std::vector<std::array<int64_t, 2>> PrepareElementwise(
+    const ElementwiseProgram &program, const DenseMatrix<T> &out) {
+  YACL_ENFORCE(!program.inputs.empty(), "element-wise program has no input");
+
+  std::vector<bool> is_cipher;
+  std::vector<std::array<int64_t, 2>> strides;
+  Dimension so(out);
+  for (const auto &input : program.inputs) {
+    std::visit(
+        [&](const auto &view) {
+          Dimension si(view);
+          YACL_ENFORCE(si.IsCompatibleShape(so) && si.rows <= so.rows &&
+                           si.cols <= so.cols,
+                       "input of shape {} cannot be broadcast to {}",
+                       view.shape().ToString(), out.shape().ToString());
+          strides.push_back(ComputeCastStride(view.strides(), si, so));
+          is_cipher.push_back(
+              std::is_same_v<typename std::decay_t<decltype(view)>::value_type,
+                             phe::Ciphertext>);
+        },
+        input);
+  }
+
+  for (const auto &instr : program.instrs) {
+    YACL_ENFORCE(instr.lhs < is_cipher.size() && instr.rhs < is_cipher.size(),
+                 "instruction reads register {} or {} before it is written",
+                 instr.lhs, instr.rhs);
+    is_cipher.push_back(is_cipher[instr.lhs] || is_cipher[instr.rhs]);
+  }
+  YACL_ENFORCE(is_cipher.back() == std::is_same_v<T, phe::Ciphertext>,
+               "element-wise program result type mismatch");
+  return strides;
+}
+
+#define DO_CALL_ELEMENTWISE(ns)                                              \
+  [&](const ns::Evaluator &sub_evaluator) {                                  \
+    DoCallElementwise<ns::Evaluator, ns::Ciphertext, ns::Plaintext>(         \
+        sub_evaluator, program, strides, out);                               \
+  }
+
+void Evaluator::EvalElementwise(const ElementwiseProgram &program,
+                                CMatrix *out) const {
+  auto strides = PrepareElementwise(program, *out);
+  if (out->size() > 0) {
+    std::visit(HE_DISPATCH(DO_CALL_ELEMENTWISE), evaluator_ptr_);
+  }
+}
+
+void Evaluator::EvalElementwise(const ElementwiseProgram &program,
+                                PMatrix *out) const {
+  auto strides = PrepareElementwise(program, *out);
+  if (out->size() > 0) {
+    std::visit(HE_DISPATCH(DO_CALL_ELEMENTWISE), evaluator_ptr_);
+  }
+}
+
 /*********   MatMul  ***********/
 template <typename SUB_T1, typename SUB_T2, typename CLAZZ, typename M1,
           typename M2, typename RET>
 auto DoCallMatMul(const CLAZZ &sub_evaluator, const M1 &mx, const M2 &my,
-                  bool transpose, RET *out)
+                  bool transpose, bool accumulate, RET *out)
     -> std::enable_if_t<std::experimental::is_detected_v<
         kHasVectorizedMul, CLAZZ, SUB_T1, SUB_T2>> {
   // convert type for mx
-  auto mx_buf = mx.data();
-  auto mx_rows = mx.rows();
   std::vector<std::vector<const SUB_T1 *>> in_x;
-  in_x.resize(mx_rows);
-  for (int64_t i = 0; i < mx_rows; ++i) {
+  in_x.resize(mx.rows());
+  for (int64_t i = 0; i < mx.rows(); ++i) {
     in_x[i].resize(mx.cols());
     for (int64_t j = 0; j < mx.cols(); ++j) {
-      // There is a weird problem: mx(i, j) doesn't return a reference, it
-      // returns a copy. maybe an eigen bug?
-      // So we direct access underlying buffer.
-      in_x[i][j] = &(mx_buf[j * mx_rows + i].template As<SUB_T1>());
+      in_x[i][j] = &(mx(i, j).template As<SUB_T1>());
     }
   }
 
   // convert type for my
   std::vector<std::vector<const SUB_T2 *>> in_y;
   in_y.resize(my.cols());
-  auto my_buf = my.data();
-  int pos = 0;
   for (int64_t i = 0; i < my.cols(); ++i) {
     in_y[i].resize(my.rows());
     for (int64_t j = 0; j < my.rows(); ++j) {
-      in_y[i][j] = &(my_buf[pos++].template As<SUB_T2>());
+      in_y[i][j] = &(my(j, i).template As<SUB_T2>());
     }
   }
 
+  using SUB_RET = typename decltype(sub_evaluator.Mul(
+      absl::Span<const SUB_T1 *const>(),
+      absl::Span<const SUB_T2 *const>()))::value_type;
+  if constexpr (std::experimental::is_detected_v<kHasDenseOutMul, CLAZZ,
+                                                 SUB_T1, SUB_T2, SUB_RET> &&
+                std::experimental::is_detected_v<kHasDenseReduceSum, CLAZZ,
+                                                 SUB_RET>) {
+    // The products of an element are written into a buffer reused by the
+    // whole chunk and summed from there, so no vector is allocated per element
+    typename RET::value_type *out_base = out->data();
+    int64_t rows = out->rows();
+    HEU_TRACE_CAPTURE(trace_ctx);
+    yacl::parallel_for(0, out->size(), 1, [&](int64_t beg, int64_t end) {
+      HEU_TRACE_CHUNK(trace_ctx, beg, end);
+      std::vector<SUB_RET> prods(mx.cols());
+      for (int64_t i = beg; i < end; ++i) {
+        int64_t row = i % rows;
+        int64_t col = i / rows;
+        if (transpose) {
+          std::swap(row, col);
+        }
+
+        sub_evaluator.Mul(in_x[row], in_y[col], absl::MakeSpan(prods));
+        auto sum = sub_evaluator.ReduceSum(absl::MakeConstSpan(prods));
+        if (accumulate) {
+          sub_evaluator.AddInplace(&sum,
+                                   out_base[i].template As<SUB_RET>());
+        }
+        out_base[i] = std::move(sum);
+      }
+    });
+    return;
+  }
+
   out->ForEach(
       [&](int64_t row, int64_t col, typename RET::value_type *element) {
         if (transpose) {
@@ -246,15 +743,18 @@ auto DoCallMatMul(const CLAZZ &sub_evaluator, const M1 &mx, const M2 &my,
         }
 
         auto res = sub_evaluator.Mul(in_x[row], in_y[col]);
+        using SUB_RET = typename decltype(res)::value_type;
 
-        if constexpr (std::experimental::is_detected_v<
-                          kHasReduceSum, CLAZZ,
-                          typename decltype(res)::value_type>) {
-          std::vector<decltype(&res[0])> sum_vec;
-          sum_vec.reserve(res.size());
+        if constexpr (std::experimental::is_detected_v<kHasReduceSum, CLAZZ,
+                                                       SUB_RET>) {
+          std::vector<const SUB_RET *> sum_vec;
+          sum_vec.reserve(res.size() + 1);
           for (size_t j = 0; j < res.size(); ++j) {
             sum_vec.push_back(&res[j]);
           }
+          if (accumulate) {
+            sum_vec.push_back(&(element->template As<SUB_RET>()));
+          }
 
           *element = sub_evaluator.ReduceSum(sum_vec);
         } else {
@@ -263,6 +763,10 @@ auto DoCallMatMul(const CLAZZ &sub_evaluator, const M1 &mx, const M2 &my,
             // todo: use binary reduce
             sub_evaluator.AddInplace({sum}, {&res[j]});
           }
+          if (accumulate) {
+            sub_evaluator.AddInplace({sum},
+                                     {&(element->template As<SUB_RET>())});
+          }
           *element = std::move(*sum);
         }
       });
@@ -271,7 +775,7 @@ auto DoCallMatMul(const CLAZZ &sub_evaluator, const M1 &mx, const M2 &my,
 template <typename SUB_T1, typename SUB_T2, typename CLAZZ, typename M1,
           typename M2, typename RET>
 auto DoCallMatMul(const CLAZZ &sub_evaluator, const M1 &mx, const M2 &my,
-                  bool transpose, RET *out)
+                  bool transpose, bool accumulate, RET *out)
     -> std::enable_if_t<!std::experimental::is_detected_v<
         kHasVectorizedMul, CLAZZ, SUB_T1, SUB_T2>> {
   out->ForEach(
@@ -287,19 +791,25 @@ auto DoCallMatMul(const CLAZZ &sub_evaluator, const M1 &mx, const M2 &my,
               &sum, sub_evaluator.Mul(mx(row, j).template As<SUB_T1>(),
                                       my(j, col).template As<SUB_T2>()));
         }
+        if (accumulate) {
+          sub_evaluator.AddInplace(
+              &sum, element->template As<std::decay_t<decltype(sum)>>());
+        }
         *element = (std::move(sum));
       });
 }
 
 #define DO_CALL_MATMUL(ns, TX, TY)                                        \
   [&](const ns::Evaluator &sub_encryptor) {                               \
-    DoCallMatMul<ns::TX, ns::TY>(sub_encryptor, mx, my, transpose, &out); \
+    DoCallMatMul<ns::TX, ns::TY>(sub_encryptor, mx, my, transpose,       \
+                                 accumulate, out);                        \
   }
 
 #define IMPLEMENT_DENSE_MATMUL(RET, TX, TY)                                    \
   template <typename M1, typename M2>                                          \
-  RET DoMatMul##TX##TY(const M1 &mx, const M2 &my, int64_t out_dim,            \
-                       const phe::EvaluatorType &evaluator_ptr) {              \
+  void DoMatMul##TX##TY(const M1 &mx, const M2 &my, int64_t out_dim,           \
+                        const phe::EvaluatorType &evaluator_ptr,               \
+                        bool accumulate, RET *out) {                           \
     int64_t ret_row = mx.rows();                                               \
     int64_t ret_col = my.cols();                                               \
     bool transpose = false;                                                    \
@@ -315,13 +825,23 @@ auto DoCallMatMul(const CLAZZ &sub_evaluator, const M1 &mx, const M2 &my,
       }                                                                        \
     }                                                                          \
                                                                                \
-    RET out(ret_row, ret_col, out_dim);                                        \
+    if (accumulate) {                                                          \
+      YACL_ENFORCE(out->rows() == ret_row && out->cols() == ret_col &&         \
+                       out->ndim() == out_dim,                                 \
+                   "accumulator shape mismatch, expected {}x{} (dim={}), "     \
+                   "actual {}x{} (dim={})",                                    \
+                   ret_row, ret_col, out_dim, out->rows(), out->cols(),        \
+                   out->ndim());                                               \
+    } else {                                                                   \
+      *out = RET(ret_row, ret_col, out_dim);                                   \
+    }                                                                          \
     std::visit(HE_DISPATCH(DO_CALL_MATMUL, TX, TY), evaluator_ptr);            \
-    return out;                                                                \
   }                                                                            \
                                                                                \
-  RET Evaluator::MatMul(const DenseMatrix<phe::TX> &x,                         \
-                        const DenseMatrix<phe::TY> &y) const {                 \
+  void DoMatMul##TX##TY(const DenseMatrixView<phe::TX> &x,                     \
+                        const DenseMatrixView<phe::TY> &y,                     \
+                        const phe::EvaluatorType &evaluator_ptr,               \
+                        bool accumulate, RET *out) {                           \
     YACL_ENFORCE(                                                              \
         x.ndim() > 0 && y.ndim() > 0,                                          \
         "Input operands do not have enough dimensions, x-dim={}, y-dim{}",     \
@@ -336,35 +856,368 @@ auto DoCallMatMul(const CLAZZ &sub_evaluator, const M1 &mx, const M2 &my,
                  "HEU does not support empty tensor currently");               \
                                                                                \
     if (x.ndim() == 1) {                                                       \
-      auto &mx = x.EigenMatrix().transpose();                                  \
-      auto &my = y.EigenMatrix();                                              \
-      return DoMatMul##TX##TY(mx, my, MatmulDim(x_shape, y_shape),             \
-                              evaluator_ptr_);                                 \
+      /* treat vector x as a row vector */                                     \
+      DenseMatrixView<phe::TX> mx(x.data(), 1, x.rows(),                       \
+                                  {0, x.strides()[0]}, 2);                     \
+      DoMatMul##TX##TY(mx, y, MatmulDim(x_shape, y_shape), evaluator_ptr,      \
+                       accumulate, out);                                       \
     } else {                                                                   \
-      auto &mx = x.EigenMatrix();                                              \
-      auto &my = y.EigenMatrix();                                              \
-      return DoMatMul##TX##TY(mx, my, MatmulDim(x_shape, y_shape),             \
-                              evaluator_ptr_);                                 \
+      DoMatMul##TX##TY(x, y, MatmulDim(x_shape, y_shape), evaluator_ptr,       \
+                       accumulate, out);                                       \
     }                                                                          \
+  }                                                                            \
+                                                                               \
+  RET Evaluator::MatMul(const DenseMatrix<phe::TX> &x,                         \
+                        const DenseMatrix<phe::TY> &y) const {                 \
+    return MatMul(DenseMatrixView<phe::TX>(x), DenseMatrixView<phe::TY>(y));   \
+  }                                                                            \
+                                                                               \
+  RET Evaluator::MatMul(const DenseMatrixView<phe::TX> &x,                     \
+                        const DenseMatrixView<phe::TY> &y) const {             \
+    phe::OpStatsScope stats(phe::OpSource::kNumpy, phe::OpKind::kMatMul,       \
+                            MatMulElements(x, y));                             \
+    HEU_TRACE_KERNEL("MatMul", GetSchemaType(), MatMulElements(x, y));         \
+    RET out(0, 0);                                                             \
+    DoMatMul##TX##TY(x, y, evaluator_ptr_, false, &out);                       \
+    return out;                                                                \
+  }                                                                            \
+                                                                               \
+  void Evaluator::MatMulAccumulate(const DenseMatrixView<phe::TX> &x,          \
+                                   const DenseMatrixView<phe::TY> &y,          \
+                                   RET *out) const {                           \
+    YACL_ENFORCE(!SharesStorage(*out, x) && !SharesStorage(*out, y),           \
+                 "MatMulAccumulate: x and y must not overlap with out");       \
+    phe::OpStatsScope stats(phe::OpSource::kNumpy, phe::OpKind::kMatMul,       \
+                            MatMulElements(x, y));                             \
+    HEU_TRACE_KERNEL("MatMul", GetSchemaType(), MatMulElements(x, y));         \
+    DoMatMul##TX##TY(x, y, evaluator_ptr_, true, out);                         \
   }
 
 IMPLEMENT_DENSE_MATMUL(CMatrix, Ciphertext, Plaintext);
 IMPLEMENT_DENSE_MATMUL(CMatrix, Plaintext, Ciphertext);
 IMPLEMENT_DENSE_MATMUL(PMatrix, Plaintext, Plaintext);
 
+/*********   Mul/MatMul by int64 multipliers  ***********/
+template <typename CLAZZ, typename CT>
+using kHasInt64Mul = decltype(std::declval<const CLAZZ &>().Mul(
+    std::declval<const CT &>(), int64_t()));
+
+// Returns a * p. Algorithms without a Mul() for int64 get 'p' converted to
+// their plaintext type PT.
+template <typename PT, typename CT, typename CLAZZ>
+CT MulInt64(const CLAZZ &sub_evaluator, const CT &a, int64_t p,
+            phe::SchemaType schema) {
+  if constexpr (std::experimental::is_detected_v<kHasInt64Mul, CLAZZ, CT>) {
+    return sub_evaluator.Mul(a, p);
+  } else {
+    return sub_evaluator.Mul(a, phe::Plaintext(schema, p).template As<PT>());
+  }
+}
+
+template <typename PT, typename CT, typename CLAZZ>
+void DoCallInt64Mul(const CLAZZ &sub_evaluator, const CMatrixView &x,
+                    std::array<int64_t, 2> x_stride, const IMatrixView &y,
+                    std::array<int64_t, 2> y_stride, phe::SchemaType schema,
+                    CMatrix *out) {
+  const auto *x_base = x.data();
+  const auto *y_base = y.data();
+  auto *out_base = out->data();
+  int64_t rows = out->rows();
+  HEU_TRACE_CAPTURE(trace_ctx);
+  yacl::parallel_for(0, out->size(), 1, [&](int64_t beg, int64_t end) {
+    HEU_TRACE_CHUNK(trace_ctx, beg, end);
+    for (int64_t i = beg; i < end; ++i) {
+      int64_t row = i % rows;
+      int64_t col = i / rows;
+      out_base[i] = phe::Ciphertext(MulInt64<PT>(
+          sub_evaluator,
+          x_base[row * x_stride[0] + col * x_stride[1]].template As<CT>(),
+          y_base[row * y_stride[0] + col * y_stride[1]], schema));
+    }
+  });
+}
+
+CMatrix Evaluator::Mul(const CMatrixView &x, const IMatrixView &y) const {
+  Dimension sx(x);
+  Dimension sy(y);
+  YACL_ENFORCE(sx.IsCompatibleShape(sy),
+               "{} not supported for dim(x)={}, dim(y)={}", __func__,
+               x.shape().ToString(), y.shape().ToString());
+
+  auto sz = sx.ComputeCastShape(sy);
+  phe::OpStatsScope stats(phe::OpSource::kNumpy, phe::OpKind::kMul,
+                          sz.rows * sz.cols);
+  HEU_TRACE_KERNEL("Mul", GetSchemaType(), sz.rows * sz.cols);
+
+  const auto x_stride = ComputeCastStride(x.strides(), sx, sz);
+  const auto y_stride = ComputeCastStride(y.strides(), sy, sz);
+  CMatrix out(sz.rows, sz.cols, sz.ndim);
+  auto schema = GetSchemaType();
+
+#define FUNC(ns)                                                \
+  [&](const ns::Evaluator &sub_evaluator) {                     \
+    DoCallInt64Mul<ns::Plaintext, ns::Ciphertext>(              \
+        sub_evaluator, x, x_stride, y, y_stride, schema, &out); \
+  }
+
+  std::visit(HE_DISPATCH(FUNC), evaluator_ptr_);
+#undef FUNC
+
+  return out;
+}
+
+// One of MX/MY is IMatrixView, the other CMatrixView
+template <typename PT, typename CT, typename CLAZZ, typename MX, typename MY>
+void DoCallInt64MatMul(const CLAZZ &sub_evaluator, const MX &mx, const MY &my,
+                       bool transpose, phe::SchemaType schema, CMatrix *out) {
+  auto mul = [&](int64_t row, int64_t j, int64_t col) {
+    if constexpr (std::is_same_v<typename MX::value_type, int64_t>) {
+      return MulInt64<PT>(sub_evaluator, my(j, col).template As<CT>(),
+                          mx(row, j), schema);
+    } else {
+      return MulInt64<PT>(sub_evaluator, mx(row, j).template As<CT>(),
+                          my(j, col), schema);
+    }
+  };
+
+  out->ForEach([&](int64_t row, int64_t col, phe::Ciphertext *element) {
+    if (transpose) {
+      std::swap(row, col);
+    }
+
+    auto sum = mul(row, 0, col);
+    for (int64_t j = 1; j < mx.cols(); ++j) {
+      sub_evaluator.AddInplace(&sum, mul(row, j, col));
+    }
+    *element = phe::Ciphertext(std::move(sum));
+  });
+}
+
+template <typename MX, typename MY>
+CMatrix DoInt64MatMul(const MX &x, const MY &y,
+                      const phe::EvaluatorType &evaluator_ptr,
+                      phe::SchemaType schema) {
+  YACL_ENFORCE(
+      x.ndim() > 0 && y.ndim() > 0,
+      "Input operands do not have enough dimensions, x-dim={}, y-dim{}",
+      x.ndim(), y.ndim());
+  YACL_ENFORCE(x.shape()[-1] == y.shape()[0],
+               "dimension mismatch for matmul, x-shape={}, y-shape={}",
+               x.shape().ToString(), y.shape().ToString());
+  YACL_ENFORCE(x.size() > 0 || y.size() > 0,
+               "HEU does not support empty tensor currently");
+
+  int64_t out_dim = MatmulDim(x.shape(), y.shape());
+  // treat vector x as a row vector
+  MX mx = x.ndim() == 1 ? MX(x.data(), 1, x.rows(), {0, x.strides()[0]}, 2)
+                        : x;
+  int64_t ret_row = mx.rows();
+  int64_t ret_col = y.cols();
+  bool transpose = false;
+  if (out_dim == 1 && ret_col > 1) {
+    // dim-1 matrix always a vertical vector, keep col==1
+    std::swap(ret_row, ret_col);
+    transpose = true;
+  }
+
+  CMatrix out(ret_row, ret_col, out_dim);
+
+#define FUNC(ns)                                        \
+  [&](const ns::Evaluator &sub_evaluator) {             \
+    DoCallInt64MatMul<ns::Plaintext, ns::Ciphertext>(   \
+        sub_evaluator, mx, y, transpose, schema, &out); \
+  }
+
+  std::visit(HE_DISPATCH(FUNC), evaluator_ptr);
+#undef FUNC
+
+  return out;
+}
+
+CMatrix Evaluator::MatMul(const CMatrixView &x, const IMatrixView &y) const {
+  phe::OpStatsScope stats(phe::OpSource::kNumpy, phe::OpKind::kMatMul,
+                          MatMulElements(x, y));
+  HEU_TRACE_KERNEL("MatMul", GetSchemaType(), MatMulElements(x, y));
+  return DoInt64MatMul(x, y, evaluator_ptr_, GetSchemaType());
+}
+
+CMatrix Evaluator::MatMul(const IMatrixView &x, const CMatrixView &y) const {
+  phe::OpStatsScope stats(phe::OpSource::kNumpy, phe::OpKind::kMatMul,
+                          MatMulElements(x, y));
+  HEU_TRACE_KERNEL("MatMul", GetSchemaType(), MatMulElements(x, y));
+  return DoInt64MatMul(x, y, evaluator_ptr_, GetSchemaType());
+}
+
+/*********   Sparse MatMul  ***********/
+namespace {
+
+enum class SparseTerm : int8_t { kZero, kOne, kMinusOne, kOther };
+
+// Classify the stored values once, so that the kernels do not compare
+// plaintexts for every output element
+std::vector<SparseTerm> ClassifySparseTerms(const PSparseMatrix &m,
+                                            phe::SchemaType schema) {
+  phe::Plaintext one(schema, 1);
+  phe::Plaintext minus_one(schema, -1);
+  std::vector<SparseTerm> res(m.nnz());
+  yacl::parallel_for(0, m.nnz(), kHeOpGrainSize, [&](int64_t beg, int64_t end) {
+    for (int64_t i = beg; i < end; ++i) {
+      const auto &v = m.values()[i];
+      if (v.IsZero()) {
+        res[i] = SparseTerm::kZero;
+      } else if (v == one) {
+        res[i] = SparseTerm::kOne;
+      } else if (v == minus_one) {
+        res[i] = SparseTerm::kMinusOne;
+      } else {
+        res[i] = SparseTerm::kOther;
+      }
+    }
+  });
+  return res;
+}
+
+// Returns 'm' itself if it is already in 'layout', otherwise a converted copy
+// held by 'storage'
+const PSparseMatrix &InLayout(const PSparseMatrix &m,
+                              PSparseMatrix::Layout layout,
+                              std::optional<PSparseMatrix> *storage) {
+  if (m.layout() == layout) {
+    return m;
+  }
+  return storage->emplace(m.ToLayout(layout));
+}
+
+// Dot product of the outer line 'line' of 'm' and the ciphertexts returned by
+// 'get(inner_index)'
+template <typename GET>
+phe::Ciphertext SparseDot(const phe::Evaluator &evaluator,
+                          const PSparseMatrix &m,
+                          const std::vector<SparseTerm> &terms, int64_t line,
+                          const phe::Ciphertext &zero, const GET &get) {
+  phe::Ciphertext acc;
+  bool has_value = false;
+  for (auto p = m.indptr()[line]; p < m.indptr()[line + 1]; ++p) {
+    const phe::Ciphertext &c = get(m.indices()[p]);
+    switch (terms[p]) {
+      case SparseTerm::kZero:
+        continue;
+      case SparseTerm::kOne:
+        if (has_value) {
+          evaluator.AddInplace(&acc, c);
+        } else {
+          acc = c;
+        }
+        break;
+      case SparseTerm::kMinusOne:
+        if (has_value) {
+          evaluator.SubInplace(&acc, c);
+        } else {
+          acc = evaluator.Negate(c);
+        }
+        break;
+      case SparseTerm::kOther:
+        if (has_value) {
+          evaluator.AddInplace(&acc, evaluator.Mul(c, m.values()[p]));
+        } else {
+          acc = evaluator.Mul(c, m.values()[p]);
+        }
+        break;
+    }
+    has_value = true;
+  }
+  return has_value ? acc : zero;
+}
+
+}  // namespace
+
+CMatrix Evaluator::MatMul(const PSparseMatrix &x, const CMatrixView &y) const {
+  YACL_ENFORCE(y.ndim() > 0,
+               "Input operands do not have enough dimensions, y-dim={}",
+               y.ndim());
+  YACL_ENFORCE(x.cols() == y.rows(),
+               "dimension mismatch for matmul, x-shape={}, y-shape={}",
+               x.shape().ToString(), y.shape().ToString());
+  YACL_ENFORCE(y.size() > 0, "HEU does not support empty tensor currently");
+
+  std::optional<PSparseMatrix> storage;
+  const auto &csr = InLayout(x, PSparseMatrix::Layout::kCsr, &storage);
+  auto terms = ClassifySparseTerms(csr, GetSchemaType());
+  // an output without any non-zero term
+  auto zero = phe::Evaluator::Mul(y(0, 0), phe::Plaintext(GetSchemaType(), 0));
+
+  // matrix @ vector is a vector
+  CMatrix out(x.rows(), y.cols(), y.ndim());
+  yacl::parallel_for(0, out.size(), 1, [&](int64_t beg, int64_t end) {
+    for (int64_t i = beg; i < end; ++i) {
+      auto row = i % out.rows();
+      auto col = i / out.rows();
+      out(row, col) = SparseDot(*this, csr, terms, row, zero,
+                                [&](int64_t k) -> const phe::Ciphertext & {
+                                  return y(k, col);
+                                });
+    }
+  });
+  return out;
+}
+
+CMatrix Evaluator::MatMul(const CMatrixView &x, const PSparseMatrix &y) const {
+  YACL_ENFORCE(x.ndim() > 0,
+               "Input operands do not have enough dimensions, x-dim={}",
+               x.ndim());
+  YACL_ENFORCE(x.shape()[-1] == y.rows(),
+               "dimension mismatch for matmul, x-shape={}, y-shape={}",
+               x.shape().ToString(), y.shape().ToString());
+  YACL_ENFORCE(x.size() > 0, "HEU does not support empty tensor currently");
+
+  // treat vector x as a row vector
+  CMatrixView mx = x.ndim() == 1
+                       ? CMatrixView(x.data(), 1, x.rows(),
+                                     {0, x.strides()[0]}, 2)
+                       : x;
+  std::optional<PSparseMatrix> storage;
+  const auto &csc = InLayout(y, PSparseMatrix::Layout::kCsc, &storage);
+  auto terms = ClassifySparseTerms(csc, GetSchemaType());
+  auto zero =
+      phe::Evaluator::Mul(mx(0, 0), phe::Plaintext(GetSchemaType(), 0));
+
+  // vector @ matrix is a vector, which is always a vertical one
+  CMatrix out = x.ndim() == 1 ? CMatrix(y.cols(), 1, 1)
+                              : CMatrix(mx.rows(), y.cols());
+  yacl::parallel_for(0, out.size(), 1, [&](int64_t beg, int64_t end) {
+    for (int64_t i = beg; i < end; ++i) {
+      auto row = x.ndim() == 1 ? 0 : i % out.rows();
+      auto col = x.ndim() == 1 ? i : i / out.rows();
+      out.data()[i] = SparseDot(*this, csc, terms, col, zero,
+                                [&](int64_t k) -> const phe::Ciphertext & {
+                                  return mx(row, k);
+                                });
+    }
+  });
+  return out;
+}
+
 template <typename T>
 T Evaluator::Sum(const DenseMatrix<T> &x) const {
+  return Sum(DenseMatrixView<T>(x));
+}
+
+template <typename T>
+T Evaluator::Sum(const DenseMatrixView<T> &x) const {
   YACL_ENFORCE(x.cols() > 0 && x.rows() > 0,
                "you cannot sum an empty tensor, shape={}x{}", x.rows(),
                x.cols());
+  phe::OpStatsScope stats(phe::OpSource::kNumpy, phe::OpKind::kSum, x.size());
+  HEU_TRACE_KERNEL("Sum", GetSchemaType(), x.size());
+  HEU_TRACE_CAPTURE(trace_ctx);
 
-  auto buf = x.data();
   return yacl::parallel_reduce<T>(
       0, x.size(), kHeOpGrainSize,
       [&](int64_t beg, int64_t end) {
-        T sum = buf[beg];
+        HEU_TRACE_CHUNK(trace_ctx, beg, end);
+        T sum = x[beg];
         for (auto i = beg + 1; i < end; ++i) {
-          phe::Evaluator::AddInplace(&sum, buf[i]);
+          phe::Evaluator::AddInplace(&sum, x[i]);
         }
         return sum;
       },
@@ -374,6 +1227,88 @@ T Evaluator::Sum(const DenseMatrix<T> &x) const {
 
 template phe::Ciphertext Evaluator::Sum(const CMatrix &) const;
 template phe::Plaintext Evaluator::Sum(const PMatrix &) const;
+template phe::Ciphertext Evaluator::Sum(const CMatrixView &) const;
+template phe::Plaintext Evaluator::Sum(const PMatrixView &) const;
+
+/*********   AlignExponents  ***********/
+template <typename CLAZZ, typename CT>
+using kHasAlignExponents =
+    decltype(std::declval<const CLAZZ &>().AlignExponents(
+        absl::Span<CT *const>(), std::declval<int>()));
+
+template <typename CLAZZ, typename CT>
+auto DoCallAlignExponents(const CLAZZ &sub_evaluator,
+                          absl::Span<CMatrix *const> xs)
+    -> std::enable_if_t<
+        std::experimental::is_detected_v<kHasAlignExponents, CLAZZ, CT>> {
+  // step 1: find the common exponent of all matrices
+  int new_exp = std::numeric_limits<int>::max();
+  for (const auto *x : xs) {
+    const auto *buf = x->data();
+    new_exp = std::min(
+        new_exp,
+        yacl::parallel_reduce<int>(
+            0, x->size(), kHeOpGrainSize,
+            [&](int64_t beg, int64_t end) {
+              std::vector<const CT *> cts;
+              cts.reserve(end - beg);
+              for (int64_t i = beg; i < end; ++i) {
+                cts.push_back(&(buf[i].template As<CT>()));
+              }
+              return sub_evaluator.MinExponent(cts);
+            },
+            [](int a, int b) { return std::min(a, b); }));
+  }
+
+  // step 2: align every chunk to the common exponent
+  for (auto *x : xs) {
+    auto *buf = x->data();
+    yacl::parallel_for(0, x->size(), 1, [&](int64_t beg, int64_t end) {
+      std::vector<CT *> cts;
+      cts.reserve(end - beg);
+      for (int64_t i = beg; i < end; ++i) {
+        cts.push_back(&(buf[i].template As<CT>()));
+      }
+      sub_evaluator.AlignExponents(absl::MakeSpan(cts), new_exp);
+    });
+  }
+}
+
+template <typename CLAZZ, typename CT>
+auto DoCallAlignExponents(const CLAZZ &, absl::Span<CMatrix *const>)
+    -> std::enable_if_t<
+        !std::experimental::is_detected_v<kHasAlignExponents, CLAZZ, CT>> {
+  // ciphertexts of this schema have no exponent, nothing to do
+}
+
+#define DO_CALL_ALIGN_EXPONENTS(ns)                      \
+  [&](const ns::Evaluator &sub_evaluator) {              \
+    DoCallAlignExponents<ns::Evaluator, ns::Ciphertext>( \
+        sub_evaluator, absl::MakeSpan(xs));              \
+  }
+
+void Evaluator::AlignExponentsInplace(CMatrix *x) const {
+  if (x->size() == 0) {
+    return;
+  }
+
+  CMatrix *xs[] = {x};
+  std::visit(HE_DISPATCH(DO_CALL_ALIGN_EXPONENTS), evaluator_ptr_);
+}
+
+void Evaluator::AlignExponentsInplace(CMatrix *x, CMatrix *y) const {
+  if (x->size() == 0) {
+    AlignExponentsInplace(y);
+    return;
+  }
+  if (y->size() == 0) {
+    AlignExponentsInplace(x);
+    return;
+  }
+
+  CMatrix *xs[] = {x, y};
+  std::visit(HE_DISPATCH(DO_CALL_ALIGN_EXPONENTS), evaluator_ptr_);
+}
 
 template <typename T>
 DenseMatrix<T> Evaluator::FeatureWiseBucketSum(
@@ -416,16 +1351,25 @@ void Evaluator::FeatureWiseBucketSumInplace(
 
   YACL_ENFORCE_EQ(total_bucket_num, res.rows());
   YACL_ENFORCE_EQ(x.cols(), res.cols());
+  phe::OpStatsScope stats(phe::OpSource::kNumpy, phe::OpKind::kBucketSum,
+                          x.size());
+  HEU_TRACE_KERNEL("FeatureWiseBucketSum", GetSchemaType(), x.size());
+  HEU_TRACE_CAPTURE(trace_ctx);
   T zero = GetZero(x);
   // could made this parallel
   for (auto col = 0; col < x.cols(); ++col) {
+    HEU_TRACE_SERIAL("FeatureWiseBucketSum.column", col, col + 1);
     // feature wise calculations, could be made parallel
     yacl::parallel_for(0, feature_num, 1, [&](int64_t beg_f, int64_t end_f) {
+      HEU_TRACE_CHUNK(trace_ctx, beg_f, end_f);
       for (auto feature_index = beg_f; feature_index < end_f; ++feature_index) {
         auto start_offset = bucket_num * feature_index;
         auto bucket_sums = yacl::parallel_reduce<std::vector<T>>(
             0, x.rows(), 4 * kHeOpGrainSize,
             [&](int64_t beg, int64_t end) {
+              // [beg, end) are rows here, not features
+              HEU_TRACE_NAMED_CHUNK(trace_ctx, "FeatureWiseBucketSum.rows",
+                                    beg, end);
               auto sums = std::vector<T>(bucket_num, zero);
               for (auto i = beg; i < end; ++i) {
                 phe::Evaluator::AddInplace(&sums[order_map(i, feature_index)],
@@ -464,4 +1408,160 @@ template void Evaluator::FeatureWiseBucketSumInplace(
 template void Evaluator::FeatureWiseBucketSumInplace(
     const PMatrix &, const Eigen::Ref<RowMatrixXd> &order_map, int bucket_num,
     PMatrix &res, bool cumsum) const;
+
+/*********   Out-of-core  ***********/
+namespace {
+
+// Call fn(begin, count) for each chunk of [0, total)
+template <typename F>
+void ForEachChunk(int64_t total, int64_t chunk_size, const F &fn) {
+  YACL_ENFORCE(chunk_size > 0, "chunk_size must be positive, actual {}",
+               chunk_size);
+  for (int64_t beg = 0; beg < total; beg += chunk_size) {
+    fn(beg, std::min(chunk_size, total - beg));
+  }
+}
+
+// Number of rows per chunk of a matrix streamed by rows
+int64_t RowsPerChunk(int64_t chunk_size, int64_t cols) {
+  return std::max<int64_t>(1, chunk_size / std::max<int64_t>(cols, 1));
+}
+
+}  // namespace
+
+void Evaluator::Add(const MappedCMatrix &x, const MappedCMatrix &y,
+                    MappedCMatrix *out, int64_t chunk_size) const {
+  YACL_ENFORCE(x.rows() == y.rows() && x.cols() == y.cols() &&
+                   x.rows() == out->rows() && x.cols() == out->cols(),
+               "shape mismatch, x={}, y={}, out={}", x.shape().ToString(),
+               y.shape().ToString(), out->shape().ToString());
+
+  ForEachChunk(x.size(), chunk_size, [&](int64_t beg, int64_t n) {
+    x.Prefetch(beg + n, beg + n + chunk_size);
+    y.Prefetch(beg + n, beg + n + chunk_size);
+    CMatrix cx(n, 1, 1);
+    CMatrix cy(n, 1, 1);
+    x.Read(beg, absl::MakeSpan(cx.data(), n));
+    y.Read(beg, absl::MakeSpan(cy.data(), n));
+    auto res = Add(cx, cy);
+    out->Write(beg, absl::MakeConstSpan(res.data(), n));
+
+    x.Evict(beg, beg + n);
+    y.Evict(beg, beg + n);
+    out->Evict(beg, beg + n);
+  });
+}
+
+phe::Ciphertext Evaluator::Sum(const MappedCMatrix &x,
+                               int64_t chunk_size) const {
+  YACL_ENFORCE(x.size() > 0, "you cannot sum an empty tensor, shape={}x{}",
+               x.rows(), x.cols());
+
+  phe::Ciphertext res;
+  ForEachChunk(x.size(), chunk_size, [&](int64_t beg, int64_t n) {
+    x.Prefetch(beg + n, beg + n + chunk_size);
+    CMatrix cx(n, 1, 1);
+    x.Read(beg, absl::MakeSpan(cx.data(), n));
+    if (beg == 0) {
+      res = Sum(cx);
+    } else {
+      AddInplace(&res, Sum(cx));
+    }
+    x.Evict(beg, beg + n);
+  });
+  return res;
+}
+
+void Evaluator::MatMul(const MappedCMatrix &x, const PMatrixView &y,
+                       MappedCMatrix *out, int64_t chunk_size) const {
+  YACL_ENFORCE(x.ndim() == 2 && y.ndim() > 0,
+               "streamed matmul needs a 2-d x and a non-scalar y, x-dim={}, "
+               "y-dim={}",
+               x.ndim(), y.ndim());
+  YACL_ENFORCE(x.cols() == y.rows(),
+               "dimension mismatch for matmul, x-shape={}, y-shape={}",
+               x.shape().ToString(), y.shape().ToString());
+  YACL_ENFORCE(out->rows() == x.rows() && out->cols() == y.cols() &&
+                   out->ndim() == y.ndim(),
+               "out shape mismatch, expected {}x{} (dim={}), actual {}",
+               x.rows(), y.cols(), y.ndim(), out->shape().ToString());
+
+  auto step = RowsPerChunk(chunk_size, x.cols());
+  ForEachChunk(x.rows(), step, [&](int64_t row, int64_t n) {
+    x.PrefetchRows(row + n, step);
+    auto block = x.ReadRows(row, n);
+    out->WriteRows(row, MatMul(block, y));
+
+    x.EvictRows(row, n);
+    out->EvictRows(row, n);
+  });
+}
+
+CMatrix Evaluator::MatMul(const PMatrixView &x, const MappedCMatrix &y,
+                          int64_t chunk_size) const {
+  YACL_ENFORCE(x.ndim() > 0 && y.ndim() > 0,
+               "Input operands do not have enough dimensions, x-dim={}, "
+               "y-dim={}",
+               x.ndim(), y.ndim());
+  YACL_ENFORCE(x.shape()[-1] == y.rows() && y.size() > 0,
+               "dimension mismatch for matmul, x-shape={}, y-shape={}",
+               x.shape().ToString(), y.shape().ToString());
+
+  // out = sum of x[:, rows] @ y[rows, :] over the row blocks of y
+  CMatrix out(0, 0);
+  auto step = RowsPerChunk(chunk_size, y.cols());
+  ForEachChunk(y.rows(), step, [&](int64_t row, int64_t n) {
+    y.PrefetchRows(row + n, step);
+    auto block = y.ReadRows(row, n);
+    auto xs = x.ndim() == 1 ? x.Slice({row, n})
+                            : x.Slice({0, x.rows()}, {row, n});
+    if (row == 0) {
+      out = MatMul(xs, block);
+    } else {
+      MatMulAccumulate(xs, block, &out);
+    }
+    y.EvictRows(row, n);
+  });
+  return out;
+}
+
+CMatrix Evaluator::FeatureWiseBucketSum(
+    const MappedCMatrix &x, const Eigen::Ref<RowMatrixXd> &order_map,
+    int bucket_num, bool cumsum, int64_t chunk_size) const {
+  YACL_ENFORCE(x.cols() > 0 && x.rows() > 0,
+               "you cannot sum an empty tensor, shape={}x{}", x.rows(),
+               x.cols());
+  YACL_ENFORCE_EQ(order_map.rows(), x.rows(),
+                  "order map and x should have same number of rows.");
+
+  CMatrix res(0, 0);
+  auto step = RowsPerChunk(chunk_size, x.cols());
+  ForEachChunk(x.rows(), step, [&](int64_t row, int64_t n) {
+    x.PrefetchRows(row + n, step);
+    auto block = x.ReadRows(row, n);
+    auto part = FeatureWiseBucketSum(block, order_map.middleRows(row, n),
+                                     bucket_num, false);
+    if (row == 0) {
+      res = std::move(part);
+    } else {
+      AddInplace(&res, part);
+    }
+    x.EvictRows(row, n);
+  });
+
+  if (cumsum) {
+    int64_t feature_num = order_map.cols();
+    yacl::parallel_for(
+        0, feature_num * res.cols(), 1, [&](int64_t beg, int64_t end) {
+          for (int64_t i = beg; i < end; ++i) {
+            auto offset = (i % feature_num) * bucket_num;
+            auto col = i / feature_num;
+            for (int j = 1; j < bucket_num; ++j) {
+              AddInplace(&res(offset + j, col), res(offset + j - 1, col));
+            }
+          }
+        });
+  }
+  return res;
+}
 }  // namespace heu::lib::numpy
@@ -14,10 +14,35 @@
 
 #pragma once
 
+#include <variant>
+#include <vector>
+
+#include "heu/library/numpy/mapped_matrix.h"
 #include "heu/library/numpy/matrix.h"
+#include "heu/library/numpy/sparse_matrix.h"
 #include "heu/library/phe/phe.h"
 
 namespace heu::lib::numpy {
+
+// A chain of element-wise ops that is evaluated in one pass, see
+// Evaluator::EvalElementwise().
+//
+// Registers [0, inputs.size()) hold the inputs, instruction i writes register
+// inputs.size() + i and the last instruction produces the result. Inputs are
+// broadcast to the shape of the output.
+struct ElementwiseProgram {
+  enum class Op { kAdd, kSub, kMul };
+
+  struct Instr {
+    Op op;
+    size_t lhs;  // register index
+    size_t rhs;  // register index
+  };
+
+  std::vector<std::variant<CMatrixView, PMatrixView>> inputs;
+  std::vector<Instr> instrs;
+};
+
 using RowMatrixXd = const Eigen::Matrix<int8_t, Eigen::Dynamic, Eigen::Dynamic,
                                         Eigen::RowMajor>;
 using RowVector = const Eigen::Matrix<int8_t, 1, Eigen::Dynamic>;
@@ -49,9 +74,79 @@ class Evaluator : public phe::Evaluator {
   CMatrix MatMul(const PMatrix &x, const CMatrix &y) const;
   PMatrix MatMul(const PMatrix &x, const PMatrix &y) const;
 
+  // Same as above, but the operands are views (slices or transposes) of
+  // existing matrices, which are read in place without copying
+  CMatrix Add(const CMatrixView &x, const CMatrixView &y) const;
+  CMatrix Add(const CMatrixView &x, const PMatrixView &y) const;
+  CMatrix Add(const PMatrixView &x, const CMatrixView &y) const;
+  PMatrix Add(const PMatrixView &x, const PMatrixView &y) const;
+
+  CMatrix Sub(const CMatrixView &x, const CMatrixView &y) const;
+  CMatrix Sub(const CMatrixView &x, const PMatrixView &y) const;
+  CMatrix Sub(const PMatrixView &x, const CMatrixView &y) const;
+  PMatrix Sub(const PMatrixView &x, const PMatrixView &y) const;
+
+  CMatrix Mul(const CMatrixView &x, const PMatrixView &y) const;
+  CMatrix Mul(const PMatrixView &x, const CMatrixView &y) const;
+  PMatrix Mul(const PMatrixView &x, const PMatrixView &y) const;
+
+  CMatrix MatMul(const CMatrixView &x, const PMatrixView &y) const;
+  CMatrix MatMul(const PMatrixView &x, const CMatrixView &y) const;
+  PMatrix MatMul(const PMatrixView &x, const PMatrixView &y) const;
+
+  // Same as above with int64 multipliers, see IMatrix. Algorithms without a
+  // Mul() for int64 get each multiplier converted to their plaintext.
+  CMatrix Mul(const CMatrixView &x, const IMatrixView &y) const;
+  CMatrix MatMul(const CMatrixView &x, const IMatrixView &y) const;
+  CMatrix MatMul(const IMatrixView &x, const CMatrixView &y) const;
+
+  // In-place cwise ops: x = x op y. y is broadcast to the shape of x, it must
+  // not overlap with the storage of x.
+  using phe::Evaluator::AddInplace;
+  void AddInplace(CMatrix *x, const CMatrixView &y) const;
+  void AddInplace(CMatrix *x, const PMatrixView &y) const;
+  void AddInplace(PMatrix *x, const PMatrixView &y) const;
+
+  using phe::Evaluator::SubInplace;
+  void SubInplace(CMatrix *x, const CMatrixView &y) const;
+  void SubInplace(CMatrix *x, const PMatrixView &y) const;
+  void SubInplace(PMatrix *x, const PMatrixView &y) const;
+
+  using phe::Evaluator::MulInplace;
+  void MulInplace(CMatrix *x, const PMatrixView &y) const;
+  void MulInplace(PMatrix *x, const PMatrixView &y) const;
+
+  // Fused y = a * x + y without materializing a * x. a and x are broadcast to
+  // the shape of y, e.g. 'a' may be a 1x1 scalar. x must not overlap with y.
+  void Axpy(const PMatrixView &a, const CMatrixView &x, CMatrix *y) const;
+
+  // Fused out = out + x @ y, 'out' must have the shape of MatMul(x, y) and
+  // must not overlap with x or y
+  void MatMulAccumulate(const CMatrixView &x, const PMatrixView &y,
+                        CMatrix *out) const;
+  void MatMulAccumulate(const PMatrixView &x, const CMatrixView &y,
+                        CMatrix *out) const;
+  void MatMulAccumulate(const PMatrixView &x, const PMatrixView &y,
+                        PMatrix *out) const;
+
+  // Sparse @ dense, only the stored non-zeros of the sparse operand are
+  // visited. Entries equal to 1 or -1 are applied as add/sub of the
+  // ciphertext instead of a multiplication.
+  CMatrix MatMul(const PSparseMatrix &x, const CMatrixView &y) const;
+  CMatrix MatMul(const CMatrixView &x, const PSparseMatrix &y) const;
+
+  // Run 'program' in one parallel pass over 'out', intermediate results only
+  // live for one chunk of elements. 'out' must be allocated by the caller.
+  // Supported ops are the same as above, a ciphertext operand of Add/Mul must
+  // be the lhs.
+  void EvalElementwise(const ElementwiseProgram &program, CMatrix *out) const;
+  void EvalElementwise(const ElementwiseProgram &program, PMatrix *out) const;
+
   // reduce add
   template <typename T>
   T Sum(const DenseMatrix<T> &x) const;  // x is PMatrix or CMatrix
+  template <typename T>
+  T Sum(const DenseMatrixView<T> &x) const;
 
   // reduce add given indices
   template <typename T, typename RowIndices, typename ColIndices>
@@ -81,6 +176,36 @@ class Evaluator : public phe::Evaluator {
                                    int bucket_num, DenseMatrix<T> &res,
                                    bool cumsum = false) const;
 
+  // Out-of-core ops on file-backed matrices.
+  // The MappedCMatrix operands are streamed in chunks of about 'chunk_size'
+  // elements (whole rows for MatMul and FeatureWiseBucketSum): the next chunk
+  // is prefetched, the current one is decoded, computed, written to 'out'
+  // and evicted. Memory use is bounded by the chunk size, not by the matrix
+  // size. 'out' must be created with the shape of the result.
+  void Add(const MappedCMatrix &x, const MappedCMatrix &y, MappedCMatrix *out,
+           int64_t chunk_size = kMappedChunkSize) const;
+  phe::Ciphertext Sum(const MappedCMatrix &x,
+                      int64_t chunk_size = kMappedChunkSize) const;
+  // x is streamed by row blocks, x must be 2-d
+  void MatMul(const MappedCMatrix &x, const PMatrixView &y, MappedCMatrix *out,
+              int64_t chunk_size = kMappedChunkSize) const;
+  // y is streamed by row blocks, the result is small and kept in memory
+  CMatrix MatMul(const PMatrixView &x, const MappedCMatrix &y,
+                 int64_t chunk_size = kMappedChunkSize) const;
+  CMatrix FeatureWiseBucketSum(const MappedCMatrix &x,
+                               const Eigen::Ref<RowMatrixXd> &order_map,
+                               int bucket_num, bool cumsum = false,
+                               int64_t chunk_size = kMappedChunkSize) const;
+
+  // Align the exponents of all ciphertexts in x (and y) to a common value in
+  // one pass. Only FPaillier ciphertexts carry an exponent, for other schemas
+  // this is a no-op.
+  // Element-wise Add/Sub re-align two FPaillier ciphertexts with an
+  // exponentiation whenever their exponents differ, so aligning the operands
+  // once makes all subsequent Add/Sub between them take the fast path.
+  void AlignExponentsInplace(CMatrix *x) const;
+  void AlignExponentsInplace(CMatrix *x, CMatrix *y) const;
+
   template <typename T>
   T GetZero(const DenseMatrix<T> &x) const {
     return phe::Evaluator::Sub(x(0, 0), x(0, 0));
@@ -0,0 +1,131 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "heu/library/numpy/executor.h"
+
+#include <algorithm>
+
+namespace heu::lib::numpy {
+
+namespace internal {
+
+bool TaskBase::Start() {
+  std::lock_guard<std::mutex> guard(mutex_);
+  if (cancelled_) {
+    return false;
+  }
+  started_ = true;
+  return true;
+}
+
+bool TaskBase::Cancel() {
+  std::function<void()> hook;
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (started_ || cancelled_) {
+      return cancelled_;
+    }
+    cancelled_ = true;
+    hook = std::move(cancel_hook_);
+  }
+  OnCancel();
+  if (hook) {
+    hook();
+  }
+  return true;
+}
+
+bool TaskBase::IsCancelled() const {
+  std::lock_guard<std::mutex> guard(mutex_);
+  return cancelled_;
+}
+
+void TaskBase::SetCancelHook(std::function<void()> hook) {
+  std::lock_guard<std::mutex> guard(mutex_);
+  cancel_hook_ = std::move(hook);
+}
+
+}  // namespace internal
+
+HeExecutor::HeExecutor(size_t num_workers, size_t max_pending)
+    : max_pending_(max_pending) {
+  YACL_ENFORCE(num_workers > 0, "HeExecutor needs at least one worker");
+  YACL_ENFORCE(max_pending > 0, "max_pending must be positive");
+  workers_.reserve(num_workers);
+  for (size_t i = 0; i < num_workers; ++i) {
+    workers_.emplace_back([this] { WorkerLoop(); });
+  }
+}
+
+HeExecutor::~HeExecutor() { Shutdown(); }
+
+void HeExecutor::Shutdown() {
+  {
+    std::lock_guard<std::mutex> guard(mutex_);
+    stopped_ = true;
+  }
+  not_empty_.notify_all();
+  not_full_.notify_all();
+  for (auto &worker : workers_) {
+    if (worker.joinable()) {
+      worker.join();
+    }
+  }
+}
+
+void HeExecutor::Enqueue(std::shared_ptr<internal::TaskBase> task) {
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_full_.wait(lock, [this] {
+      // cancelled tasks give their slots back
+      auto cancelled = [](const auto &t) { return t->IsCancelled(); };
+      queue_.erase(std::remove_if(queue_.begin(), queue_.end(), cancelled),
+                   queue_.end());
+      return stopped_ || queue_.size() < max_pending_;
+    });
+    YACL_ENFORCE(!stopped_, "cannot submit tasks to a shut down HeExecutor");
+    // A queued task is cancelled from outside, wake up the producers waiting
+    // for its slot. Taking the lock first makes sure a producer that has just
+    // seen the task alive is already waiting. The task is not started, so
+    // the executor is still alive: Shutdown() starts every queued task
+    // before joining the workers.
+    task->SetCancelHook([this] {
+      { std::lock_guard<std::mutex> guard(mutex_); }
+      not_full_.notify_all();
+    });
+    queue_.push_back(std::move(task));
+  }
+  not_empty_.notify_one();
+}
+
+void HeExecutor::WorkerLoop() {
+  while (true) {
+    std::shared_ptr<internal::TaskBase> task;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      not_empty_.wait(lock, [this] { return stopped_ || !queue_.empty(); });
+      if (queue_.empty()) {
+        return;  // stopped and drained
+      }
+      task = std::move(queue_.front());
+      queue_.pop_front();
+    }
+    not_full_.notify_one();
+    if (task->Start()) {
+      task->Run();
+    }
+  }
+}
+
+}  // namespace heu::lib::numpy
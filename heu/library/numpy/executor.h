@@ -0,0 +1,189 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "yacl/base/exception.h"
+
+namespace heu::lib::numpy {
+
+namespace internal {
+
+class TaskBase {
+ public:
+  virtual ~TaskBase() = default;
+
+  // Marks the task as running, returns false if it was cancelled
+  bool Start();
+  // Returns false if the task is already running or finished
+  bool Cancel();
+  bool IsCancelled() const;
+  // 'hook' is called after the task is cancelled, outside of any lock
+  void SetCancelHook(std::function<void()> hook);
+
+  virtual void Run() = 0;
+
+ protected:
+  // Called once by Cancel()
+  virtual void OnCancel() = 0;
+
+ private:
+  mutable std::mutex mutex_;
+  bool started_ = false;
+  bool cancelled_ = false;
+  std::function<void()> cancel_hook_;
+};
+
+template <typename T>
+class Task : public TaskBase {
+ public:
+  explicit Task(std::function<T()> fn) : fn_(std::move(fn)) {}
+
+  std::future<T> GetFuture() { return promise_.get_future(); }
+
+  void Run() override {
+    try {
+      if constexpr (std::is_void_v<T>) {
+        fn_();
+        promise_.set_value();
+      } else {
+        promise_.set_value(fn_());
+      }
+    } catch (...) {
+      promise_.set_exception(std::current_exception());
+    }
+    // free the captured inputs as soon as possible
+    fn_ = nullptr;
+  }
+
+ protected:
+  void OnCancel() override {
+    try {
+      YACL_THROW("task is cancelled before it starts");
+    } catch (...) {
+      promise_.set_exception(std::current_exception());
+    }
+    fn_ = nullptr;
+  }
+
+ private:
+  std::function<T()> fn_;
+  std::promise<T> promise_;
+};
+
+}  // namespace internal
+
+// Handle of a task submitted to HeExecutor
+template <typename T>
+class HeFuture {
+ public:
+  HeFuture() = default;
+
+  [[nodiscard]] bool Valid() const { return future_.valid(); }
+
+  // Non-blocking, true if the task is finished or cancelled
+  [[nodiscard]] bool IsReady() const {
+    return future_.wait_for(std::chrono::seconds(0)) ==
+           std::future_status::ready;
+  }
+
+  void Wait() const { future_.wait(); }
+
+  // Blocks until the task is done, then returns its result or rethrows the
+  // exception it raised. Get() of a cancelled task throws yacl::Exception.
+  // Can only be called once.
+  T Get() { return future_.get(); }
+
+  // Cancel the task if no worker has picked it up. Returns false if the task
+  // is already running or finished, in which case it runs to the end.
+  bool Cancel() {
+    YACL_ENFORCE(task_ != nullptr, "cannot cancel an empty HeFuture");
+    return task_->Cancel();
+  }
+
+ private:
+  friend class HeExecutor;
+
+  HeFuture(std::shared_ptr<internal::TaskBase> task, std::future<T> future)
+      : task_(std::move(task)), future_(std::move(future)) {}
+
+  std::shared_ptr<internal::TaskBase> task_;
+  std::future<T> future_;
+};
+
+// A small pool of threads dedicated to HE jobs, so that callers can overlap
+// HE computation with other work, e.g. encrypt batch i+1 while batch i is
+// being sent and batch i-1 is being decrypted:
+//
+//   HeExecutor executor;
+//   auto ct = executor.Submit([&] { return encryptor.Encrypt(pt); });
+//   ...  // do something else
+//   Send(ct.Get());
+//
+// HE ops on matrices are already parallel inside, so one worker is usually
+// enough. More workers let independent small jobs run side by side.
+//
+// At most 'max_pending' tasks wait in the queue, Submit() blocks while the
+// queue is full. This bounds the memory held by inputs of queued tasks.
+// Inputs captured by reference must outlive the task.
+class HeExecutor {
+ public:
+  explicit HeExecutor(size_t num_workers = 1, size_t max_pending = 4);
+  // Waits for all queued tasks, see Shutdown()
+  ~HeExecutor();
+
+  HeExecutor(const HeExecutor &) = delete;
+  HeExecutor &operator=(const HeExecutor &) = delete;
+
+  template <typename F, typename T = std::invoke_result_t<std::decay_t<F>>>
+  HeFuture<T> Submit(F &&fn) {
+    auto task = std::make_shared<internal::Task<T>>(std::forward<F>(fn));
+    auto future = task->GetFuture();
+    Enqueue(task);
+    return HeFuture<T>(std::move(task), std::move(future));
+  }
+
+  // Stop accepting new tasks, run the queued ones and join all workers.
+  // Submit() after Shutdown() throws.
+  void Shutdown();
+
+  [[nodiscard]] size_t NumWorkers() const { return workers_.size(); }
+  [[nodiscard]] size_t MaxPending() const { return max_pending_; }
+
+ private:
+  void Enqueue(std::shared_ptr<internal::TaskBase> task);
+  void WorkerLoop();
+
+  size_t max_pending_;
+  std::mutex mutex_;
+  std::condition_variable not_empty_;
+  std::condition_variable not_full_;
+  std::deque<std::shared_ptr<internal::TaskBase>> queue_;
+  bool stopped_ = false;
+  std::vector<std::thread> workers_;
+};
+
+}  // namespace heu::lib::numpy
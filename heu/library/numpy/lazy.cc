@@ -0,0 +1,391 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "heu/library/numpy/lazy.h"
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <unordered_map>
+#include <utility>
+
+namespace heu::lib::numpy {
+
+namespace internal {
+
+struct ExprNode {
+  ExprOp op;
+  bool is_cipher;
+  Eigen::Index rows;
+  Eigen::Index cols;
+  int64_t ndim;
+  std::shared_ptr<const ExprNode> lhs;
+  std::shared_ptr<const ExprNode> rhs;
+  // only valid for kInput
+  std::variant<std::monostate, CMatrixView, PMatrixView> input;
+};
+
+}  // namespace internal
+
+using internal::ExprNode;
+using internal::ExprOp;
+
+int64_t LazyTensor::ndim() const { return node_->ndim; }
+
+Eigen::Index LazyTensor::rows() const { return node_->rows; }
+
+Eigen::Index LazyTensor::cols() const { return node_->cols; }
+
+Shape LazyTensor::shape() const {
+  std::vector<int64_t> res = {node_->rows, node_->cols};
+  res.resize(node_->ndim);
+  return Shape(res);
+}
+
+bool LazyTensor::IsCiphertext() const { return node_->is_cipher; }
+
+LazyTensor LazyEvaluator::Intern(const NodeKey &key, ExprNode &&node) {
+  auto it = nodes_.find(key);
+  if (it != nodes_.end()) {
+    if (auto exist = it->second.lock()) {
+      return LazyTensor(std::move(exist));
+    }
+  }
+
+  // Drop the entries of released graphs, e.g. the graph of the last
+  // training iteration. The threshold doubles with the live nodes, so the
+  // cost is amortized O(1) per node and the table stays within 2x the live
+  // nodes.
+  if (nodes_.size() >= sweep_threshold_) {
+    for (auto iter = nodes_.begin(); iter != nodes_.end();) {
+      iter = iter->second.expired() ? nodes_.erase(iter) : std::next(iter);
+    }
+    sweep_threshold_ = std::max(kMinSweepThreshold, 2 * nodes_.size());
+  }
+
+  auto res = std::make_shared<const ExprNode>(std::move(node));
+  nodes_[key] = res;
+  return LazyTensor(std::move(res));
+}
+
+LazyTensor LazyEvaluator::Input(const CMatrixView &x) {
+  return Intern({ExprOp::kInput, x.data(), nullptr, x.rows(), x.cols(),
+                 x.strides()[0], x.strides()[1], x.ndim()},
+                {ExprOp::kInput, true, x.rows(), x.cols(), x.ndim(), nullptr,
+                 nullptr, x});
+}
+
+LazyTensor LazyEvaluator::Input(const PMatrixView &x) {
+  return Intern({ExprOp::kInput, x.data(), nullptr, x.rows(), x.cols(),
+                 x.strides()[0], x.strides()[1], x.ndim()},
+                {ExprOp::kInput, false, x.rows(), x.cols(), x.ndim(), nullptr,
+                 nullptr, x});
+}
+
+LazyTensor LazyEvaluator::Elementwise(ExprOp op, const LazyTensor &x,
+                                      const LazyTensor &y) {
+  const auto *nx = x.node_.get();
+  const auto *ny = y.node_.get();
+  YACL_ENFORCE(op != ExprOp::kMul || !nx->is_cipher || !ny->is_cipher,
+               "cannot multiply two ciphertext tensors");
+  YACL_ENFORCE((nx->rows == 1 || ny->rows == 1 || nx->rows == ny->rows) &&
+                   (nx->cols == 1 || ny->cols == 1 || nx->cols == ny->cols),
+               "operands could not be broadcast together with shapes {} {}",
+               x.shape().ToString(), y.shape().ToString());
+
+  // element-wise add/mul are commutative, keep the ciphertext on the left,
+  // which is what the kernels support
+  if (op != ExprOp::kSub && !nx->is_cipher && ny->is_cipher) {
+    std::swap(nx, ny);
+  }
+  auto rows = std::max(nx->rows, ny->rows);
+  auto cols = std::max(nx->cols, ny->cols);
+  auto ndim = std::max(nx->ndim, ny->ndim);
+  auto lhs = nx == x.node_.get() ? x.node_ : y.node_;
+  auto rhs = nx == x.node_.get() ? y.node_ : x.node_;
+  return Intern({op, nx, ny, 0, 0, 0, 0, 0},
+                {op, nx->is_cipher || ny->is_cipher, rows, cols, ndim,
+                 std::move(lhs), std::move(rhs), std::monostate()});
+}
+
+LazyTensor LazyEvaluator::Add(const LazyTensor &x, const LazyTensor &y) {
+  return Elementwise(ExprOp::kAdd, x, y);
+}
+
+LazyTensor LazyEvaluator::Sub(const LazyTensor &x, const LazyTensor &y) {
+  return Elementwise(ExprOp::kSub, x, y);
+}
+
+LazyTensor LazyEvaluator::Mul(const LazyTensor &x, const LazyTensor &y) {
+  return Elementwise(ExprOp::kMul, x, y);
+}
+
+LazyTensor LazyEvaluator::MatMul(const LazyTensor &x, const LazyTensor &y) {
+  const auto &nx = *x.node_;
+  const auto &ny = *y.node_;
+  YACL_ENFORCE(!nx.is_cipher || !ny.is_cipher,
+               "cannot multiply two ciphertext tensors");
+  YACL_ENFORCE(
+      nx.ndim > 0 && ny.ndim > 0,
+      "Input operands do not have enough dimensions, x-dim={}, y-dim{}",
+      nx.ndim, ny.ndim);
+  auto x_shape = x.shape();
+  auto y_shape = y.shape();
+  YACL_ENFORCE(x_shape[-1] == y_shape[0],
+               "dimension mismatch for matmul, x-shape={}, y-shape={}",
+               x_shape.ToString(), y_shape.ToString());
+
+  // same as Evaluator::MatMul(), a vector x is treated as a row vector and a
+  // 1-d result is always a column vector
+  Eigen::Index rows = nx.ndim == 1 ? 1 : nx.rows;
+  Eigen::Index cols = ny.cols;
+  int64_t ndim = std::min<int64_t>(nx.ndim, ny.ndim) == 2
+                     ? 2
+                     : std::max(nx.ndim, ny.ndim) - 1;
+  if (ndim == 1 && cols > 1) {
+    std::swap(rows, cols);
+  }
+  return Intern({ExprOp::kMatMul, &nx, &ny, 0, 0, 0, 0, 0},
+                {ExprOp::kMatMul, nx.is_cipher || ny.is_cipher, rows, cols,
+                 ndim, x.node_, y.node_, std::monostate()});
+}
+
+LazyTensor LazyEvaluator::Sum(const LazyTensor &x) {
+  const auto &nx = *x.node_;
+  YACL_ENFORCE(nx.rows > 0 && nx.cols > 0,
+               "you cannot sum an empty tensor, shape={}x{}", nx.rows,
+               nx.cols);
+  return Intern({ExprOp::kSum, &nx, nullptr, 0, 0, 0, 0, 0},
+                {ExprOp::kSum, nx.is_cipher, 1, 1, 0, x.node_, nullptr,
+                 std::monostate()});
+}
+
+size_t LazyEvaluator::NumNodes() const {
+  size_t res = 0;
+  for (const auto &[key, node] : nodes_) {
+    res += node.expired() ? 0 : 1;
+  }
+  return res;
+}
+
+namespace {
+
+using Value = std::variant<CMatrix, PMatrix>;
+using ValueView = std::variant<CMatrixView, PMatrixView>;
+
+template <typename T>
+using IsCipher = std::is_same<typename T::value_type, phe::Ciphertext>;
+
+bool IsElementwise(ExprOp op) {
+  return op == ExprOp::kAdd || op == ExprOp::kSub || op == ExprOp::kMul;
+}
+
+// Evaluate one DAG, every node is computed at most once
+class GraphRunner {
+ public:
+  GraphRunner(const Evaluator &evaluator, const ExprNode *root)
+      : evaluator_(evaluator) {
+    CountUses(root);
+  }
+
+  Value &Materialize(const ExprNode *node) {
+    auto it = values_.find(node);
+    if (it != values_.end()) {
+      return it->second;
+    }
+
+    switch (node->op) {
+      case ExprOp::kInput:
+        return values_[node] = std::visit(
+                   [](const auto &view) -> Value { return view.Materialize(); },
+                   View(node));
+      case ExprOp::kMatMul:
+        return values_[node] = RunMatMul(node);
+      case ExprOp::kSum:
+        return values_[node] = RunSum(node);
+      default:
+        return values_[node] = RunElementwise(node);
+    }
+  }
+
+ private:
+  void CountUses(const ExprNode *node) {
+    for (const auto *child : {node->lhs.get(), node->rhs.get()}) {
+      if (child != nullptr && uses_[child]++ == 0) {
+        CountUses(child);
+      }
+    }
+  }
+
+  // Inputs are used in place, other nodes are materialized
+  ValueView View(const ExprNode *node) {
+    if (node->op == ExprOp::kInput) {
+      return std::visit(
+          [](const auto &view) -> ValueView {
+            if constexpr (std::is_same_v<std::decay_t<decltype(view)>,
+                                         std::monostate>) {
+              YACL_THROW("internal error: input node without input");
+            } else {
+              return view;
+            }
+          },
+          node->input);
+    }
+    return std::visit([](const auto &m) -> ValueView { return m; },
+                      Materialize(node));
+  }
+
+  // Compile the maximal tree of element-wise nodes rooted at 'node' whose
+  // inner nodes have no other user, then run it in one pass.
+  Value RunElementwise(const ExprNode *node) {
+    ElementwiseProgram program;
+    std::unordered_map<const ExprNode *, size_t> leaves;
+    std::vector<std::pair<ElementwiseProgram::Op, std::pair<size_t, size_t>>>
+        instrs;
+
+    // returns the register of 'n', instruction registers are numbered after
+    // all leaves are known, so they are encoded as ~index for now
+    std::function<size_t(const ExprNode *, bool)> compile =
+        [&](const ExprNode *n, bool is_root) -> size_t {
+      if (is_root || (IsElementwise(n->op) && uses_[n] == 1 &&
+                      values_.count(n) == 0)) {
+        auto lhs = compile(n->lhs.get(), false);
+        auto rhs = compile(n->rhs.get(), false);
+        auto op = n->op == ExprOp::kAdd   ? ElementwiseProgram::Op::kAdd
+                  : n->op == ExprOp::kSub ? ElementwiseProgram::Op::kSub
+                                          : ElementwiseProgram::Op::kMul;
+        instrs.push_back({op, {lhs, rhs}});
+        return ~(instrs.size() - 1);
+      }
+
+      auto [it, inserted] = leaves.try_emplace(n, program.inputs.size());
+      if (inserted) {
+        program.inputs.push_back(View(n));
+      }
+      return it->second;
+    };
+    compile(node, true);
+
+    auto num_inputs = program.inputs.size();
+    auto to_reg = [&](size_t r) {
+      return r < num_inputs ? r : num_inputs + ~r;
+    };
+    for (const auto &[op, args] : instrs) {
+      program.instrs.push_back({op, to_reg(args.first), to_reg(args.second)});
+    }
+
+    if (node->is_cipher) {
+      CMatrix out(node->rows, node->cols, node->ndim);
+      evaluator_.EvalElementwise(program, &out);
+      return out;
+    }
+    PMatrix out(node->rows, node->cols, node->ndim);
+    evaluator_.EvalElementwise(program, &out);
+    return out;
+  }
+
+  Value RunMatMul(const ExprNode *node) {
+    return std::visit(
+        [&](const auto &x, const auto &y) -> Value {
+          if constexpr (IsCipher<std::decay_t<decltype(x)>>::value &&
+                        IsCipher<std::decay_t<decltype(y)>>::value) {
+            YACL_THROW("cannot multiply two ciphertext tensors");
+          } else {
+            return evaluator_.MatMul(x, y);
+          }
+        },
+        View(node->lhs.get()), View(node->rhs.get()));
+  }
+
+  Value RunSum(const ExprNode *node) {
+    const auto *child = node->lhs.get();
+    if (child->op == ExprOp::kMatMul && values_.count(child) == 0 &&
+        uses_[child] == 1 && ReduceDim(child) > 0) {
+      return SumOfMatMul(child);
+    }
+
+    return std::visit(
+        [&](const auto &x) -> Value {
+          using T = typename std::decay_t<decltype(x)>::value_type;
+          DenseMatrix<T> res(1, 1, 0);
+          res(0, 0) = evaluator_.Sum(x);
+          return res;
+        },
+        View(child));
+  }
+
+  static Eigen::Index ReduceDim(const ExprNode *matmul) {
+    const auto *x = matmul->lhs.get();
+    return x->ndim == 1 ? x->rows : x->cols;
+  }
+
+  // sum(x @ y) = sum_k (sum_i x[i, k]) * (sum_j y[k, j])
+  Value SumOfMatMul(const ExprNode *matmul) {
+    return std::visit(
+        [&](const auto &x, const auto &y) -> Value {
+          using TX = typename std::decay_t<decltype(x)>::value_type;
+          using TY = typename std::decay_t<decltype(y)>::value_type;
+          if constexpr (std::is_same_v<TX, phe::Ciphertext> &&
+                        std::is_same_v<TY, phe::Ciphertext>) {
+            YACL_THROW("cannot multiply two ciphertext tensors");
+          } else {
+            // treat vector x as a row vector
+            DenseMatrixView<TX> mx =
+                x.ndim() == 1 ? DenseMatrixView<TX>(x.data(), 1, x.rows(),
+                                                    {0, x.strides()[0]}, 2)
+                              : x;
+            auto k = mx.cols();
+            DenseMatrix<TX> col_sum(k);
+            DenseMatrix<TY> row_sum(k);
+            for (Eigen::Index i = 0; i < k; ++i) {
+              col_sum(i, 0) = evaluator_.Sum(mx.Slice({0, mx.rows()}, {i, 1}));
+              row_sum(i, 0) = evaluator_.Sum(y.Slice({i, 1}));
+            }
+
+            // the ciphertext operand goes first
+            if constexpr (std::is_same_v<TY, phe::Ciphertext>) {
+              CMatrix res(1, 1, 0);
+              res(0, 0) = evaluator_.Sum(evaluator_.Mul(row_sum, col_sum));
+              return res;
+            } else {
+              DenseMatrix<TX> res(1, 1, 0);
+              res(0, 0) = evaluator_.Sum(evaluator_.Mul(col_sum, row_sum));
+              return res;
+            }
+          }
+        },
+        View(matmul->lhs.get()), View(matmul->rhs.get()));
+  }
+
+  const Evaluator &evaluator_;
+  std::unordered_map<const ExprNode *, size_t> uses_;
+  std::unordered_map<const ExprNode *, Value> values_;
+};
+
+}  // namespace
+
+template <typename T>
+DenseMatrix<T> LazyEvaluator::Eval(const LazyTensor &x) const {
+  YACL_ENFORCE(x.IsCiphertext() == std::is_same_v<T, phe::Ciphertext>,
+               "tensor type mismatch, the tensor is a {}",
+               x.IsCiphertext() ? "CMatrix" : "PMatrix");
+  GraphRunner runner(*evaluator_, x.node_.get());
+  return std::get<DenseMatrix<T>>(
+      std::move(runner.Materialize(x.node_.get())));
+}
+
+template CMatrix LazyEvaluator::Eval(const LazyTensor &x) const;
+template PMatrix LazyEvaluator::Eval(const LazyTensor &x) const;
+
+}  // namespace heu::lib::numpy
@@ -0,0 +1,112 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <tuple>
+#include <variant>
+
+#include "heu/library/numpy/evaluator.h"
+
+namespace heu::lib::numpy {
+
+namespace internal {
+
+enum class ExprOp { kInput, kAdd, kSub, kMul, kMatMul, kSum };
+
+struct ExprNode;
+
+}  // namespace internal
+
+// A node of a lazy expression, see LazyEvaluator
+class LazyTensor {
+ public:
+  [[nodiscard]] int64_t ndim() const;
+  [[nodiscard]] Eigen::Index rows() const;
+  [[nodiscard]] Eigen::Index cols() const;
+  [[nodiscard]] Shape shape() const;
+  // True if the value of this tensor is a CMatrix, otherwise a PMatrix
+  [[nodiscard]] bool IsCiphertext() const;
+
+ private:
+  friend class LazyEvaluator;
+
+  explicit LazyTensor(std::shared_ptr<const internal::ExprNode> node)
+      : node_(std::move(node)) {}
+
+  std::shared_ptr<const internal::ExprNode> node_;
+};
+
+// Opt-in lazy mode of numpy::Evaluator.
+//
+// Instead of computing each op right away, LazyEvaluator records an expression
+// DAG and only computes it in Eval():
+//  - Identical sub-expressions are recorded once and computed once.
+//  - Chains of element-wise Add/Sub/Mul are fused into a single parallel pass
+//    (see Evaluator::EvalElementwise), so no intermediate matrix is created
+//    for them.
+//  - Sum(MatMul(x, y)) is computed as the dot product of the column sums of x
+//    and the row sums of y, which needs k multiplications instead of n*k*m.
+//
+// Inputs are recorded as views, the matrices must outlive all tensors derived
+// from them. A LazyEvaluator is not thread safe.
+class LazyEvaluator {
+ public:
+  explicit LazyEvaluator(std::shared_ptr<const Evaluator> evaluator)
+      : evaluator_(std::move(evaluator)) {}
+
+  LazyTensor Input(const CMatrixView &x);
+  LazyTensor Input(const PMatrixView &x);
+
+  // Same semantics (broadcasting, shapes) as numpy::Evaluator
+  LazyTensor Add(const LazyTensor &x, const LazyTensor &y);
+  LazyTensor Sub(const LazyTensor &x, const LazyTensor &y);
+  LazyTensor Mul(const LazyTensor &x, const LazyTensor &y);
+  LazyTensor MatMul(const LazyTensor &x, const LazyTensor &y);
+  // The result is a 0-d tensor
+  LazyTensor Sum(const LazyTensor &x);
+
+  // Compute the value of x, which must match the tensor type, i.e.
+  // CMatrix for IsCiphertext() tensors and PMatrix for the others.
+  template <typename T>
+  DenseMatrix<T> Eval(const LazyTensor &x) const;
+
+  // Number of distinct live nodes recorded, for test
+  [[nodiscard]] size_t NumNodes() const;
+  // Number of entries in the common sub-expression table, including the
+  // nodes that are released but not swept yet, for test
+  [[nodiscard]] size_t TableSize() const { return nodes_.size(); }
+
+ private:
+  // (op, lhs, rhs, rows, cols, strides...) for ops, for inputs lhs is the
+  // address of the first element and rhs is nullptr
+  using NodeKey = std::tuple<internal::ExprOp, const void *, const void *,
+                             int64_t, int64_t, int64_t, int64_t, int64_t>;
+
+  LazyTensor Intern(const NodeKey &key, internal::ExprNode &&node);
+  LazyTensor Elementwise(internal::ExprOp op, const LazyTensor &x,
+                         const LazyTensor &y);
+
+  static constexpr size_t kMinSweepThreshold = 64;
+
+  std::shared_ptr<const Evaluator> evaluator_;
+  // common sub-expression table
+  std::map<NodeKey, std::weak_ptr<const internal::ExprNode>> nodes_;
+  // expired entries are swept once the table grows to this size
+  size_t sweep_threshold_ = kMinSweepThreshold;
+};
+
+}  // namespace heu::lib::numpy
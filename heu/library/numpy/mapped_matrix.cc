@@ -0,0 +1,332 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "heu/library/numpy/mapped_matrix.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <limits>
+#include <utility>
+
+#include "heu/library/phe/record_codec.h"
+
+namespace heu::lib::numpy {
+
+namespace {
+
+constexpr char kMagic[8] = {'H', 'E', 'U', 'C', 'M', 'A', 'T', '\0'};
+constexpr uint32_t kVersion = 1;
+constexpr size_t kHeaderBytes = 64;
+
+// All fields are stored little-endian behind the magic, the rest of the
+// kHeaderBytes bytes are reserved and zero
+struct FileHeader {
+  uint32_t version;
+  uint32_t ndim;
+  int64_t rows;
+  int64_t cols;
+  uint64_t record_bytes;
+
+  void WriteTo(uint8_t *out) const {
+    std::memset(out, 0, kHeaderBytes);
+    std::memcpy(out, kMagic, sizeof(kMagic));
+    phe::StoreLittleEndian(version, out + 8);
+    phe::StoreLittleEndian(ndim, out + 12);
+    phe::StoreLittleEndian(rows, out + 16);
+    phe::StoreLittleEndian(cols, out + 24);
+    phe::StoreLittleEndian(record_bytes, out + 32);
+  }
+
+  // Returns false if 'in' does not start with the magic
+  bool ReadFrom(const uint8_t *in) {
+    if (std::memcmp(in, kMagic, sizeof(kMagic)) != 0) {
+      return false;
+    }
+    version = phe::LoadLittleEndian<uint32_t>(in + 8);
+    ndim = phe::LoadLittleEndian<uint32_t>(in + 12);
+    rows = phe::LoadLittleEndian<int64_t>(in + 16);
+    cols = phe::LoadLittleEndian<int64_t>(in + 24);
+    record_bytes = phe::LoadLittleEndian<uint64_t>(in + 32);
+    return true;
+  }
+};
+
+// The size of a file holding rows * cols records, false if the shape is
+// negative or the size overflows
+bool FileBytes(int64_t rows, int64_t cols, uint64_t record_bytes,
+               uint64_t *out) {
+  uint64_t n;
+  return rows >= 0 && cols >= 0 &&
+         !__builtin_mul_overflow(static_cast<uint64_t>(rows),
+                                 static_cast<uint64_t>(cols), &n) &&
+         !__builtin_mul_overflow(n, record_bytes, &n) &&
+         !__builtin_add_overflow(n, kHeaderBytes, out);
+}
+
+}  // namespace
+
+MappedCMatrix MappedCMatrix::Create(const std::string &path,
+                                    const Shape &shape, size_t record_bytes) {
+  YACL_ENFORCE(shape.Ndim() <= 2, "HEU tensor dimension cannot exceed 2");
+  YACL_ENFORCE(record_bytes > phe::kCipherRecordLengthBytes,
+               "record_bytes {} is too small", record_bytes);
+
+  FileHeader header{};
+  header.version = kVersion;
+  header.ndim = shape.Ndim();
+  header.rows = shape.RowsAlloc();
+  header.cols = shape.ColsAlloc();
+  header.record_bytes = record_bytes;
+  uint64_t file_bytes;
+  YACL_ENFORCE(FileBytes(header.rows, header.cols, record_bytes,
+                         &file_bytes) &&
+                   file_bytes <= std::numeric_limits<off_t>::max(),
+               "invalid shape {} or record_bytes {}", shape.ToString(),
+               record_bytes);
+  uint8_t header_bytes[kHeaderBytes];
+  header.WriteTo(header_bytes);
+
+  int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  YACL_ENFORCE(fd >= 0, "cannot create {}: {}", path, std::strerror(errno));
+  if (::ftruncate(fd, static_cast<off_t>(file_bytes)) != 0 ||
+      ::pwrite(fd, header_bytes, kHeaderBytes, 0) !=
+          static_cast<ssize_t>(kHeaderBytes)) {
+    auto err = errno;
+    ::close(fd);
+    YACL_THROW("cannot write {}: {}", path, std::strerror(err));
+  }
+  return MappedCMatrix(path, fd, true);
+}
+
+MappedCMatrix MappedCMatrix::Open(const std::string &path, bool writable) {
+  int fd = ::open(path.c_str(), writable ? O_RDWR : O_RDONLY);
+  YACL_ENFORCE(fd >= 0, "cannot open {}: {}", path, std::strerror(errno));
+  return MappedCMatrix(path, fd, writable);
+}
+
+MappedCMatrix MappedCMatrix::FromMatrix(const std::string &path,
+                                        const CMatrixView &m) {
+  auto res = Create(path, m.shape(), SuggestRecordBytes(m));
+  res.WriteRows(0, m);
+  return res;
+}
+
+size_t MappedCMatrix::SuggestRecordBytes(const CMatrixView &sample) {
+  YACL_ENFORCE(sample.size() > 0, "cannot guess record size from empty tensor");
+  auto max_bytes = yacl::parallel_reduce<size_t>(
+      0, sample.size(), 1,
+      [&](int64_t beg, int64_t end) {
+        size_t res = 0;
+        for (int64_t i = beg; i < end; ++i) {
+          res = std::max<size_t>(res, sample[i].Serialize().size());
+        }
+        return res;
+      },
+      [](size_t a, size_t b) { return std::max(a, b); });
+  return phe::SuggestCipherRecordBytes(max_bytes);
+}
+
+MappedCMatrix::MappedCMatrix(std::string path, int fd, bool writable)
+    : path_(std::move(path)), fd_(fd), writable_(writable) {
+  struct stat st {};
+  if (::fstat(fd_, &st) != 0 ||
+      static_cast<size_t>(st.st_size) < kHeaderBytes) {
+    Release();
+    YACL_THROW("{} is not a HEU mapped matrix: file too small", path_);
+  }
+
+  map_bytes_ = st.st_size;
+  void *addr = ::mmap(nullptr, map_bytes_,
+                      PROT_READ | (writable_ ? PROT_WRITE : 0), MAP_SHARED,
+                      fd_, 0);
+  if (addr == MAP_FAILED) {
+    auto err = errno;
+    Release();
+    YACL_THROW("cannot mmap {}: {}", path_, std::strerror(err));
+  }
+  base_ = static_cast<uint8_t *>(addr);
+
+  FileHeader header;
+  uint64_t file_bytes;
+  bool valid =
+      header.ReadFrom(base_) && header.version == kVersion &&
+      header.ndim <= 2 &&
+      header.record_bytes > phe::kCipherRecordLengthBytes &&
+      FileBytes(header.rows, header.cols, header.record_bytes, &file_bytes) &&
+      map_bytes_ == file_bytes;
+  if (!valid) {
+    Release();
+    YACL_THROW("{} is not a HEU mapped matrix or is truncated", path_);
+  }
+  rows_ = header.rows;
+  cols_ = header.cols;
+  ndim_ = header.ndim;
+  record_bytes_ = header.record_bytes;
+}
+
+MappedCMatrix::MappedCMatrix(MappedCMatrix &&other) noexcept {
+  *this = std::move(other);
+}
+
+MappedCMatrix &MappedCMatrix::operator=(MappedCMatrix &&other) noexcept {
+  if (this != &other) {
+    Release();
+    path_ = std::move(other.path_);
+    fd_ = std::exchange(other.fd_, -1);
+    writable_ = other.writable_;
+    base_ = std::exchange(other.base_, nullptr);
+    map_bytes_ = std::exchange(other.map_bytes_, 0);
+    rows_ = other.rows_;
+    cols_ = other.cols_;
+    ndim_ = other.ndim_;
+    record_bytes_ = other.record_bytes_;
+  }
+  return *this;
+}
+
+MappedCMatrix::~MappedCMatrix() { Release(); }
+
+void MappedCMatrix::Release() {
+  if (base_ != nullptr) {
+    ::munmap(base_, map_bytes_);
+    base_ = nullptr;
+  }
+  if (fd_ >= 0) {
+    ::close(fd_);
+    fd_ = -1;
+  }
+}
+
+Shape MappedCMatrix::shape() const {
+  std::vector<int64_t> res = {rows_, cols_};
+  res.resize(ndim_);
+  return Shape(res);
+}
+
+void MappedCMatrix::CheckRange(int64_t begin, int64_t count) const {
+  YACL_ENFORCE(begin >= 0 && count >= 0 && begin + count <= size(),
+               "element range [{}, {}) out of bound, size={}", begin,
+               begin + count, size());
+}
+
+void MappedCMatrix::DecodeRecord(int64_t index, phe::Ciphertext *out) const {
+  phe::DecodeCipherRecord(base_ + kHeaderBytes + index * record_bytes_,
+                          record_bytes_, out);
+}
+
+void MappedCMatrix::EncodeRecord(int64_t index,
+                                 const phe::Ciphertext &in) const {
+  phe::EncodeCipherRecord(in, base_ + kHeaderBytes + index * record_bytes_,
+                          record_bytes_);
+}
+
+void MappedCMatrix::Read(int64_t begin, absl::Span<phe::Ciphertext> out) const {
+  CheckRange(begin, out.size());
+  yacl::parallel_for(0, out.size(), 1, [&](int64_t beg, int64_t end) {
+    for (int64_t i = beg; i < end; ++i) {
+      DecodeRecord(begin + i, &out[i]);
+    }
+  });
+}
+
+void MappedCMatrix::Write(int64_t begin,
+                          absl::Span<const phe::Ciphertext> in) {
+  YACL_ENFORCE(writable_, "{} is opened read-only", path_);
+  CheckRange(begin, in.size());
+  yacl::parallel_for(0, in.size(), 1, [&](int64_t beg, int64_t end) {
+    for (int64_t i = beg; i < end; ++i) {
+      EncodeRecord(begin + i, in[i]);
+    }
+  });
+}
+
+CMatrix MappedCMatrix::ReadRows(int64_t row_begin, int64_t num_rows) const {
+  YACL_ENFORCE(row_begin >= 0 && num_rows >= 0 && row_begin + num_rows <= rows_,
+               "row range [{}, {}) out of bound, rows={}", row_begin,
+               row_begin + num_rows, rows_);
+  CMatrix res(num_rows, cols_, ndim_);
+  yacl::parallel_for(0, res.size(), 1, [&](int64_t beg, int64_t end) {
+    for (int64_t i = beg; i < end; ++i) {
+      DecodeRecord((i / num_rows) * rows_ + row_begin + i % num_rows,
+                   &res.data()[i]);
+    }
+  });
+  return res;
+}
+
+void MappedCMatrix::WriteRows(int64_t row_begin, const CMatrixView &block) {
+  YACL_ENFORCE(writable_, "{} is opened read-only", path_);
+  auto num_rows = block.rows();
+  YACL_ENFORCE(block.cols() == cols_ && row_begin >= 0 &&
+                   row_begin + num_rows <= rows_,
+               "cannot write a {}x{} block at row {} of a {}x{} matrix",
+               num_rows, block.cols(), row_begin, rows_, cols_);
+  yacl::parallel_for(0, block.size(), 1, [&](int64_t beg, int64_t end) {
+    for (int64_t i = beg; i < end; ++i) {
+      EncodeRecord((i / num_rows) * rows_ + row_begin + i % num_rows,
+                   block[i]);
+    }
+  });
+}
+
+CMatrix MappedCMatrix::Load() const { return ReadRows(0, rows_); }
+
+void MappedCMatrix::Advise(int64_t begin, int64_t end, int advice) const {
+  if (begin >= end) {
+    return;
+  }
+  static const auto kPageBytes = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+  size_t first = (kHeaderBytes + begin * record_bytes_) / kPageBytes *
+                 kPageBytes;
+  size_t last = std::min(kHeaderBytes + end * record_bytes_, map_bytes_);
+  // only a hint, failures are ignored
+  ::madvise(base_ + first, last - first, advice);
+}
+
+void MappedCMatrix::Prefetch(int64_t begin, int64_t end) const {
+  Advise(std::max<int64_t>(begin, 0), std::min(end, size()), MADV_WILLNEED);
+}
+
+void MappedCMatrix::PrefetchRows(int64_t row_begin, int64_t num_rows) const {
+  auto row_end = std::min(row_begin + num_rows, rows_);
+  for (Eigen::Index col = 0; col < cols_ && row_begin < row_end; ++col) {
+    Advise(col * rows_ + row_begin, col * rows_ + row_end, MADV_WILLNEED);
+  }
+}
+
+void MappedCMatrix::Evict(int64_t begin, int64_t end) const {
+  Advise(std::max<int64_t>(begin, 0), std::min(end, size()), MADV_DONTNEED);
+}
+
+void MappedCMatrix::EvictRows(int64_t row_begin, int64_t num_rows) const {
+  auto row_end = std::min(row_begin + num_rows, rows_);
+  for (Eigen::Index col = 0; col < cols_ && row_begin < row_end; ++col) {
+    Advise(col * rows_ + row_begin, col * rows_ + row_end, MADV_DONTNEED);
+  }
+}
+
+void MappedCMatrix::Flush() const {
+  if (writable_ && base_ != nullptr) {
+    YACL_ENFORCE(::msync(base_, map_bytes_, MS_SYNC) == 0,
+                 "cannot flush {}: {}", path_, std::strerror(errno));
+  }
+}
+
+}  // namespace heu::lib::numpy
@@ -0,0 +1,120 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <string>
+
+#include "absl/types/span.h"
+
+#include "heu/library/numpy/matrix.h"
+
+namespace heu::lib::numpy {
+
+// Default number of elements per chunk of the streaming ops on MappedCMatrix
+inline constexpr int64_t kMappedChunkSize = 1 << 16;
+
+// A ciphertext matrix stored in a memory-mapped file, for data that does not
+// fit in RAM.
+//
+// The file holds a 64-byte little-endian header followed by rows * cols
+// fixed-width records in column-major order, i.e. the order of
+// DenseMatrix::data(). A record is a little-endian uint32 length followed by
+// the serialized ciphertext, padded to record_bytes(). Nothing is decoded
+// until Read(), and the streaming ops of numpy::Evaluator Evict() each chunk
+// after use, so the resident memory is bounded by the chunk size rather than
+// the matrix size.
+class MappedCMatrix {
+ public:
+  // Create (or truncate) 'path' for a matrix of 'shape', every record has
+  // 'record_bytes' bytes. The elements are undefined until written.
+  static MappedCMatrix Create(const std::string &path, const Shape &shape,
+                              size_t record_bytes);
+  // Map an existing file created by Create()
+  static MappedCMatrix Open(const std::string &path, bool writable = false);
+  // Write 'm' to a new file, the record width is SuggestRecordBytes(m)
+  static MappedCMatrix FromMatrix(const std::string &path,
+                                  const CMatrixView &m);
+
+  // A record width that fits the ciphertexts of 'sample' with some headroom,
+  // so that results computed from them (which are of the same key) fit too.
+  static size_t SuggestRecordBytes(const CMatrixView &sample);
+
+  MappedCMatrix(MappedCMatrix &&other) noexcept;
+  MappedCMatrix &operator=(MappedCMatrix &&other) noexcept;
+  MappedCMatrix(const MappedCMatrix &) = delete;
+  MappedCMatrix &operator=(const MappedCMatrix &) = delete;
+  ~MappedCMatrix();
+
+  [[nodiscard]] Eigen::Index rows() const { return rows_; }
+
+  [[nodiscard]] Eigen::Index cols() const { return cols_; }
+
+  [[nodiscard]] int64_t ndim() const { return ndim_; }
+
+  [[nodiscard]] int64_t size() const { return rows_ * cols_; }
+
+  [[nodiscard]] Shape shape() const;
+
+  [[nodiscard]] size_t record_bytes() const { return record_bytes_; }
+
+  [[nodiscard]] bool writable() const { return writable_; }
+
+  [[nodiscard]] const std::string &path() const { return path_; }
+
+  // Decode the elements [begin, begin + out.size()) in column-major order
+  void Read(int64_t begin, absl::Span<phe::Ciphertext> out) const;
+  // Encode 'in' into the elements [begin, begin + in.size())
+  void Write(int64_t begin, absl::Span<const phe::Ciphertext> in);
+
+  // Decode/encode the rows [row_begin, row_begin + num_rows)
+  [[nodiscard]] CMatrix ReadRows(int64_t row_begin, int64_t num_rows) const;
+  void WriteRows(int64_t row_begin, const CMatrixView &block);
+
+  // Decode the whole matrix
+  [[nodiscard]] CMatrix Load() const;
+
+  // Ask the kernel to start reading the elements [begin, end) from the file
+  void Prefetch(int64_t begin, int64_t end) const;
+  void PrefetchRows(int64_t row_begin, int64_t num_rows) const;
+  // Drop the elements [begin, end) from the memory of this process, the data
+  // stays in the file and is mapped again on the next access
+  void Evict(int64_t begin, int64_t end) const;
+  void EvictRows(int64_t row_begin, int64_t num_rows) const;
+
+  // Write the dirty pages back to the file
+  void Flush() const;
+
+ private:
+  MappedCMatrix(std::string path, int fd, bool writable);
+
+  void DecodeRecord(int64_t index, phe::Ciphertext *out) const;
+  void EncodeRecord(int64_t index, const phe::Ciphertext &in) const;
+  void Advise(int64_t begin, int64_t end, int advice) const;
+  void CheckRange(int64_t begin, int64_t count) const;
+  void Release();
+
+  std::string path_;
+  int fd_ = -1;
+  bool writable_ = false;
+  uint8_t *base_ = nullptr;
+  size_t map_bytes_ = 0;
+
+  Eigen::Index rows_ = 0;
+  Eigen::Index cols_ = 0;
+  int64_t ndim_ = 2;
+  size_t record_bytes_ = 0;
+};
+
+}  // namespace heu::lib::numpy
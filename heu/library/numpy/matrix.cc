@@ -14,8 +14,11 @@
 
 #include "heu/library/numpy/matrix.h"
 
+#include <algorithm>
 #include <string>
 
+#include "google/protobuf/arena.h"
+
 #include "interconnection/runtime/data_exchange.pb.h"
 
 namespace heu::lib::numpy {
@@ -36,18 +39,40 @@ std::string Typename<phe::Plaintext>::Name = "plaintext";
 template <>
 std::string Typename<std::string>::Name = "string";
 
+namespace {
+
+// The arena holds all sub-messages and item strings of a matrix, so the whole
+// protocol message is freed at once instead of one item at a time.
+// Ciphertexts are the largest items, ~2 * key_size bits each; the first block
+// is sized from the number of items to avoid growing the arena repeatedly.
+constexpr size_t kIcItemSizeHint = 600;
+constexpr size_t kIcMaxStartBlockSize = size_t{64} << 20;
+
+google::protobuf::ArenaOptions IcArenaOptions(size_t item_num) {
+  google::protobuf::ArenaOptions options;
+  options.start_block_size =
+      std::min(item_num * kIcItemSizeHint, kIcMaxStartBlockSize);
+  options.max_block_size =
+      std::max(options.max_block_size, options.start_block_size);
+  return options;
+}
+
+}  // namespace
+
 template <typename T>
 yacl::Buffer DenseMatrix<T>::Serialize4Ic() const {
-  pb_ns::DataExchangeProtocol dep;
-  dep.set_scalar_type(pb_ns::SCALAR_TYPE_OBJECT);
+  google::protobuf::Arena arena(IcArenaOptions(size()));
+  auto *dep =
+      google::protobuf::Arena::Create<pb_ns::DataExchangeProtocol>(&arena);
+  dep->set_scalar_type(pb_ns::SCALAR_TYPE_OBJECT);
   // 此处没有满足互联互通要求，要求为 paillier_ciphertext，但是此处无法 get 底层
   // schema 故 name 设为 ciphertext。
   // The group standard of interconnection is not
   // met here. The standard is 'paillier_ciphertext'. However, the underlying
   // schema is hard to obtain here, so just set the name to 'ciphertext'.
-  dep.set_scalar_type_name(Typename<T>::Name);
+  dep->set_scalar_type_name(Typename<T>::Name);
 
-  auto v_ndarray = dep.mutable_v_ndarray();
+  auto v_ndarray = dep->mutable_v_ndarray();
   auto shape = this->shape();
   for (const auto &s : shape) {
     v_ndarray->add_shape(s);
@@ -59,43 +84,52 @@ yacl::Buffer DenseMatrix<T>::Serialize4Ic() const {
   for (int i = 0; i < size(); ++i) {
     pb_items->Add();
   }
+  // The (empty) items are added above and each thread only assigns its own
+  // items, so the repeated field is never resized concurrently. Every item is
+  // still copied once out of the buffer returned by Serialize(), since the
+  // phe types cannot serialize into a caller-provided string.
   yacl::parallel_for(0, size(), 1, [&](int64_t beg, int64_t end) {
     for (int64_t i = beg; i < end; ++i) {
       if constexpr (std::is_same_v<T, std::string>) {
-        pb_items->at(i) = buf[i];
+        *pb_items->Mutable(i) = buf[i];
       } else {
-        pb_items->at(i) = buf[i].Serialize();
+        auto item = buf[i].Serialize();
+        pb_items->Mutable(i)->assign(item.template data<char>(), item.size());
       }
     }
   });
 
-  yacl::Buffer buffer(dep.ByteSizeLong());
-  YACL_ENFORCE(dep.SerializeToArray(buffer.data<uint8_t>(), buffer.size()),
+  yacl::Buffer buffer(dep->ByteSizeLong());
+  YACL_ENFORCE(dep->SerializeToArray(buffer.data<uint8_t>(), buffer.size()),
                "serialize ndarray fail");
   return buffer;
 }
 
 template <typename T>
 DenseMatrix<T> DenseMatrix<T>::LoadFromIc(yacl::ByteContainerView in) {
-  pb_ns::DataExchangeProtocol dxp;
-  YACL_ENFORCE(dxp.ParseFromArray(in.data(), in.size()),
+  // the serialized buffer is a good estimate of the parsed message size
+  google::protobuf::Arena arena(IcArenaOptions(in.size() / kIcItemSizeHint));
+  auto *dxp =
+      google::protobuf::Arena::Create<pb_ns::DataExchangeProtocol>(&arena);
+  YACL_ENFORCE(dxp->ParseFromArray(in.data(), in.size()),
                "deserialize ndarray fail");
 
   // dxp.scalar_type_name() is useless, do not check
-  YACL_ENFORCE(dxp.scalar_type() == pb_ns::SCALAR_TYPE_OBJECT,
-               "Buffer format illegal, scalar_type={}", dxp.scalar_type());
+  YACL_ENFORCE(dxp->scalar_type() == pb_ns::SCALAR_TYPE_OBJECT,
+               "Buffer format illegal, scalar_type={}", dxp->scalar_type());
 
-  YACL_ENFORCE(dxp.container_case() ==
+  YACL_ENFORCE(dxp->container_case() ==
                    pb_ns::DataExchangeProtocol::ContainerCase::kVNdarray,
-               "unsupported container type {}", (int)dxp.container_case());
+               "unsupported container type {}", (int)dxp->container_case());
 
-  auto v_ndarray = dxp.v_ndarray();
-  auto s = v_ndarray.shape();
+  // Use references here, copying the ndarray would copy every item
+  const auto &v_ndarray = dxp->v_ndarray();
+  const auto &s = v_ndarray.shape();
   DenseMatrix<T> res(s.size() > 0 ? s[0] : 1, s.size() > 1 ? s[1] : 1,
                      s.size());
 
   T *buf = res.data();
-  auto pb_items = v_ndarray.items();
+  const auto &pb_items = v_ndarray.items();
   YACL_ENFORCE(pb_items.size() == res.size(), "Pb: shape and len not match");
   yacl::parallel_for(0, res.size(), 1, [&](int64_t beg, int64_t end) {
     for (int64_t i = beg; i < end; ++i) {
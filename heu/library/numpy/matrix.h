@@ -14,7 +14,9 @@
 
 #pragma once
 
+#include <array>
 #include <experimental/type_traits>
+#include <string_view>
 
 #include "msgpack.hpp"
 #include "yacl/base/buffer.h"
@@ -22,6 +24,7 @@
 
 #include "heu/library/numpy/eigen_traits.h"
 #include "heu/library/numpy/shape.h"
+#include "heu/library/numpy/trace.h"
 #include "heu/library/phe/phe.h"
 
 namespace heu::lib::numpy {
@@ -36,6 +39,9 @@ template <typename T>
 using kHasSerializeWithMetaMethod =
     decltype(std::declval<T &>().Serialize(std::declval<bool &>()));
 
+template <typename T>
+class DenseMatrixView;
+
 // Vector is cheated as an n*1 matrix
 template <typename T>
 class DenseMatrix {
@@ -163,7 +169,9 @@ class DenseMatrix {
 
     T *buf = m_.data();
     int64_t row = rows();
+    HEU_TRACE_CAPTURE(trace_ctx);
     auto func = [&](int64_t beg, int64_t end) {
+      HEU_TRACE_CHUNK(trace_ctx, beg, end);
       for (int64_t i = beg; i < end; ++i) {
         update(i % row, i / row, buf + i);
       }
@@ -185,7 +193,9 @@ class DenseMatrix {
 
     const T *buf = m_.data();
     int64_t row = rows();
+    HEU_TRACE_CAPTURE(trace_ctx);
     auto func = [&](int64_t beg, int64_t end) {
+      HEU_TRACE_CHUNK(trace_ctx, beg, end);
       for (int64_t i = beg; i < end; ++i) {
         visit(i % row, i / row, *(buf + i));
       }
@@ -224,43 +234,7 @@ class DenseMatrix {
       return Serialize4Ic();
     }
 
-    msgpack::sbuffer buffer;
-    msgpack::packer<msgpack::sbuffer> o(buffer);
-
-    o.pack_array(4);
-    Eigen::Index rows = this->rows();
-    Eigen::Index cols = this->cols();
-    int64_t ndim = this->ndim();
-
-    o.pack(rows);
-    o.pack(cols);
-    o.pack(ndim);
-    o.pack_array(this->size());
-
-    const T *buf = this->data();
-    if constexpr (std::experimental::is_detected_v<kHasSerializeWithMetaMethod,
-                                                   T>) {
-      std::vector<yacl::Buffer> tmp;
-      tmp.resize(this->size());
-      // parallel serialize
-      tmp[0] = buf[0].Serialize(/* with_meta = */ true);
-      yacl::parallel_for(1, this->size(), 1, [&](int64_t beg, int64_t end) {
-        for (int64_t i = beg; i < end; ++i) {
-          tmp[i] = buf[i].Serialize();
-        }
-      });
-
-      for (const auto &t : tmp) {
-        o.pack(std::string_view(t));
-      }
-    } else {
-      for (Eigen::Index i = 0; i < this->size(); i++) {
-        o.pack(buf[i]);
-      }
-    }
-
-    auto sz = buffer.size();
-    return {buffer.release(), sz, [](void *ptr) { free(ptr); }};
+    return DenseMatrixView<T>(*this).Serialize(format);
   }
 
   static DenseMatrix<T> LoadFrom(
@@ -334,6 +308,193 @@ class DenseMatrix {
   int64_t ndim_;
 };
 
+// A read-only window onto the storage of a DenseMatrix, no element is copied.
+//
+// Element (i, j) of the view is data()[i * strides()[0] + j * strides()[1]],
+// so a view can describe a strided slice (numpy basic slicing, including
+// negative steps) or a transpose of the underlying matrix. The view does not
+// own the storage, the source matrix must outlive it and must not be resized.
+// Call Materialize() to get a writable copy.
+template <typename T>
+class DenseMatrixView {
+ public:
+  typedef T value_type;
+
+  // Range of one axis: 'size' items starting from 'start', 'step' apart
+  struct Range {
+    Eigen::Index start;
+    Eigen::Index size;
+    Eigen::Index step = 1;
+  };
+
+  DenseMatrixView(const T *data, Eigen::Index rows, Eigen::Index cols,
+                  std::array<int64_t, 2> strides, int64_t ndim)
+      : data_(data), rows_(rows), cols_(cols), strides_(strides), ndim_(ndim) {
+    YACL_ENFORCE(ndim <= 2, "HEU tensor dimension cannot exceed 2");
+    YACL_ENFORCE(rows >= 0 && cols >= 0, "invalid view shape {}x{}", rows,
+                 cols);
+  }
+
+  // NOLINTNEXTLINE(google-explicit-constructor): a matrix is a view of itself
+  DenseMatrixView(const DenseMatrix<T> &m)
+      : DenseMatrixView(m.data(), m.rows(), m.cols(), {1, m.rows()},
+                        m.ndim()) {}
+
+  const T &operator()(Eigen::Index row, Eigen::Index col) const {
+    return data_[row * strides_[0] + col * strides_[1]];
+  }
+
+  // the i-th element in column-major order, same as DenseMatrix::data()[i]
+  const T &operator[](Eigen::Index i) const {
+    return (*this)(i % rows_, i / rows_);
+  }
+
+  [[nodiscard]] int64_t ndim() const { return ndim_; }
+
+  [[nodiscard]] Eigen::Index rows() const { return rows_; }
+
+  [[nodiscard]] Eigen::Index cols() const { return cols_; }
+
+  [[nodiscard]] Eigen::Index size() const { return rows_ * cols_; }
+
+  [[nodiscard]] Shape shape() const {
+    std::vector<int64_t> res = {rows_, cols_};
+    res.resize(ndim_);
+    return Shape(res);
+  }
+
+  // address of element (0, 0)
+  const T *data() const { return data_; }
+
+  const std::array<int64_t, 2> &strides() const { return strides_; }
+
+  // True if the view covers a column-major block, i.e. data()[0, size())
+  [[nodiscard]] bool IsContiguous() const {
+    return (strides_[0] == 1 || rows_ <= 1) &&
+           (strides_[1] == rows_ || cols_ <= 1);
+  }
+
+  // The view counterpart of DenseMatrix::GetItem() with python slices, the
+  // ndim is kept.
+  DenseMatrixView<T> Slice(const Range &rows, const Range &cols) const {
+    YACL_ENFORCE(ndim_ == 2 || (cols.start == 0 && cols.size == cols_),
+                 "you cannot slice the columns of a {}d-tensor", ndim_);
+    CheckRange(rows, rows_, "row");
+    CheckRange(cols, cols_, "col");
+    const T *data =
+        rows.size > 0 && cols.size > 0 ? &(*this)(rows.start, cols.start)
+                                       : data_;
+    return {data,
+            rows.size,
+            cols.size,
+            {strides_[0] * rows.step, strides_[1] * cols.step},
+            ndim_};
+  }
+
+  DenseMatrixView<T> Slice(const Range &rows) const {
+    return Slice(rows, {0, cols_});
+  }
+
+  DenseMatrixView<T> Transpose() const {
+    YACL_ENFORCE(ndim_ == 2, "you cannot transpose a {}d-tensor", ndim_);
+    return {data_, cols_, rows_, {strides_[1], strides_[0]}, ndim_};
+  }
+
+  // Copy the elements into a new DenseMatrix
+  DenseMatrix<T> Materialize() const {
+    DenseMatrix<T> res(rows_, cols_, ndim_);
+    T *buf = res.data();
+    yacl::parallel_for(0, size(), 1, [&](int64_t beg, int64_t end) {
+      for (int64_t i = beg; i < end; ++i) {
+        buf[i] = (*this)[i];
+      }
+    });
+    return res;
+  }
+
+  // if parallel = true, be make sure visit() is thread safe
+  void ForEach(const std::function<void(int64_t row, int64_t col,
+                                        const T &element)> &visit,
+               bool parallel = true) const {
+    HEU_TRACE_CAPTURE(trace_ctx);
+    auto func = [&](int64_t beg, int64_t end) {
+      HEU_TRACE_CHUNK(trace_ctx, beg, end);
+      for (int64_t i = beg; i < end; ++i) {
+        visit(i % rows_, i / rows_, (*this)[i]);
+      }
+    };
+
+    if (parallel) {
+      yacl::parallel_for(0, size(), 1, func);
+    } else {
+      func(0, size());
+    }
+  }
+
+  // The output is the same as Materialize().Serialize(format), but the
+  // default format is written without copying the elements.
+  [[nodiscard]] yacl::Buffer Serialize(
+      MatrixSerializeFormat format = MatrixSerializeFormat::Best) const {
+    if (format == MatrixSerializeFormat::Interconnection) {
+      return Materialize().Serialize(format);
+    }
+
+    msgpack::sbuffer buffer;
+    msgpack::packer<msgpack::sbuffer> o(buffer);
+
+    o.pack_array(4);
+    o.pack(rows_);
+    o.pack(cols_);
+    o.pack(ndim_);
+    o.pack_array(size());
+
+    if constexpr (std::experimental::is_detected_v<kHasSerializeWithMetaMethod,
+                                                   T>) {
+      std::vector<yacl::Buffer> tmp;
+      tmp.resize(size());
+      // parallel serialize
+      tmp[0] = (*this)[0].Serialize(/* with_meta = */ true);
+      yacl::parallel_for(1, size(), 1, [&](int64_t beg, int64_t end) {
+        for (int64_t i = beg; i < end; ++i) {
+          tmp[i] = (*this)[i].Serialize();
+        }
+      });
+
+      for (const auto &t : tmp) {
+        o.pack(std::string_view(t));
+      }
+    } else {
+      for (Eigen::Index i = 0; i < size(); i++) {
+        o.pack((*this)[i]);
+      }
+    }
+
+    auto sz = buffer.size();
+    return {buffer.release(), sz, [](void *ptr) { free(ptr); }};
+  }
+
+ private:
+  static void CheckRange(const Range &r, Eigen::Index dim_len,
+                         std::string_view name) {
+    YACL_ENFORCE(r.size >= 0, "{} slice size must be non-negative, got {}",
+                 name, r.size);
+    if (r.size == 0) {
+      return;
+    }
+    Eigen::Index last = r.start + (r.size - 1) * r.step;
+    YACL_ENFORCE(r.start >= 0 && r.start < dim_len && last >= 0 &&
+                     last < dim_len,
+                 "{} slice out of range: start={}, size={}, step={}, dim={}",
+                 name, r.start, r.size, r.step, dim_len);
+  }
+
+  const T *data_;
+  Eigen::Index rows_;
+  Eigen::Index cols_;
+  std::array<int64_t, 2> strides_;
+  int64_t ndim_;
+};
+
 template <typename T>
 inline auto format_as(const DenseMatrix<T> &i) {
   return fmt::streamed(i);
@@ -341,5 +502,12 @@ inline auto format_as(const DenseMatrix<T> &i) {
 
 using PMatrix = DenseMatrix<phe::Plaintext>;
 using CMatrix = DenseMatrix<phe::Ciphertext>;
+using PMatrixView = DenseMatrixView<phe::Plaintext>;
+using CMatrixView = DenseMatrixView<phe::Ciphertext>;
+// Integer plaintexts held inline, without a big integer per element. Only
+// accepted as the multiplier of numpy::Evaluator::Mul/MatMul, where Z-Paillier
+// and OU multiply by them with a short exponentiation.
+using IMatrix = DenseMatrix<int64_t>;
+using IMatrixView = DenseMatrixView<int64_t>;
 
 }  // namespace heu::lib::numpy
@@ -19,6 +19,9 @@
 #include "heu/library/numpy/decryptor.h"
 #include "heu/library/numpy/encryptor.h"
 #include "heu/library/numpy/evaluator.h"
+#include "heu/library/numpy/executor.h"
+#include "heu/library/numpy/lazy.h"
+#include "heu/library/numpy/trace.h"
 #include "heu/library/phe/phe.h"
 
 namespace heu::lib::numpy {
@@ -0,0 +1,160 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include "heu/library/numpy/matrix.h"
+
+namespace heu::lib::numpy {
+
+// A 2-d matrix that only stores its non-zero elements, in the compressed
+// layouts of scipy.sparse:
+//  - CSR: the non-zeros of row i are values()[indptr()[i] : indptr()[i + 1]],
+//    located at columns indices()[indptr()[i] : indptr()[i + 1]].
+//  - CSC: the same with rows and columns swapped.
+template <typename T>
+class SparseMatrix {
+ public:
+  typedef T value_type;
+
+  enum class Layout { kCsr, kCsc };
+
+  SparseMatrix(Eigen::Index rows, Eigen::Index cols, Layout layout,
+               std::vector<int64_t> indptr, std::vector<int64_t> indices,
+               std::vector<T> values)
+      : rows_(rows),
+        cols_(cols),
+        layout_(layout),
+        indptr_(std::move(indptr)),
+        indices_(std::move(indices)),
+        values_(std::move(values)) {
+    YACL_ENFORCE(rows >= 0 && cols >= 0, "invalid sparse matrix shape {}x{}",
+                 rows, cols);
+    YACL_ENFORCE(static_cast<int64_t>(indptr_.size()) == OuterSize() + 1,
+                 "indptr size mismatch, expected {}, actual {}",
+                 OuterSize() + 1, indptr_.size());
+    YACL_ENFORCE(indptr_.front() == 0 &&
+                     indptr_.back() == static_cast<int64_t>(indices_.size()),
+                 "indptr must start with 0 and end with nnz={}, actual {}..{}",
+                 indices_.size(), indptr_.front(), indptr_.back());
+    YACL_ENFORCE(indices_.size() == values_.size(),
+                 "indices and values size mismatch, {} vs {}", indices_.size(),
+                 values_.size());
+    for (int64_t i = 0; i < OuterSize(); ++i) {
+      YACL_ENFORCE(indptr_[i] <= indptr_[i + 1],
+                   "indptr must be non-decreasing, indptr[{}]={} > {}", i,
+                   indptr_[i], indptr_[i + 1]);
+    }
+    for (auto idx : indices_) {
+      YACL_ENFORCE(0 <= idx && idx < InnerSize(),
+                   "sparse index {} out of range [0, {})", idx, InnerSize());
+    }
+  }
+
+  // Collect the non-zero elements of a dense matrix
+  static SparseMatrix<T> FromDense(const DenseMatrixView<T> &m,
+                                   Layout layout) {
+    YACL_ENFORCE(m.ndim() == 2, "sparse matrix must be 2-d, actual {}-d",
+                 m.ndim());
+    bool csr = layout == Layout::kCsr;
+    auto outer = csr ? m.rows() : m.cols();
+    auto inner = csr ? m.cols() : m.rows();
+    std::vector<int64_t> indptr = {0};
+    std::vector<int64_t> indices;
+    std::vector<T> values;
+    for (Eigen::Index i = 0; i < outer; ++i) {
+      for (Eigen::Index j = 0; j < inner; ++j) {
+        const T &v = csr ? m(i, j) : m(j, i);
+        if (!v.IsZero()) {
+          indices.push_back(j);
+          values.push_back(v);
+        }
+      }
+      indptr.push_back(indices.size());
+    }
+    return {m.rows(), m.cols(), layout, std::move(indptr), std::move(indices),
+            std::move(values)};
+  }
+
+  // Convert between CSR and CSC, returns a copy if the layout is the same
+  [[nodiscard]] SparseMatrix<T> ToLayout(Layout layout) const {
+    if (layout == layout_) {
+      return *this;
+    }
+
+    // counting sort on the inner indices
+    std::vector<int64_t> indptr(InnerSize() + 1, 0);
+    for (auto idx : indices_) {
+      ++indptr[idx + 1];
+    }
+    std::partial_sum(indptr.begin(), indptr.end(), indptr.begin());
+
+    std::vector<int64_t> next(indptr.begin(), indptr.end() - 1);
+    std::vector<int64_t> indices(nnz());
+    std::vector<T> values(nnz());
+    for (int64_t i = 0; i < OuterSize(); ++i) {
+      for (auto p = indptr_[i]; p < indptr_[i + 1]; ++p) {
+        auto dst = next[indices_[p]]++;
+        indices[dst] = i;
+        values[dst] = values_[p];
+      }
+    }
+    return {rows_, cols_, layout, std::move(indptr), std::move(indices),
+            std::move(values)};
+  }
+
+  [[nodiscard]] Eigen::Index rows() const { return rows_; }
+
+  [[nodiscard]] Eigen::Index cols() const { return cols_; }
+
+  [[nodiscard]] Layout layout() const { return layout_; }
+
+  [[nodiscard]] int64_t ndim() const { return 2; }
+
+  [[nodiscard]] Shape shape() const { return {rows_, cols_}; }
+
+  // number of stored elements
+  [[nodiscard]] int64_t nnz() const { return indices_.size(); }
+
+  // number of rows for CSR, number of columns for CSC
+  [[nodiscard]] int64_t OuterSize() const {
+    return layout_ == Layout::kCsr ? rows_ : cols_;
+  }
+
+  [[nodiscard]] int64_t InnerSize() const {
+    return layout_ == Layout::kCsr ? cols_ : rows_;
+  }
+
+  const std::vector<int64_t> &indptr() const { return indptr_; }
+
+  const std::vector<int64_t> &indices() const { return indices_; }
+
+  const std::vector<T> &values() const { return values_; }
+
+ private:
+  Eigen::Index rows_;
+  Eigen::Index cols_;
+  Layout layout_;
+  std::vector<int64_t> indptr_;
+  std::vector<int64_t> indices_;
+  std::vector<T> values_;
+};
+
+using PSparseMatrix = SparseMatrix<phe::Plaintext>;
+
+}  // namespace heu::lib::numpy
@@ -0,0 +1,114 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "heu/library/numpy/executor.h"
+
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "heu/library/numpy/test/test_tools.h"
+
+namespace heu::lib::numpy::test {
+
+class ExecutorTest : public ::testing::Test {
+ protected:
+  HeKit he_kit_ = HeKit(phe::HeKit(phe::SchemaType::ZPaillier, 2048));
+};
+
+TEST_F(ExecutorTest, PipelineWorks) {
+  auto encryptor = he_kit_.GetEncryptor();
+  auto evaluator = he_kit_.GetEvaluator();
+  auto decryptor = he_kit_.GetDecryptor();
+  auto weight = GenMatrix(he_kit_.GetSchemaType(), 4, 2, 3);
+
+  std::vector<PMatrix> batches;
+  for (int i = 0; i < 5; ++i) {
+    batches.push_back(GenMatrix(he_kit_.GetSchemaType(), 6, 4, i * 10 - 20));
+  }
+
+  // encrypt -> matmul -> decrypt, each stage overlaps with the others. Tasks
+  // are queued after the tasks they wait for, so with a FIFO queue a task
+  // never waits for one that no worker has picked up.
+  HeExecutor executor(2, 2);
+  std::vector<HeFuture<PMatrix>> results;
+  for (const auto &batch : batches) {
+    auto ct = executor.Submit([&] { return encryptor->Encrypt(batch); });
+    auto prod = executor.Submit(
+        [&, ct = std::make_shared<HeFuture<CMatrix>>(std::move(ct))] {
+          return evaluator->MatMul(ct->Get(), weight);
+        });
+    results.push_back(executor.Submit(
+        [&, prod = std::make_shared<HeFuture<CMatrix>>(std::move(prod))] {
+          return decryptor->Decrypt(prod->Get());
+        }));
+  }
+
+  for (size_t i = 0; i < batches.size(); ++i) {
+    AssertMatrixEq(results[i].Get(), evaluator->MatMul(batches[i], weight));
+  }
+}
+
+TEST_F(ExecutorTest, CancelWorks) {
+  HeExecutor executor(1, 2);
+  std::promise<void> gate;
+  auto blocker = executor.Submit(
+      [gate = gate.get_future().share()] { gate.wait(); });
+  auto pending = executor.Submit([] { return 1; });
+
+  EXPECT_TRUE(pending.Cancel());
+  EXPECT_TRUE(pending.IsReady());
+  EXPECT_THROW(pending.Get(), yacl::Exception);
+
+  auto failed = executor.Submit([]() -> int { YACL_THROW("oops"); });
+  gate.set_value();
+  blocker.Get();
+  EXPECT_THROW(failed.Get(), yacl::Exception);
+  EXPECT_FALSE(blocker.Cancel());  // already finished
+
+  executor.Shutdown();
+  EXPECT_THROW(executor.Submit([] {}), yacl::EnforceNotMet);
+}
+
+TEST_F(ExecutorTest, CancelFreesQueueSlot) {
+  HeExecutor executor(1, 1);
+  std::promise<void> started;
+  std::promise<void> gate;
+  auto blocker = executor.Submit(
+      [&started, gate = gate.get_future().share()] {
+        started.set_value();
+        gate.wait();
+      });
+  started.get_future().wait();
+  auto pending = executor.Submit([] { return 1; });  // the queue is full now
+
+  std::promise<HeFuture<int>> submitted;
+  std::thread producer(
+      [&] { submitted.set_value(executor.Submit([] { return 2; })); });
+  // let the producer block on the full queue, the cancel must wake it up
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_TRUE(pending.Cancel());
+  auto next = submitted.get_future();
+  EXPECT_EQ(next.wait_for(std::chrono::seconds(10)), std::future_status::ready);
+
+  gate.set_value();
+  producer.join();
+  blocker.Get();
+  EXPECT_EQ(next.get().Get(), 2);
+}
+
+}  // namespace heu::lib::numpy::test
@@ -0,0 +1,133 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "gtest/gtest.h"
+
+#include "heu/library/numpy/test/test_tools.h"
+
+namespace heu::lib::numpy::test {
+
+class LazyTest : public ::testing::Test {
+ protected:
+  HeKit he_kit_ = HeKit(phe::HeKit(phe::SchemaType::ZPaillier, 2048));
+  std::shared_ptr<Evaluator> evaluator_ = he_kit_.GetEvaluator();
+  LazyEvaluator lazy_ = LazyEvaluator(evaluator_);
+};
+
+TEST_F(LazyTest, FusionWorks) {
+  auto pts1 = GenMatrix(he_kit_.GetSchemaType(), 3, 4, -5);
+  auto pts2 = GenMatrix(he_kit_.GetSchemaType(), 3, 4, 7);
+  auto row = GenMatrix(he_kit_.GetSchemaType(), 1, 4, 2);
+  auto cts1 = he_kit_.GetEncryptor()->Encrypt(pts1);
+
+  // (ct1 + pt2) * row - pt1, with broadcast
+  auto x = lazy_.Input(cts1);
+  auto expr = lazy_.Sub(
+      lazy_.Mul(lazy_.Add(x, lazy_.Input(pts2)), lazy_.Input(row)),
+      lazy_.Input(pts1));
+  EXPECT_TRUE(expr.IsCiphertext());
+  EXPECT_EQ(expr.shape().ToString(), "(3,4)");
+
+  auto expected = evaluator_->Sub(
+      evaluator_->Mul(evaluator_->Add(pts1, pts2), row), pts1);
+  AssertMatrixEq(
+      he_kit_.GetDecryptor()->Decrypt(lazy_.Eval<phe::Ciphertext>(expr)),
+      expected);
+
+  // plaintext on the left of a ciphertext
+  auto expr2 = lazy_.Sub(lazy_.Input(pts2), lazy_.Mul(lazy_.Input(row), x));
+  AssertMatrixEq(
+      he_kit_.GetDecryptor()->Decrypt(lazy_.Eval<phe::Ciphertext>(expr2)),
+      evaluator_->Sub(pts2, evaluator_->Mul(pts1, row)));
+
+  auto pts3 = GenMatrix(he_kit_.GetSchemaType(), 2, 4);
+  EXPECT_THROW(lazy_.Mul(x, x), yacl::EnforceNotMet);
+  EXPECT_THROW(lazy_.Add(x, lazy_.Input(pts3)), yacl::EnforceNotMet);
+  EXPECT_THROW(lazy_.Eval<phe::Plaintext>(expr), yacl::EnforceNotMet);
+}
+
+TEST_F(LazyTest, CommonSubExpressionWorks) {
+  auto pts1 = GenMatrix(he_kit_.GetSchemaType(), 2, 3);
+  auto pts2 = GenMatrix(he_kit_.GetSchemaType(), 2, 3, 10);
+
+  auto a = lazy_.Add(lazy_.Input(pts1), lazy_.Input(pts2));
+  auto b = lazy_.Add(lazy_.Input(pts1), lazy_.Input(pts2));
+  auto c = lazy_.Mul(a, b);
+  EXPECT_EQ(lazy_.NumNodes(), 4);  // pts1, pts2, a, c
+
+  auto sum = evaluator_->Add(pts1, pts2);
+  AssertMatrixEq(lazy_.Eval<phe::Plaintext>(c), evaluator_->Mul(sum, sum));
+
+  // a view of another region is another input
+  PMatrixView v(pts1);
+  lazy_.Input(v.Slice({0, 1}));
+  EXPECT_EQ(lazy_.NumNodes(), 4);  // the new input node is already released
+  auto d = lazy_.Input(v.Slice({0, 1}));
+  EXPECT_EQ(d.shape().ToString(), "(1,3)");
+  EXPECT_EQ(lazy_.NumNodes(), 5);
+}
+
+TEST_F(LazyTest, ReleasedGraphsAreSwept) {
+  auto pts1 = GenMatrix(he_kit_.GetSchemaType(), 2, 3);
+  auto pts2 = GenMatrix(he_kit_.GetSchemaType(), 2, 3, 10);
+  auto kept = lazy_.Add(lazy_.Input(pts1), lazy_.Input(pts2));
+
+  // a new graph per iteration, as in a training loop
+  size_t max_table_size = 0;
+  for (int i = 0; i < 1000; ++i) {
+    auto a = GenMatrix(he_kit_.GetSchemaType(), 2, 3, i);
+    auto expr = lazy_.Mul(lazy_.Add(lazy_.Input(a), kept), lazy_.Input(pts1));
+    lazy_.Eval<phe::Plaintext>(expr);
+    max_table_size = std::max(max_table_size, lazy_.TableSize());
+  }
+  EXPECT_EQ(lazy_.NumNodes(), 3);  // pts1, pts2, kept
+  EXPECT_LE(max_table_size, 64);
+}
+
+TEST_F(LazyTest, SumOfMatMulWorks) {
+  auto pts1 = GenMatrix(he_kit_.GetSchemaType(), 4, 3, -6);
+  auto pts2 = GenMatrix(he_kit_.GetSchemaType(), 3, 5, 1);
+  auto cts1 = he_kit_.GetEncryptor()->Encrypt(pts1);
+  auto cts2 = he_kit_.GetEncryptor()->Encrypt(pts2);
+  auto expected = evaluator_->Sum(evaluator_->MatMul(pts1, pts2));
+
+  auto res = lazy_.Eval<phe::Ciphertext>(
+      lazy_.Sum(lazy_.MatMul(lazy_.Input(cts1), lazy_.Input(pts2))));
+  EXPECT_EQ(res.ndim(), 0);
+  EXPECT_EQ(he_kit_.GetDecryptor()->Decrypt(res(0, 0)), expected);
+
+  res = lazy_.Eval<phe::Ciphertext>(
+      lazy_.Sum(lazy_.MatMul(lazy_.Input(pts1), lazy_.Input(cts2))));
+  EXPECT_EQ(he_kit_.GetDecryptor()->Decrypt(res(0, 0)), expected);
+
+  // vector @ matrix and matrix @ vector
+  auto vec = GenVector(he_kit_.GetSchemaType(), 3, 2);
+  auto mm = lazy_.MatMul(lazy_.Input(vec), lazy_.Input(cts2));
+  EXPECT_EQ(mm.shape().ToString(), "(5)");
+  auto mv = lazy_.MatMul(lazy_.Input(cts1), lazy_.Input(vec));
+  EXPECT_EQ(mv.shape().ToString(), "(4)");
+  EXPECT_EQ(he_kit_.GetDecryptor()->Decrypt(
+                lazy_.Eval<phe::Ciphertext>(lazy_.Sum(mm))(0, 0)),
+            evaluator_->Sum(evaluator_->MatMul(vec, pts2)));
+  EXPECT_EQ(he_kit_.GetDecryptor()->Decrypt(
+                lazy_.Eval<phe::Ciphertext>(lazy_.Sum(mv))(0, 0)),
+            evaluator_->Sum(evaluator_->MatMul(pts1, vec)));
+
+  // the matmul is also an output, so it is computed as usual
+  AssertMatrixEq(
+      he_kit_.GetDecryptor()->Decrypt(lazy_.Eval<phe::Ciphertext>(mv)),
+      evaluator_->MatMul(pts1, vec));
+}
+
+}  // namespace heu::lib::numpy::test
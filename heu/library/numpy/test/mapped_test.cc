@@ -0,0 +1,128 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <filesystem>
+#include <fstream>
+
+#include "gtest/gtest.h"
+
+#include "heu/library/numpy/test/test_tools.h"
+#include "heu/library/phe/record_codec.h"
+
+namespace heu::lib::numpy::test {
+
+class MappedTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    dir_ = std::filesystem::temp_directory_path() /
+           fmt::format("heu_mapped_test_{}", ::testing::UnitTest::GetInstance()
+                                                 ->current_test_info()
+                                                 ->name());
+    std::filesystem::create_directories(dir_);
+  }
+
+  void TearDown() override { std::filesystem::remove_all(dir_); }
+
+  std::string Path(const std::string &name) const { return dir_ / name; }
+
+  HeKit he_kit_ = HeKit(phe::HeKit(phe::SchemaType::ZPaillier, 2048));
+  std::filesystem::path dir_;
+};
+
+TEST_F(MappedTest, StorageWorks) {
+  auto pts = GenMatrix(he_kit_.GetSchemaType(), 7, 3, -10);
+  auto cts = he_kit_.GetEncryptor()->Encrypt(pts);
+  auto decryptor = he_kit_.GetDecryptor();
+
+  {
+    auto mapped = MappedCMatrix::FromMatrix(Path("x.bin"), cts);
+    EXPECT_EQ(mapped.shape().ToString(), "(7,3)");
+    AssertMatrixEq(decryptor->Decrypt(mapped.ReadRows(2, 4)),
+                   decryptor->Decrypt(CMatrixView(cts).Slice({2, 4})
+                                          .Materialize()));
+  }
+
+  auto mapped = MappedCMatrix::Open(Path("x.bin"));
+  AssertMatrixEq(decryptor->Decrypt(mapped.Load()), pts);
+  EXPECT_THROW(mapped.WriteRows(0, cts), yacl::EnforceNotMet);  // read-only
+  EXPECT_THROW((void)mapped.ReadRows(5, 3), yacl::EnforceNotMet);
+
+  // elements are not written yet
+  auto empty = MappedCMatrix::Create(Path("y.bin"), {7, 3},
+                                     mapped.record_bytes());
+  EXPECT_THROW((void)empty.Load(), yacl::EnforceNotMet);
+  // a record too small for a ciphertext
+  auto small = MappedCMatrix::Create(Path("z.bin"), {7, 3}, 16);
+  EXPECT_THROW(small.WriteRows(0, cts), yacl::EnforceNotMet);
+}
+
+TEST_F(MappedTest, CorruptHeaderThrows) {
+  (void)MappedCMatrix::Create(Path("x.bin"), {0, 3}, 64);
+  EXPECT_EQ(MappedCMatrix::Open(Path("x.bin")).shape().ToString(), "(0,3)");
+
+  // rows * cols wraps around to 0, which matches the size of the file
+  {
+    std::fstream f(Path("x.bin"),
+                   std::ios::in | std::ios::out | std::ios::binary);
+    uint8_t dims[16] = {};
+    phe::StoreLittleEndian(int64_t{1} << 62, dims);
+    phe::StoreLittleEndian(int64_t{4}, dims + 8);
+    f.seekp(16);
+    f.write(reinterpret_cast<const char *>(dims), sizeof(dims));
+  }
+  EXPECT_THROW((void)MappedCMatrix::Open(Path("x.bin")), std::exception);
+}
+
+TEST_F(MappedTest, StreamingOpsWork) {
+  auto schema = he_kit_.GetSchemaType();
+  auto evaluator = he_kit_.GetEvaluator();
+  auto decryptor = he_kit_.GetDecryptor();
+  auto pts1 = GenMatrix(schema, 20, 3, -30);
+  auto pts2 = GenMatrix(schema, 20, 3, 5);
+  auto x = MappedCMatrix::FromMatrix(Path("x.bin"),
+                                     he_kit_.GetEncryptor()->Encrypt(pts1));
+  auto y = MappedCMatrix::FromMatrix(Path("y.bin"),
+                                     he_kit_.GetEncryptor()->Encrypt(pts2));
+  // small chunks to cover the chunk boundaries
+  const int64_t chunk = 7;
+
+  auto out = MappedCMatrix::Create(Path("add.bin"), x.shape(),
+                                   x.record_bytes());
+  evaluator->Add(x, y, &out, chunk);
+  AssertMatrixEq(decryptor->Decrypt(out.Load()), evaluator->Add(pts1, pts2));
+
+  EXPECT_EQ(decryptor->Decrypt(evaluator->Sum(x, chunk)),
+            evaluator->Sum(pts1));
+
+  auto w = GenMatrix(schema, 3, 2, 1);
+  auto xw = MappedCMatrix::Create(Path("xw.bin"), {20, 2}, x.record_bytes());
+  evaluator->MatMul(x, w, &xw, chunk);
+  AssertMatrixEq(decryptor->Decrypt(xw.Load()), evaluator->MatMul(pts1, w));
+
+  auto v = GenMatrix(schema, 4, 20, 2);
+  AssertMatrixEq(decryptor->Decrypt(evaluator->MatMul(v, y, chunk)),
+                 evaluator->MatMul(v, pts2));
+
+  RowMatrixXd order_map = RowMatrixXd::NullaryExpr(
+      20, 2, [](Eigen::Index i, Eigen::Index j) {
+        return static_cast<int8_t>((i + j) % 4);
+      });
+  for (bool cumsum : {false, true}) {
+    AssertMatrixEq(decryptor->Decrypt(evaluator->FeatureWiseBucketSum(
+                       x, order_map, 4, cumsum, chunk)),
+                   evaluator->FeatureWiseBucketSum(pts1, order_map, 4, cumsum));
+  }
+}
+
+}  // namespace heu::lib::numpy::test
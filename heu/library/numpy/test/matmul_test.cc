@@ -67,4 +67,85 @@ TEST_P(MatmulTest, MatmulWorks) {
   AssertMatrixEq(ans, he_kit_.GetDecryptor()->Decrypt(cts3));
 }
 
+TEST_P(MatmulTest, Int64MatmulWorks) {
+  int n = std::get<0>(GetParam());
+  int k = std::get<1>(GetParam());
+  int m = std::get<2>(GetParam());
+  auto schema = he_kit_.GetSchemaType();
+  auto cts1 = he_kit_.GetEncryptor()->Encrypt(GenMatrix(schema, n, k, 10));
+  auto cts2 = he_kit_.GetEncryptor()->Encrypt(GenMatrix(schema, k, m, 5));
+  const auto &evaluator = he_kit_.GetEvaluator();
+  const auto &decryptor = he_kit_.GetDecryptor();
+
+  // ct * int
+  AssertMatrixEq(
+      decryptor->Decrypt(
+          evaluator->MatMul(cts1, GenMatrix<IMatrix>(schema, k, m, -5))),
+      decryptor->Decrypt(evaluator->MatMul(cts1, GenMatrix(schema, k, m, -5))));
+
+  // int * ct
+  AssertMatrixEq(
+      decryptor->Decrypt(
+          evaluator->MatMul(GenMatrix<IMatrix>(schema, n, k, -10), cts2)),
+      decryptor->Decrypt(
+          evaluator->MatMul(GenMatrix(schema, n, k, -10), cts2)));
+
+  // vector operands
+  AssertMatrixEq(
+      decryptor->Decrypt(
+          evaluator->MatMul(cts1, GenVector<IMatrix>(schema, k, 3))),
+      decryptor->Decrypt(evaluator->MatMul(cts1, GenVector(schema, k, 3))));
+  AssertMatrixEq(
+      decryptor->Decrypt(
+          evaluator->MatMul(GenVector<IMatrix>(schema, n, 3), cts1)),
+      decryptor->Decrypt(evaluator->MatMul(GenVector(schema, n, 3), cts1)));
+}
+
+TEST_P(MatmulTest, SparseMatmulWorks) {
+  int n = std::get<0>(GetParam());
+  int k = std::get<1>(GetParam());
+  int m = std::get<2>(GetParam());
+  auto schema = he_kit_.GetSchemaType();
+  // mostly zeros, with some 1, -1 and other values
+  auto sparse_pts = [&](int rows, int cols) {
+    PMatrix res(rows, cols);
+    for (int i = 0; i < rows; ++i) {
+      for (int j = 0; j < cols; ++j) {
+        int v = (i * 7 + j * 3) % 11;
+        res(i, j) = phe::Plaintext(schema, v == 1   ? 1
+                                           : v == 2 ? -1
+                                           : v == 3 ? 5
+                                                    : 0);
+      }
+    }
+    return res;
+  };
+  auto pts1 = sparse_pts(n, k);
+  auto pts2 = sparse_pts(k, m);
+  auto cts1 = he_kit_.GetEncryptor()->Encrypt(GenMatrix(schema, n, k, -10));
+  auto cts2 = he_kit_.GetEncryptor()->Encrypt(GenMatrix(schema, k, m, -10));
+  const auto &evaluator = he_kit_.GetEvaluator();
+  const auto &decryptor = he_kit_.GetDecryptor();
+
+  for (auto layout :
+       {PSparseMatrix::Layout::kCsr, PSparseMatrix::Layout::kCsc}) {
+    // sparse pt * ct
+    auto sp1 = PSparseMatrix::FromDense(pts1, layout);
+    AssertMatrixEq(decryptor->Decrypt(evaluator->MatMul(sp1, cts2)),
+                   decryptor->Decrypt(evaluator->MatMul(pts1, cts2)));
+
+    // ct * sparse pt
+    auto sp2 = PSparseMatrix::FromDense(pts2, layout);
+    AssertMatrixEq(decryptor->Decrypt(evaluator->MatMul(cts1, sp2)),
+                   decryptor->Decrypt(evaluator->MatMul(cts1, pts2)));
+
+    // vector operands
+    auto vec = he_kit_.GetEncryptor()->Encrypt(GenVector(schema, k, 3));
+    AssertMatrixEq(decryptor->Decrypt(evaluator->MatMul(sp1, vec)),
+                   decryptor->Decrypt(evaluator->MatMul(pts1, vec)));
+    AssertMatrixEq(decryptor->Decrypt(evaluator->MatMul(vec, sp2)),
+                   decryptor->Decrypt(evaluator->MatMul(vec, pts2)));
+  }
+}
+
 }  // namespace heu::lib::numpy::test
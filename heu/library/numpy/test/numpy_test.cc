@@ -12,6 +12,8 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <limits>
+
 #include "gtest/gtest.h"
 
 #include "heu/library/numpy/test/test_tools.h"
@@ -108,6 +110,48 @@ TEST_F(NumpyTest, EvalDimWorks) {
   EXPECT_EQ(pts_sum.ndim(), 1);
 }
 
+TEST_F(NumpyTest, Int64MulWorks) {
+  auto schema = he_kit_.GetSchemaType();
+  auto evaluator = he_kit_.GetEvaluator();
+  auto decryptor = he_kit_.GetDecryptor();
+  auto cts = he_kit_.GetEncryptor()->Encrypt(GenMatrix(schema, 6, 4, -10));
+
+  // zero, +-1, short and wide multipliers
+  const int64_t values[] = {0,
+                            1,
+                            -1,
+                            12345,
+                            -(int64_t{1} << 40),
+                            std::numeric_limits<int64_t>::min()};
+  IMatrix ints(6, 4);
+  PMatrix pts(6, 4);
+  for (int64_t i = 0; i < ints.size(); ++i) {
+    ints.data()[i] = values[i % 6];
+    pts.data()[i] = phe::Plaintext(schema, values[i % 6]);
+  }
+  AssertMatrixEq(decryptor->Decrypt(evaluator->Mul(cts, ints)),
+                 decryptor->Decrypt(evaluator->Mul(cts, pts)));
+  // broadcast and views
+  AssertMatrixEq(
+      decryptor->Decrypt(evaluator->Mul(cts, GenMatrix<IMatrix>(schema, 1, 4))),
+      decryptor->Decrypt(evaluator->Mul(cts, GenMatrix(schema, 1, 4))));
+  AssertMatrixEq(
+      decryptor->Decrypt(evaluator->Mul(CMatrixView(cts).Transpose(),
+                                        IMatrixView(ints).Transpose())),
+      decryptor->Decrypt(evaluator->Mul(CMatrixView(cts).Transpose(),
+                                        PMatrixView(pts).Transpose())));
+
+  // algorithms without a Mul() for int64 get plaintexts
+  HeKit mock_kit(phe::HeKit(phe::SchemaType::Mock, 2048));
+  auto mock_cts = mock_kit.GetEncryptor()->Encrypt(
+      GenMatrix(phe::SchemaType::Mock, 6, 4, -10));
+  AssertMatrixEq(
+      mock_kit.GetDecryptor()->Decrypt(mock_kit.GetEvaluator()->Mul(
+          mock_cts, GenMatrix<IMatrix>(phe::SchemaType::Mock, 6, 4, -5))),
+      mock_kit.GetDecryptor()->Decrypt(mock_kit.GetEvaluator()->Mul(
+          mock_cts, GenMatrix(phe::SchemaType::Mock, 6, 4, -5))));
+}
+
 TEST_F(NumpyTest, SumWorks) {
   auto m = GenMatrix(he_kit_.GetSchemaType(), 30, 30);
   auto sum = he_kit_.GetEvaluator()->Sum(m);
@@ -119,6 +163,124 @@ TEST_F(NumpyTest, SumWorks) {
             899 * 900 / 2);
 }
 
+TEST_F(NumpyTest, ViewWorks) {
+  auto pts = GenMatrix(he_kit_.GetSchemaType(), 12, 8);
+  auto cts = he_kit_.GetEncryptor()->Encrypt(pts);
+  auto evaluator = he_kit_.GetEvaluator();
+
+  // rows 10, 7, 4, 1 and cols 0, 2, 4, 6, as cts[10::-3, ::2] in numpy
+  std::vector<int64_t> rows = {10, 7, 4, 1};
+  std::vector<int64_t> cols = {0, 2, 4, 6};
+  auto ct_view = CMatrixView(cts).Slice({10, 4, -3}, {0, 4, 2});
+  auto pt_view = PMatrixView(pts).Slice({10, 4, -3}, {0, 4, 2});
+  auto ct_copy = cts.GetItem(rows, cols);
+  auto pt_copy = pts.GetItem(rows, cols);
+  AssertMatrixEq(ct_view.Materialize(), ct_copy);
+  EXPECT_FALSE(ct_view.IsContiguous());
+
+  auto expected = he_kit_.GetDecryptor()->Decrypt(
+      evaluator->Add(ct_copy, pt_copy.Transpose()));
+  AssertMatrixEq(he_kit_.GetDecryptor()->Decrypt(
+                     evaluator->Add(ct_view, pt_view.Transpose())),
+                 expected);
+
+  expected = he_kit_.GetDecryptor()->Decrypt(evaluator->Sub(pt_copy, ct_copy));
+  AssertMatrixEq(
+      he_kit_.GetDecryptor()->Decrypt(evaluator->Sub(pt_view, ct_view)),
+      expected);
+
+  expected = he_kit_.GetDecryptor()->Decrypt(evaluator->Mul(ct_copy, pt_copy));
+  AssertMatrixEq(
+      he_kit_.GetDecryptor()->Decrypt(evaluator->Mul(ct_view, pt_view)),
+      expected);
+
+  // broadcast a single column
+  auto col_view = PMatrixView(pts).Slice({0, 12}, {3, 1});
+  AssertMatrixEq(evaluator->Add(pts, col_view.Materialize()),
+                 evaluator->Add(PMatrixView(pts), col_view));
+
+  expected = he_kit_.GetDecryptor()->Decrypt(
+      evaluator->MatMul(ct_copy.Transpose(), pt_copy));
+  AssertMatrixEq(he_kit_.GetDecryptor()->Decrypt(
+                     evaluator->MatMul(ct_view.Transpose(), pt_view)),
+                 expected);
+
+  auto vec = GenVector(he_kit_.GetSchemaType(), 12);
+  auto vec_view = PMatrixView(vec).Slice({0, 4, 3});
+  AssertMatrixEq(
+      evaluator->MatMul(vec_view, PMatrixView(pts).Slice({0, 4}, {0, 8})),
+      evaluator->MatMul(vec_view.Materialize(),
+                        pts.GetItem(std::vector<int64_t>{0, 1, 2, 3},
+                                    Eigen::placeholders::all)));
+
+  EXPECT_EQ(he_kit_.GetDecryptor()->Decrypt(evaluator->Sum(ct_view)),
+            evaluator->Sum(pt_copy));
+
+  auto buf = ct_view.Serialize();
+  AssertMatrixEq(CMatrix::LoadFrom(buf), ct_copy);
+}
+
+TEST_F(NumpyTest, InplaceWorks) {
+  auto evaluator = he_kit_.GetEvaluator();
+  auto decryptor = he_kit_.GetDecryptor();
+  auto pts1 = GenMatrix(he_kit_.GetSchemaType(), 20, 6);
+  auto pts2 = GenMatrix(he_kit_.GetSchemaType(), 1, 6, 100);
+  auto cts1 = he_kit_.GetEncryptor()->Encrypt(pts1);
+
+  // y is broadcast to the shape of x
+  auto expected = evaluator->Add(pts1, pts2);
+  evaluator->AddInplace(&cts1, pts2);
+  AssertMatrixEq(decryptor->Decrypt(cts1), expected);
+  evaluator->AddInplace(&pts1, pts2);
+  AssertMatrixEq(pts1, expected);
+
+  expected = evaluator->Sub(pts1, pts2);
+  evaluator->SubInplace(&cts1, he_kit_.GetEncryptor()->Encrypt(pts2));
+  AssertMatrixEq(decryptor->Decrypt(cts1), expected);
+  evaluator->SubInplace(&pts1, pts2);
+  AssertMatrixEq(pts1, expected);
+
+  expected = evaluator->Mul(pts1, pts2);
+  evaluator->MulInplace(&cts1, pts2);
+  AssertMatrixEq(decryptor->Decrypt(cts1), expected);
+  evaluator->MulInplace(&pts1, pts2);
+  AssertMatrixEq(pts1, expected);
+
+  // x cannot be broadcast
+  EXPECT_ANY_THROW(evaluator->AddInplace(&pts2, pts1));
+
+  // y = a * x + y
+  auto pts3 = GenMatrix(he_kit_.GetSchemaType(), 20, 6, 7);
+  auto cts3 = he_kit_.GetEncryptor()->Encrypt(pts3);
+  PMatrix a(1, 1);
+  a(0, 0) = phe::Plaintext(he_kit_.GetSchemaType(), -3);
+  evaluator->Axpy(a, cts1, &cts3);
+  AssertMatrixEq(decryptor->Decrypt(cts3),
+                 evaluator->Add(evaluator->Mul(pts1, a), pts3));
+
+  // out = out + x @ y
+  auto w = GenMatrix(he_kit_.GetSchemaType(), 6, 4, -10);
+  auto acc = evaluator->MatMul(cts3, w);
+  evaluator->MatMulAccumulate(cts1, w, &acc);
+  AssertMatrixEq(decryptor->Decrypt(acc),
+                 evaluator->Add(evaluator->MatMul(decryptor->Decrypt(cts3), w),
+                                evaluator->MatMul(pts1, w)));
+
+  auto bad_acc = evaluator->MatMul(w.Transpose(), w);
+  EXPECT_ANY_THROW(evaluator->MatMulAccumulate(pts1, w, &bad_acc));
+
+  // inputs must not overlap with the matrix written in place
+  EXPECT_THROW(evaluator->AddInplace(&pts1, PMatrixView(pts1).Slice({0, 1})),
+               yacl::EnforceNotMet);
+  EXPECT_THROW(evaluator->Axpy(a, cts3, &cts3), yacl::EnforceNotMet);
+  auto sq1 = GenMatrix(he_kit_.GetSchemaType(), 4, 4);
+  auto sq2 = GenMatrix(he_kit_.GetSchemaType(), 4, 4, 5);
+  EXPECT_THROW(evaluator->MatMulAccumulate(sq1, sq2, &sq1),
+               yacl::EnforceNotMet);
+  EXPECT_THROW(evaluator->MatMulAccumulate(sq1, sq2, &sq2),
+               yacl::EnforceNotMet);
+}
+
 TEST_F(NumpyTest, SelectSumWorks) {
   // plaintext case
   auto m = GenMatrix(he_kit_.GetSchemaType(), 30, 30);
@@ -205,4 +367,30 @@ TEST_F(NumpyTest, RangeCheckWorks) {
   EXPECT_NO_THROW(he_kit_.GetDecryptor()->Decrypt(cmatrix));
 }
 
+TEST(NumpyFloatTest, AlignExponentsWorks) {
+  HeKit he_kit(phe::HeKit(phe::SchemaType::FPaillier, 2048));
+  algorithms::paillier_f::Encryptor f_encryptor(
+      he_kit.GetPublicKey()->As<algorithms::paillier_f::PublicKey>());
+
+  // x and y hold ciphertexts of different exponents
+  CMatrix x(10, 5);
+  CMatrix y(10, 5);
+  PMatrix expected(10, 5);
+  for (int i = 0; i < x.rows(); ++i) {
+    for (int j = 0; j < x.cols(); ++j) {
+      x(i, j) = phe::Ciphertext(f_encryptor.Encrypt(i * 16.0 + 0.5));
+      y(i, j) = phe::Ciphertext(f_encryptor.Encrypt(j + 0.5));
+      expected(i, j) = phe::Plaintext(he_kit.GetSchemaType(), i * 16 + j + 1);
+    }
+  }
+
+  auto evaluator = he_kit.GetEvaluator();
+  auto unaligned_sum = evaluator->Add(x, y);
+  evaluator->AlignExponentsInplace(&x, &y);
+  auto aligned_sum = evaluator->Add(x, y);
+
+  AssertMatrixEq(he_kit.GetDecryptor()->Decrypt(unaligned_sum), expected);
+  AssertMatrixEq(he_kit.GetDecryptor()->Decrypt(aligned_sum), expected);
+}
+
 }  // namespace heu::lib::numpy::test
@@ -0,0 +1,62 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "heu/library/numpy/trace.h"
+
+#include "gtest/gtest.h"
+
+#include "heu/library/numpy/test/test_tools.h"
+
+namespace heu::lib::numpy::test {
+
+class TraceTest : public ::testing::Test {
+ protected:
+  HeKit he_kit_ = HeKit(phe::HeKit(phe::SchemaType::Mock, 2048));
+};
+
+TEST_F(TraceTest, RecordKernels) {
+  if constexpr (!Tracer::kCompiledIn) {
+    EXPECT_ANY_THROW(Tracer::Start());
+    GTEST_SKIP() << "built without --config=trace";
+  }
+
+  auto schema = he_kit_.GetSchemaType();
+  auto x = he_kit_.GetEncryptor()->Encrypt(GenMatrix(schema, 64, 8));
+  auto y = GenMatrix(schema, 8, 4);
+  Eigen::Matrix<int8_t, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>
+      order_map = Eigen::Matrix<int8_t, Eigen::Dynamic, Eigen::Dynamic,
+                                Eigen::RowMajor>::Zero(64, 2);
+
+  Tracer::Start();
+  auto evaluator = he_kit_.GetEvaluator();
+  evaluator->MatMul(x, y);
+  evaluator->FeatureWiseBucketSum(x, order_map, 3);
+  Tracer::Stop();
+  // not recorded
+  evaluator->Sum(x);
+
+  auto json = Tracer::ToJson();
+  EXPECT_NE(json.find(R"("name":"MatMul","cat":"kernel")"), std::string::npos);
+  EXPECT_NE(json.find(R"("name":"MatMul","cat":"chunk")"), std::string::npos);
+  EXPECT_NE(json.find(R"("name":"FeatureWiseBucketSum.column","cat":"serial")"),
+            std::string::npos);
+  EXPECT_EQ(json.find(R"("name":"Sum")"), std::string::npos);
+
+  // restart drops the old spans
+  Tracer::Start();
+  Tracer::Stop();
+  EXPECT_EQ(Tracer::ToJson().find("MatMul"), std::string::npos);
+}
+
+}  // namespace heu::lib::numpy::test
@@ -0,0 +1,188 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "heu/library/numpy/trace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "fmt/format.h"
+#include "yacl/base/exception.h"
+
+namespace heu::lib::numpy {
+
+namespace {
+
+struct Event {
+  const char *name;
+  const char *category;
+  phe::SchemaType schema;
+  int64_t begin;
+  int64_t end;
+  int64_t ts_ns;  // since Tracer::Start()
+  int64_t dur_ns;
+};
+
+struct ThreadBuffer {
+  uint32_t tid;
+  // only contended by ToJson() and Start()
+  std::mutex mu;
+  std::vector<Event> events;
+};
+
+struct Registry {
+  std::mutex mu;
+  // A buffer is shared by the registry and its thread, use_count() == 1
+  // means the thread has exited
+  std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+  uint32_t next_tid = 1;
+  // steady clock time of Tracer::Start(), in nanoseconds
+  std::atomic<int64_t> origin_ns{0};
+};
+
+int64_t NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// Leaked on purpose, threads may exit after static destruction
+Registry &GetRegistry() {
+  static auto *registry = new Registry();
+  return *registry;
+}
+
+ThreadBuffer &LocalBuffer() {
+  thread_local std::shared_ptr<ThreadBuffer> buffer = [] {
+    auto res = std::make_shared<ThreadBuffer>();
+    auto &registry = GetRegistry();
+    std::lock_guard<std::mutex> guard(registry.mu);
+    res->tid = registry.next_tid++;
+    registry.buffers.push_back(res);
+    return res;
+  }();
+  return *buffer;
+}
+
+thread_local trace::KernelContext tls_kernel;
+
+}  // namespace
+
+void Tracer::Start() {
+  YACL_ENFORCE(kCompiledIn,
+               "HEU is built without tracing, please rebuild with "
+               "--config=trace");
+  auto &registry = GetRegistry();
+  std::lock_guard<std::mutex> guard(registry.mu);
+  auto &buffers = registry.buffers;
+  buffers.erase(
+      std::remove_if(buffers.begin(), buffers.end(),
+                     [](const auto &b) { return b.use_count() == 1; }),
+      buffers.end());
+  for (auto &buffer : buffers) {
+    std::lock_guard<std::mutex> buffer_guard(buffer->mu);
+    buffer->events.clear();
+  }
+  registry.origin_ns.store(NowNs(), std::memory_order_relaxed);
+  recording_.store(true, std::memory_order_relaxed);
+}
+
+void Tracer::Stop() { recording_.store(false, std::memory_order_relaxed); }
+
+std::string Tracer::ToJson() {
+  auto &registry = GetRegistry();
+  std::lock_guard<std::mutex> guard(registry.mu);
+
+  fmt::memory_buffer out;
+  fmt::format_to(std::back_inserter(out), "{{\"traceEvents\":[");
+  bool first = true;
+  for (const auto &buffer : registry.buffers) {
+    std::lock_guard<std::mutex> buffer_guard(buffer->mu);
+    for (const auto &e : buffer->events) {
+      // timestamps are in microseconds
+      fmt::format_to(
+          std::back_inserter(out),
+          "{}\n{{\"name\":\"{}\",\"cat\":\"{}\",\"ph\":\"X\",\"pid\":0,"
+          "\"tid\":{},\"ts\":{:.3f},\"dur\":{:.3f},\"args\":{{\"schema\":"
+          "\"{}\",\"begin\":{},\"end\":{}}}}}",
+          first ? "" : ",", e.name, e.category, buffer->tid, e.ts_ns / 1e3,
+          e.dur_ns / 1e3, phe::SchemaToString(e.schema), e.begin, e.end);
+      first = false;
+    }
+  }
+  fmt::format_to(std::back_inserter(out), "\n],\"displayTimeUnit\":\"ms\"}}\n");
+  return fmt::to_string(out);
+}
+
+void Tracer::DumpJson(const std::string &path) {
+  std::ofstream file(path, std::ios::out | std::ios::trunc);
+  YACL_ENFORCE(file.is_open(), "cannot open trace file {}", path);
+  file << ToJson();
+  YACL_ENFORCE(file.good(), "failed to write trace file {}", path);
+}
+
+namespace trace {
+
+KernelContext CurrentKernel() { return tls_kernel; }
+
+Span::Span(const char *name, const char *category, phe::SchemaType schema,
+           int64_t begin, int64_t end)
+    : category_(category), schema_(schema), begin_(begin), end_(end) {
+  if (name != nullptr && Tracer::IsRecording()) {
+    name_ = name;
+    start_ns_ = NowNs();
+  }
+}
+
+Span::~Span() {
+  if (name_ == nullptr) {
+    return;
+  }
+  auto end_ns = NowNs();
+  auto origin_ns = GetRegistry().origin_ns.load(std::memory_order_relaxed);
+
+  auto &buffer = LocalBuffer();
+  std::lock_guard<std::mutex> guard(buffer.mu);
+  buffer.events.push_back({name_, category_, schema_, begin_, end_,
+                           start_ns_ - origin_ns, end_ns - start_ns_});
+}
+
+KernelSpan::KernelSpan(const char *name, phe::SchemaType schema,
+                       int64_t num_elements)
+    : Span(name, "kernel", schema, 0, num_elements), prev_(tls_kernel) {
+  if (name_ != nullptr) {
+    tls_kernel = {name, schema};
+  }
+}
+
+KernelSpan::~KernelSpan() { tls_kernel = prev_; }
+
+ChunkSpan::ChunkSpan(const KernelContext &kernel, int64_t begin, int64_t end)
+    : Span(kernel.name, "chunk", kernel.schema, begin, end) {}
+
+ChunkSpan::ChunkSpan(const KernelContext &kernel, const char *name,
+                     int64_t begin, int64_t end)
+    : Span(kernel.name == nullptr ? nullptr : name, "chunk", kernel.schema,
+           begin, end) {}
+
+SerialSpan::SerialSpan(const char *name, int64_t begin, int64_t end)
+    : Span(name, "serial", tls_kernel.schema, begin, end) {}
+
+}  // namespace trace
+}  // namespace heu::lib::numpy
@@ -0,0 +1,156 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+#include "heu/library/phe/base/schema.h"
+
+// Opt-in span tracer for the parallel kernels of numpy::Evaluator.
+//
+// Records begin/end spans per kernel call (e.g. MatMul) and per parallel
+// chunk of that kernel, with thread id, element range and schema, and dumps
+// them as Chrome trace JSON, which can be opened by chrome://tracing or
+// https://ui.perfetto.dev.
+//
+// Tracing is compiled out unless HEU_ENABLE_TRACE is defined, i.e. build with
+// `bazel build --config=trace ...`. Then it still has to be turned on at
+// runtime:
+//   Tracer::Start();
+//   ... run kernels ...
+//   Tracer::Stop();
+//   Tracer::DumpJson("/tmp/heu_trace.json");
+//
+// In kernel code:
+//   HEU_TRACE_KERNEL("MatMul", GetSchemaType(), out.size());
+//   HEU_TRACE_CAPTURE(ctx);  // must run in the thread calling parallel_for
+//   yacl::parallel_for(0, n, 1, [&](int64_t beg, int64_t end) {
+//     HEU_TRACE_CHUNK(ctx, beg, end);
+//     ...
+//   });
+// Chunk spans are only recorded inside a kernel span, so generic helpers
+// (e.g. DenseMatrix::ForEach) can be instrumented without adding noise.
+
+namespace heu::lib::numpy {
+
+class Tracer {
+ public:
+  // Drop previously recorded spans and start recording
+  static void Start();
+  static void Stop();
+  static bool IsRecording() {
+    return recording_.load(std::memory_order_relaxed);
+  }
+
+  // {"traceEvents": [...]} with one complete ("X") event per span
+  static std::string ToJson();
+  static void DumpJson(const std::string &path);
+
+#ifdef HEU_ENABLE_TRACE
+  static constexpr bool kCompiledIn = true;
+#else
+  static constexpr bool kCompiledIn = false;
+#endif
+
+ private:
+  static inline std::atomic<bool> recording_{false};
+};
+
+namespace trace {
+
+// The kernel that is running on the current thread, or name == nullptr
+struct KernelContext {
+  const char *name = nullptr;
+  phe::SchemaType schema = phe::SchemaType::Mock;
+};
+
+KernelContext CurrentKernel();
+
+// name and category must be string literals (or otherwise outlive the trace).
+// Nothing is recorded if name is nullptr or the tracer is not recording.
+class Span {
+ public:
+  Span(const char *name, const char *category, phe::SchemaType schema,
+       int64_t begin, int64_t end);
+  ~Span();
+
+  Span(const Span &) = delete;
+  Span &operator=(const Span &) = delete;
+
+ protected:
+  const char *name_ = nullptr;  // nullptr if not recording
+  const char *category_;
+  phe::SchemaType schema_;
+  int64_t begin_;
+  int64_t end_;
+  int64_t start_ns_ = 0;
+};
+
+// Span of a whole kernel call, chunk spans started by this thread are
+// attributed to it
+class KernelSpan : public Span {
+ public:
+  KernelSpan(const char *name, phe::SchemaType schema, int64_t num_elements);
+  ~KernelSpan();
+
+ private:
+  KernelContext prev_;
+};
+
+// Span of elements [begin, end) processed by one parallel task, not recorded
+// if 'kernel' is empty. The span is named after the kernel, or 'name' for a
+// nested parallel loop whose range means something else.
+class ChunkSpan : public Span {
+ public:
+  ChunkSpan(const KernelContext &kernel, int64_t begin, int64_t end);
+  ChunkSpan(const KernelContext &kernel, const char *name, int64_t begin,
+            int64_t end);
+};
+
+// Span of a serial section of the current kernel, e.g. one iteration of an
+// outer loop
+class SerialSpan : public Span {
+ public:
+  SerialSpan(const char *name, int64_t begin, int64_t end);
+};
+
+}  // namespace trace
+}  // namespace heu::lib::numpy
+
+#define HEU_TRACE_CONCAT_IMPL(a, b) a##b
+#define HEU_TRACE_CONCAT(a, b) HEU_TRACE_CONCAT_IMPL(a, b)
+#define HEU_TRACE_VAR HEU_TRACE_CONCAT(heu_trace_span_, __COUNTER__)
+
+#ifdef HEU_ENABLE_TRACE
+#define HEU_TRACE_KERNEL(name, schema, num_elements) \
+  ::heu::lib::numpy::trace::KernelSpan HEU_TRACE_VAR(name, schema, num_elements)
+#define HEU_TRACE_CAPTURE(ctx) \
+  const auto ctx = ::heu::lib::numpy::trace::CurrentKernel()
+#define HEU_TRACE_CHUNK(ctx, begin, end) \
+  ::heu::lib::numpy::trace::ChunkSpan HEU_TRACE_VAR(ctx, begin, end)
+#define HEU_TRACE_NAMED_CHUNK(ctx, name, begin, end) \
+  ::heu::lib::numpy::trace::ChunkSpan HEU_TRACE_VAR(ctx, name, begin, end)
+#define HEU_TRACE_SERIAL(name, begin, end) \
+  ::heu::lib::numpy::trace::SerialSpan HEU_TRACE_VAR(name, begin, end)
+#else
+// arguments are not evaluated
+#define HEU_TRACE_KERNEL(name, schema, num_elements) static_cast<void>(0)
+#define HEU_TRACE_CAPTURE(ctx) static_cast<void>(0)
+#define HEU_TRACE_CHUNK(ctx, begin, end) static_cast<void>(0)
+#define HEU_TRACE_NAMED_CHUNK(ctx, name, begin, end) static_cast<void>(0)
+#define HEU_TRACE_SERIAL(name, begin, end) static_cast<void>(0)
+#endif
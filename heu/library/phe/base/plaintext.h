@@ -19,6 +19,9 @@
 
 namespace heu::lib::phe {
 
+// A plaintext always holds a full big integer of the schema, even for small
+// values. For tensors of small integer multipliers, numpy::IMatrix holds them
+// inline as int64 instead.
 class Plaintext : public SerializableVariant<HE_PLAINTEXT_TYPES> {
  public:
   using SerializableVariant<HE_PLAINTEXT_TYPES>::SerializableVariant;
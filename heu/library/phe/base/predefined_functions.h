@@ -15,8 +15,10 @@
 #pragma once
 
 #include <experimental/type_traits>
+#include <vector>
 
 #include "absl/types/span.h"
+#include "yacl/utils/parallel.h"
 
 namespace heu::lib::phe {
 
@@ -161,4 +163,150 @@ namespace heu::lib::phe {
     DoCall##func(eval, &((in_out1)->As<ns::type1>()), (in2).As<ns::type2>()); \
   }
 
+// invoke batch functions //
+//
+// A batch function dispatches the schema only once for the whole batch, then
+// splits the batch into parallel chunks. Each chunk is passed to the
+// vectorized SPI if the algorithm implements it, otherwise the scalar SPI is
+// called element by element.
+
+// invoke batch functions with 1 args (with return value) //
+
+#define DEFINE_INVOKE_BATCH_METHOD_RET_1(ret, func)                         \
+  template <typename CLAZZ, typename TYPE1>                                 \
+  using kHasVectorized##func = decltype(std::declval<const CLAZZ &>().func( \
+      absl::Span<const TYPE1 *const>()));                                   \
+                                                                            \
+  /* Call vectorized SPI */                                                 \
+  template <typename CLAZZ, typename TYPE1, typename IN1>                   \
+  auto DoCallBatch##func(const CLAZZ &sub_clazz, absl::Span<const IN1> in1, \
+                         ret *out)                                          \
+      ->std::enable_if_t<                                                   \
+          std::experimental::is_detected_v<kHasVectorized##func, CLAZZ,     \
+                                           TYPE1>> {                        \
+    yacl::parallel_for(0, in1.size(), 1, [&](int64_t beg, int64_t end) {    \
+      std::vector<const TYPE1 *> in1_ptrs;                                  \
+      in1_ptrs.reserve(end - beg);                                          \
+      for (int64_t i = beg; i < end; ++i) {                                 \
+        in1_ptrs.push_back(&in1[i].template As<TYPE1>());                   \
+      }                                                                     \
+      auto res = sub_clazz.func(absl::MakeConstSpan(in1_ptrs));             \
+      for (int64_t i = beg; i < end; ++i) {                                 \
+        out[i] = ret(std::move(res[i - beg]));                              \
+      }                                                                     \
+    });                                                                     \
+  }                                                                         \
+                                                                            \
+  /* Call scalar SPI */                                                     \
+  template <typename CLAZZ, typename TYPE1, typename IN1>                   \
+  auto DoCallBatch##func(const CLAZZ &sub_clazz, absl::Span<const IN1> in1, \
+                         ret *out)                                          \
+      ->std::enable_if_t<                                                   \
+          !std::experimental::is_detected_v<kHasVectorized##func, CLAZZ,    \
+                                            TYPE1>> {                       \
+    yacl::parallel_for(0, in1.size(), 1, [&](int64_t beg, int64_t end) {    \
+      for (int64_t i = beg; i < end; ++i) {                                 \
+        out[i] = ret(sub_clazz.func(in1[i].template As<TYPE1>()));          \
+      }                                                                     \
+    });                                                                     \
+  }
+
+#define DO_INVOKE_BATCH_METHOD_RET_1(ns, clazz, func, type1, in1, out) \
+  [&](const ns::clazz &eval) {                                         \
+    DoCallBatch##func<ns::clazz, ns::type1>(eval, in1, out);           \
+  }
+
+// invoke batch functions with 1 args (no return value) //
+
+#define DEFINE_INVOKE_BATCH_METHOD_VOID_1(func)                              \
+  template <typename CLAZZ, typename TYPE1>                                  \
+  using kHasVectorized##func = decltype(std::declval<const CLAZZ &>().func(  \
+      absl::Span<TYPE1 *const>()));                                          \
+                                                                             \
+  /* Call vectorized SPI */                                                  \
+  template <typename CLAZZ, typename TYPE1, typename IN1>                    \
+  auto DoCallBatch##func(const CLAZZ &sub_clazz, absl::Span<IN1> in_out1)    \
+      ->std::enable_if_t<                                                    \
+          std::experimental::is_detected_v<kHasVectorized##func, CLAZZ,      \
+                                           TYPE1>> {                         \
+    yacl::parallel_for(0, in_out1.size(), 1, [&](int64_t beg, int64_t end) { \
+      std::vector<TYPE1 *> in_out1_ptrs;                                     \
+      in_out1_ptrs.reserve(end - beg);                                       \
+      for (int64_t i = beg; i < end; ++i) {                                  \
+        in_out1_ptrs.push_back(&in_out1[i].template As<TYPE1>());            \
+      }                                                                      \
+      sub_clazz.func(absl::MakeSpan(in_out1_ptrs));                          \
+    });                                                                      \
+  }                                                                          \
+                                                                             \
+  /* Call scalar SPI */                                                      \
+  template <typename CLAZZ, typename TYPE1, typename IN1>                    \
+  auto DoCallBatch##func(const CLAZZ &sub_clazz, absl::Span<IN1> in_out1)    \
+      ->std::enable_if_t<                                                    \
+          !std::experimental::is_detected_v<kHasVectorized##func, CLAZZ,     \
+                                            TYPE1>> {                        \
+    yacl::parallel_for(0, in_out1.size(), 1, [&](int64_t beg, int64_t end) { \
+      for (int64_t i = beg; i < end; ++i) {                                  \
+        sub_clazz.func(&in_out1[i].template As<TYPE1>());                    \
+      }                                                                      \
+    });                                                                      \
+  }
+
+#define DO_INVOKE_BATCH_METHOD_VOID_1(ns, clazz, func, type1, in_out1) \
+  [&](const ns::clazz &eval) {                                         \
+    DoCallBatch##func<ns::clazz, ns::type1>(eval, in_out1);            \
+  }
+
+// invoke batch functions with 2 args (with return value) //
+
+#define DEFINE_INVOKE_BATCH_METHOD_RET_2(ret, func)                         \
+  template <typename CLAZZ, typename TYPE1, typename TYPE2>                 \
+  using kHasVectorized##func = decltype(std::declval<const CLAZZ &>().func( \
+      absl::Span<const TYPE1 *const>(), absl::Span<const TYPE2 *const>())); \
+                                                                            \
+  /* Call vectorized SPI */                                                 \
+  template <typename CLAZZ, typename TYPE1, typename TYPE2, typename IN1,   \
+            typename IN2>                                                   \
+  auto DoCallBatch##func(const CLAZZ &sub_clazz, absl::Span<const IN1> in1, \
+                         absl::Span<const IN2> in2, ret *out)               \
+      ->std::enable_if_t<std::experimental::is_detected_v<                  \
+          kHasVectorized##func, CLAZZ, TYPE1, TYPE2>> {                     \
+    yacl::parallel_for(0, in1.size(), 1, [&](int64_t beg, int64_t end) {    \
+      std::vector<const TYPE1 *> in1_ptrs;                                  \
+      std::vector<const TYPE2 *> in2_ptrs;                                  \
+      in1_ptrs.reserve(end - beg);                                          \
+      in2_ptrs.reserve(end - beg);                                          \
+      for (int64_t i = beg; i < end; ++i) {                                 \
+        in1_ptrs.push_back(&in1[i].template As<TYPE1>());                   \
+        in2_ptrs.push_back(&in2[i].template As<TYPE2>());                   \
+      }                                                                     \
+      auto res = sub_clazz.func(absl::MakeConstSpan(in1_ptrs),              \
+                                absl::MakeConstSpan(in2_ptrs));             \
+      for (int64_t i = beg; i < end; ++i) {                                 \
+        out[i] = ret(std::move(res[i - beg]));                              \
+      }                                                                     \
+    });                                                                     \
+  }                                                                         \
+                                                                            \
+  /* Call scalar SPI */                                                     \
+  template <typename CLAZZ, typename TYPE1, typename TYPE2, typename IN1,   \
+            typename IN2>                                                   \
+  auto DoCallBatch##func(const CLAZZ &sub_clazz, absl::Span<const IN1> in1, \
+                         absl::Span<const IN2> in2, ret *out)               \
+      ->std::enable_if_t<!std::experimental::is_detected_v<                 \
+          kHasVectorized##func, CLAZZ, TYPE1, TYPE2>> {                     \
+    yacl::parallel_for(0, in1.size(), 1, [&](int64_t beg, int64_t end) {    \
+      for (int64_t i = beg; i < end; ++i) {                                 \
+        out[i] = ret(sub_clazz.func(in1[i].template As<TYPE1>(),            \
+                                    in2[i].template As<TYPE2>()));          \
+      }                                                                     \
+    });                                                                     \
+  }
+
+#define DO_INVOKE_BATCH_METHOD_RET_2(ns, clazz, func, type1, in1, type2, in2, \
+                                     out)                                     \
+  [&](const ns::clazz &eval) {                                                \
+    DoCallBatch##func<ns::clazz, ns::type1, ns::type2>(eval, in1, in2, out);  \
+  }
+
 }  // namespace heu::lib::phe
@@ -15,6 +15,7 @@
 #include "heu/library/phe/decryptor.h"
 
 #include "heu/library/phe/base/predefined_functions.h"
+#include "heu/library/phe/op_stats.h"
 
 namespace heu::lib::phe {
 
@@ -37,6 +38,7 @@ auto DoCallDecrypt(const CLAZZ &sub_clazz, const TYPE1 &in1, TYPE2 *out2)
 }
 
 void Decryptor::Decrypt(const Ciphertext &ct, Plaintext *out) const {
+  OpStatsScope stats(OpSource::kPhe, OpKind::kDecrypt);
 #define FUNC(ns)                                                    \
   [&](const ns::Decryptor &decryptor) {                             \
     if (!out->IsHoldType<ns::Plaintext>()) {                        \
@@ -51,14 +53,31 @@ void Decryptor::Decrypt(const Ciphertext &ct, Plaintext *out) const {
 
   std::visit(HE_DISPATCH(FUNC), decryptor_ptr_);
 #undef FUNC
+  stats.RecordOperand(*out);
 }
 
 DEFINE_INVOKE_METHOD_RET_1(Plaintext, Decrypt);
 
 Plaintext Decryptor::Decrypt(const Ciphertext &ct) const {
-  return std::visit(
+  OpStatsScope stats(OpSource::kPhe, OpKind::kDecrypt);
+  auto pt = std::visit(
       HE_DISPATCH(DO_INVOKE_METHOD_RET_1, Decryptor, Decrypt, Ciphertext, ct),
       decryptor_ptr_);
+  stats.RecordOperand(pt);
+  return pt;
+}
+
+DEFINE_INVOKE_BATCH_METHOD_RET_1(Plaintext, Decrypt);
+
+std::vector<Plaintext> Decryptor::Decrypt(
+    absl::Span<const Ciphertext> cts) const {
+  OpStatsScope stats(OpSource::kPhe, OpKind::kDecrypt, cts.size());
+  std::vector<Plaintext> out(cts.size());
+  std::visit(HE_DISPATCH(DO_INVOKE_BATCH_METHOD_RET_1, Decryptor, Decrypt,
+                         Ciphertext, cts, out.data()),
+             decryptor_ptr_);
+  stats.RecordOperands(out);
+  return out;
 }
 
 Plaintext Decryptor::DecryptInRange(const Ciphertext &ct,
@@ -14,6 +14,9 @@
 
 #pragma once
 #include <variant>
+#include <vector>
+
+#include "absl/types/span.h"
 
 #include "heu/library/phe/base/plaintext.h"
 #include "heu/library/phe/base/schema.h"
@@ -31,6 +34,9 @@ class Decryptor {
 
   void Decrypt(const Ciphertext &ct, Plaintext *out) const;
   [[nodiscard]] Plaintext Decrypt(const Ciphertext &ct) const;
+  // Batch version, the schema is dispatched only once per batch
+  [[nodiscard]] std::vector<Plaintext> Decrypt(
+      absl::Span<const Ciphertext> cts) const;
 
   // Decrypt ct and make sure pt is in range (-2^range_bits, 2^range_bits)
   // throws an exception if plaintext is out of range.
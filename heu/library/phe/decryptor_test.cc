@@ -34,4 +34,31 @@ TEST_F(DecryptorTest, CheckRangeWorks) {
   EXPECT_ANY_THROW(he_kit_.GetDecryptor()->DecryptInRange(ct, 64));
 }
 
+class BatchDecryptTest : public ::testing::TestWithParam<SchemaType> {
+ protected:
+  HeKit he_kit_ = HeKit(GetParam());
+  PlainEncoder edr_ = he_kit_.GetEncoder<PlainEncoder>(1);
+};
+
+// The schemas whose batch decryption runs through a fixed-exponent engine
+INSTANTIATE_TEST_SUITE_P(Schema, BatchDecryptTest,
+                         ::testing::Values(SchemaType::ZPaillier,
+                                           SchemaType::OU, SchemaType::DJ));
+
+TEST_P(BatchDecryptTest, MatchesScalarDecrypt) {
+  auto bound = he_kit_.GetPublicKey()->PlaintextBound();
+  std::vector<Plaintext> pts = {edr_.Encode(0), edr_.Encode(-1), bound,
+                                -bound};
+  for (int i = 0; i < 30; ++i) {
+    pts.push_back(edr_.Encode(i * 7919 - 100000));
+  }
+
+  auto cts = he_kit_.GetEncryptor()->Encrypt(pts);
+  auto res = he_kit_.GetDecryptor()->Decrypt(cts);
+  EXPECT_EQ(res, pts);
+  for (size_t i = 0; i < cts.size(); ++i) {
+    EXPECT_EQ(he_kit_.GetDecryptor()->Decrypt(cts[i]), res[i]);
+  }
+}
+
 }  // namespace heu::lib::phe::test
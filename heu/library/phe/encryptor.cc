@@ -15,6 +15,7 @@
 #include "heu/library/phe/encryptor.h"
 
 #include "heu/library/phe/base/predefined_functions.h"
+#include "heu/library/phe/op_stats.h"
 
 namespace heu::lib::phe {
 
@@ -23,6 +24,7 @@ namespace heu::lib::phe {
 DEFINE_INVOKE_METHOD_RET_0(Ciphertext, EncryptZero)
 
 Ciphertext Encryptor::EncryptZero() const {
+  OpStatsScope stats(OpSource::kPhe, OpKind::kEncrypt);
   return std::visit([](const auto &clazz) { return DoCallEncryptZero(clazz); },
                     encryptor_ptr_);
 }
@@ -32,11 +34,26 @@ Ciphertext Encryptor::EncryptZero() const {
 DEFINE_INVOKE_METHOD_RET_1(Ciphertext, Encrypt)
 
 Ciphertext Encryptor::Encrypt(const Plaintext &m) const {
+  OpStatsScope stats(OpSource::kPhe, OpKind::kEncrypt);
+  stats.RecordOperand(m);
   return std::visit(
       HE_DISPATCH(DO_INVOKE_METHOD_RET_1, Encryptor, Encrypt, Plaintext, m),
       encryptor_ptr_);
 }
 
+DEFINE_INVOKE_BATCH_METHOD_RET_1(Ciphertext, Encrypt);
+
+std::vector<Ciphertext> Encryptor::Encrypt(
+    absl::Span<const Plaintext> pts) const {
+  OpStatsScope stats(OpSource::kPhe, OpKind::kEncrypt, pts.size());
+  stats.RecordOperands(pts);
+  std::vector<Ciphertext> out(pts.size());
+  std::visit(HE_DISPATCH(DO_INVOKE_BATCH_METHOD_RET_1, Encryptor, Encrypt,
+                         Plaintext, pts, out.data()),
+             encryptor_ptr_);
+  return out;
+}
+
 // EncryptWithAudit //
 
 template <typename CLAZZ, typename PT>
@@ -63,6 +80,8 @@ auto DoCallEncryptWithAudit(const CLAZZ &sub_clazz, const PT &in1)
 
 std::pair<Ciphertext, std::string> Encryptor::EncryptWithAudit(
     const Plaintext &m) const {
+  OpStatsScope stats(OpSource::kPhe, OpKind::kEncrypt);
+  stats.RecordOperand(m);
   return std::visit(HE_DISPATCH(DO_INVOKE_METHOD_RET_1, Encryptor,
                                 EncryptWithAudit, Plaintext, m),
                     encryptor_ptr_);
@@ -16,6 +16,9 @@
 #include <string>
 #include <utility>
 #include <variant>
+#include <vector>
+
+#include "absl/types/span.h"
 
 #include "heu/library/phe/base/plaintext.h"
 #include "heu/library/phe/base/schema.h"
@@ -33,6 +36,8 @@ class Encryptor {
   // Get Enc(0)
   Ciphertext EncryptZero() const;
   Ciphertext Encrypt(const Plaintext &clazz) const;
+  // Batch version, the schema is dispatched only once per batch
+  std::vector<Ciphertext> Encrypt(absl::Span<const Plaintext> pts) const;
   std::pair<Ciphertext, std::string> EncryptWithAudit(
       const Plaintext &clazz) const;
 
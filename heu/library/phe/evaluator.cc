@@ -15,12 +15,14 @@
 #include "heu/library/phe/evaluator.h"
 
 #include "heu/library/phe/base/predefined_functions.h"
+#include "heu/library/phe/op_stats.h"
 
 namespace heu::lib::phe {
 
 DEFINE_INVOKE_METHOD_VOID_1(Randomize);
 
 void Evaluator::Randomize(Ciphertext *ct) const {
+  OpStatsScope stats(OpSource::kPhe, OpKind::kRandomize);
   std::visit(HE_DISPATCH(DO_INVOKE_METHOD_VOID_1, Evaluator, Randomize,
                          Ciphertext, ct),
              evaluator_ptr_);
@@ -30,24 +32,30 @@ DEFINE_INVOKE_METHOD_RET_2(Ciphertext, Add);
 DEFINE_INVOKE_METHOD_VOID_2(AddInplace);
 
 Ciphertext Evaluator::Add(const Ciphertext &a, const Ciphertext &b) const {
+  OpStatsScope stats(OpSource::kPhe, OpKind::kAdd);
   return std::visit(HE_DISPATCH(DO_INVOKE_METHOD_RET_2, Evaluator, Add,
                                 Ciphertext, a, Ciphertext, b),
                     evaluator_ptr_);
 }
 
 void Evaluator::AddInplace(Ciphertext *a, const Ciphertext &b) const {
+  OpStatsScope stats(OpSource::kPhe, OpKind::kAdd);
   std::visit(HE_DISPATCH(DO_INVOKE_METHOD_VOID_2, Evaluator, AddInplace,
                          Ciphertext, a, Ciphertext, b),
              evaluator_ptr_);
 }
 
 Ciphertext Evaluator::Add(const Ciphertext &a, const Plaintext &p) const {
+  OpStatsScope stats(OpSource::kPhe, OpKind::kAdd);
+  stats.RecordOperand(p);
   return std::visit(HE_DISPATCH(DO_INVOKE_METHOD_RET_2, Evaluator, Add,
                                 Ciphertext, a, Plaintext, p),
                     evaluator_ptr_);
 }
 
 void Evaluator::AddInplace(Ciphertext *a, const Plaintext &p) const {
+  OpStatsScope stats(OpSource::kPhe, OpKind::kAdd);
+  stats.RecordOperand(p);
   return std::visit(HE_DISPATCH(DO_INVOKE_METHOD_VOID_2, Evaluator, AddInplace,
                                 Ciphertext, a, Plaintext, p),
                     evaluator_ptr_);
@@ -61,30 +69,38 @@ DEFINE_INVOKE_METHOD_RET_2(Ciphertext, Sub);
 DEFINE_INVOKE_METHOD_VOID_2(SubInplace);
 
 Ciphertext Evaluator::Sub(const Ciphertext &a, const Ciphertext &b) const {
+  OpStatsScope stats(OpSource::kPhe, OpKind::kSub);
   return std::visit(HE_DISPATCH(DO_INVOKE_METHOD_RET_2, Evaluator, Sub,
                                 Ciphertext, a, Ciphertext, b),
                     evaluator_ptr_);
 }
 
 void Evaluator::SubInplace(Ciphertext *a, const Ciphertext &b) const {
+  OpStatsScope stats(OpSource::kPhe, OpKind::kSub);
   return std::visit(HE_DISPATCH(DO_INVOKE_METHOD_VOID_2, Evaluator, SubInplace,
                                 Ciphertext, a, Ciphertext, b),
                     evaluator_ptr_);
 }
 
 Ciphertext Evaluator::Sub(const Ciphertext &a, const Plaintext &p) const {
+  OpStatsScope stats(OpSource::kPhe, OpKind::kSub);
+  stats.RecordOperand(p);
   return std::visit(HE_DISPATCH(DO_INVOKE_METHOD_RET_2, Evaluator, Sub,
                                 Ciphertext, a, Plaintext, p),
                     evaluator_ptr_);
 }
 
 void Evaluator::SubInplace(Ciphertext *a, const Plaintext &p) const {
+  OpStatsScope stats(OpSource::kPhe, OpKind::kSub);
+  stats.RecordOperand(p);
   return std::visit(HE_DISPATCH(DO_INVOKE_METHOD_VOID_2, Evaluator, SubInplace,
                                 Ciphertext, a, Plaintext, p),
                     evaluator_ptr_);
 }
 
 Ciphertext Evaluator::Sub(const Plaintext &p, const Ciphertext &a) const {
+  OpStatsScope stats(OpSource::kPhe, OpKind::kSub);
+  stats.RecordOperand(p);
   return std::visit(HE_DISPATCH(DO_INVOKE_METHOD_RET_2, Evaluator, Sub,
                                 Plaintext, p, Ciphertext, a),
                     evaluator_ptr_);
@@ -94,6 +110,8 @@ DEFINE_INVOKE_METHOD_RET_2(Ciphertext, Mul);
 DEFINE_INVOKE_METHOD_VOID_2(MulInplace);
 
 Ciphertext Evaluator::Mul(const Ciphertext &a, const Plaintext &p) const {
+  OpStatsScope stats(OpSource::kPhe, OpKind::kMul);
+  stats.RecordOperand(p);
   return std::visit(HE_DISPATCH(DO_INVOKE_METHOD_RET_2, Evaluator, Mul,
                                 Ciphertext, a, Plaintext, p),
                     evaluator_ptr_);
@@ -104,6 +122,8 @@ Ciphertext Evaluator::Mul(const Plaintext &p, const Ciphertext &a) const {
 }
 
 void Evaluator::MulInplace(Ciphertext *a, const Plaintext &p) const {
+  OpStatsScope stats(OpSource::kPhe, OpKind::kMul);
+  stats.RecordOperand(p);
   std::visit(HE_DISPATCH(DO_INVOKE_METHOD_VOID_2, Evaluator, MulInplace,
                          Ciphertext, a, Plaintext, p),
              evaluator_ptr_);
@@ -113,17 +133,79 @@ DEFINE_INVOKE_METHOD_RET_1(Ciphertext, Negate);
 DEFINE_INVOKE_METHOD_VOID_1(NegateInplace);
 
 Ciphertext Evaluator::Negate(const Ciphertext &a) const {
+  OpStatsScope stats(OpSource::kPhe, OpKind::kNegate);
   return std::visit(
       HE_DISPATCH(DO_INVOKE_METHOD_RET_1, Evaluator, Negate, Ciphertext, a),
       evaluator_ptr_);
 }
 
 void Evaluator::NegateInplace(Ciphertext *a) const {
+  OpStatsScope stats(OpSource::kPhe, OpKind::kNegate);
   std::visit(HE_DISPATCH(DO_INVOKE_METHOD_VOID_1, Evaluator, NegateInplace,
                          Ciphertext, a),
              evaluator_ptr_);
 }
 
+// Batch operations //
+
+DEFINE_INVOKE_BATCH_METHOD_VOID_1(Randomize);
+
+void Evaluator::Randomize(absl::Span<Ciphertext> cts) const {
+  OpStatsScope stats(OpSource::kPhe, OpKind::kRandomize, cts.size());
+  std::visit(HE_DISPATCH(DO_INVOKE_BATCH_METHOD_VOID_1, Evaluator, Randomize,
+                         Ciphertext, cts),
+             evaluator_ptr_);
+}
+
+namespace {
+
+// Only plaintext operands have a bit length to record
+void RecordOperands(OpStatsScope *stats, absl::Span<const Plaintext> pts) {
+  stats->RecordOperands(pts);
+}
+
+void RecordOperands(OpStatsScope *, absl::Span<const Ciphertext>) {}
+
+}  // namespace
+
+#define IMPLEMENT_BATCH_BINARY_OP(OP, TX, TY)                                  \
+  std::vector<Ciphertext> Evaluator::OP(absl::Span<const TX> x,                \
+                                        absl::Span<const TY> y) const {        \
+    YACL_ENFORCE(x.size() == y.size(),                                         \
+                 "batch size mismatch, x.size()={}, y.size()={}", x.size(),    \
+                 y.size());                                                    \
+    OpStatsScope stats(OpSource::kPhe, OpKind::k##OP, x.size());               \
+    RecordOperands(&stats, y);                                                 \
+    std::vector<Ciphertext> out(x.size());                                     \
+    std::visit(HE_DISPATCH(DO_INVOKE_BATCH_METHOD_RET_2, Evaluator, OP, TX, x, \
+                           TY, y, out.data()),                                 \
+               evaluator_ptr_);                                                \
+    return out;                                                                \
+  }
+
+DEFINE_INVOKE_BATCH_METHOD_RET_2(Ciphertext, Add);
+IMPLEMENT_BATCH_BINARY_OP(Add, Ciphertext, Ciphertext);
+IMPLEMENT_BATCH_BINARY_OP(Add, Ciphertext, Plaintext);
+
+DEFINE_INVOKE_BATCH_METHOD_RET_2(Ciphertext, Sub);
+IMPLEMENT_BATCH_BINARY_OP(Sub, Ciphertext, Ciphertext);
+IMPLEMENT_BATCH_BINARY_OP(Sub, Ciphertext, Plaintext);
+
+DEFINE_INVOKE_BATCH_METHOD_RET_2(Ciphertext, Mul);
+IMPLEMENT_BATCH_BINARY_OP(Mul, Ciphertext, Plaintext);
+
+DEFINE_INVOKE_BATCH_METHOD_RET_1(Ciphertext, Negate);
+
+std::vector<Ciphertext> Evaluator::Negate(
+    absl::Span<const Ciphertext> a) const {
+  OpStatsScope stats(OpSource::kPhe, OpKind::kNegate, a.size());
+  std::vector<Ciphertext> out(a.size());
+  std::visit(HE_DISPATCH(DO_INVOKE_BATCH_METHOD_RET_1, Evaluator, Negate,
+                         Ciphertext, a, out.data()),
+             evaluator_ptr_);
+  return out;
+}
+
 SchemaType Evaluator::GetSchemaType() const { return schema_type_; }
 
 }  // namespace heu::lib::phe
@@ -16,6 +16,9 @@
 
 #include <utility>
 #include <variant>
+#include <vector>
+
+#include "absl/types/span.h"
 
 #include "heu/library/phe/base/plaintext.h"
 #include "heu/library/phe/base/schema.h"
@@ -87,6 +90,28 @@ class Evaluator {
 
   void NegateInplace(Plaintext *a) const { a->NegateInplace(); };
 
+  // Batch operations: out[i] = op(a[i], b[i])
+  // The schema is dispatched only once per batch, then the batch is computed
+  // in parallel by the vectorized SPI of the underlying algorithm if exists,
+  // or by the scalar SPI otherwise. All the warnings of scalar operations
+  // above also apply to batch operations.
+  void Randomize(absl::Span<Ciphertext> cts) const;
+
+  std::vector<Ciphertext> Add(absl::Span<const Ciphertext> a,
+                              absl::Span<const Ciphertext> b) const;
+  std::vector<Ciphertext> Add(absl::Span<const Ciphertext> a,
+                              absl::Span<const Plaintext> p) const;
+
+  std::vector<Ciphertext> Sub(absl::Span<const Ciphertext> a,
+                              absl::Span<const Ciphertext> b) const;
+  std::vector<Ciphertext> Sub(absl::Span<const Ciphertext> a,
+                              absl::Span<const Plaintext> p) const;
+
+  std::vector<Ciphertext> Mul(absl::Span<const Ciphertext> a,
+                              absl::Span<const Plaintext> p) const;
+
+  std::vector<Ciphertext> Negate(absl::Span<const Ciphertext> a) const;
+
   SchemaType GetSchemaType() const;
 
  protected:
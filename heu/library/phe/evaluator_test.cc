@@ -139,4 +139,38 @@ TEST_P(EvaluatorTest, EvaluateInplace) {
   EXPECT_EQ(decryptor->Decrypt(ct0), pt0);
 }
 
+TEST_P(EvaluatorTest, EvaluateBatch) {
+  auto encryptor = he_kit_.GetEncryptor();
+  auto evaluator = he_kit_.GetEvaluator();
+  auto decryptor = he_kit_.GetDecryptor();
+
+  std::vector<Plaintext> pts0, pts1;
+  for (int i = 0; i < 50; ++i) {
+    pts0.push_back(edr.Encode(i * 13 - 300));
+    pts1.push_back(edr.Encode(i % 7 - 3));
+  }
+  auto cts0 = encryptor->Encrypt(pts0);
+  auto cts1 = encryptor->Encrypt(pts1);
+  ASSERT_EQ(cts0.size(), pts0.size());
+  evaluator->Randomize(absl::MakeSpan(cts0));
+  EXPECT_EQ(decryptor->Decrypt(cts0), pts0);
+
+  std::vector<Plaintext> sum, diff, prod, neg;
+  for (size_t i = 0; i < pts0.size(); ++i) {
+    sum.push_back(pts0[i] + pts1[i]);
+    diff.push_back(pts0[i] - pts1[i]);
+    prod.push_back(pts0[i] * pts1[i]);
+    neg.push_back(-pts0[i]);
+  }
+  EXPECT_EQ(decryptor->Decrypt(evaluator->Add(cts0, cts1)), sum);
+  EXPECT_EQ(decryptor->Decrypt(evaluator->Add(cts0, pts1)), sum);
+  EXPECT_EQ(decryptor->Decrypt(evaluator->Sub(cts0, cts1)), diff);
+  EXPECT_EQ(decryptor->Decrypt(evaluator->Sub(cts0, pts1)), diff);
+  EXPECT_EQ(decryptor->Decrypt(evaluator->Mul(cts0, pts1)), prod);
+  EXPECT_EQ(decryptor->Decrypt(evaluator->Negate(cts0)), neg);
+
+  EXPECT_THROW(evaluator->Add(cts0, absl::MakeConstSpan(cts1).subspan(1)),
+               std::exception);
+}
+
 }  // namespace heu::lib::phe::test
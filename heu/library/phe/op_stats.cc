@@ -0,0 +1,297 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "heu/library/phe/op_stats.h"
+
+#include <algorithm>
+#include <mutex>
+
+#include "absl/numeric/bits.h"
+#include "fmt/format.h"
+#include "yacl/base/exception.h"
+
+namespace heu::lib::phe {
+
+namespace {
+
+constexpr size_t kNumSources = static_cast<size_t>(OpSource::kNumSources);
+constexpr size_t kNumKinds = static_cast<size_t>(OpKind::kNumKinds);
+
+using Counter = std::atomic<uint64_t>;
+
+size_t Log2Bucket(uint64_t v, size_t num_buckets) {
+  return std::min<size_t>(absl::bit_width(v), num_buckets - 1);
+}
+
+// The owner thread is the only one that increments a counter, but Reset()
+// zeroes it from other threads, so the increment must stay a single atomic
+// read-modify-write: a separate load and store would write the pre-reset
+// count back. The cache line is not shared, so the locked add is cheap.
+void Inc(Counter *c, uint64_t v = 1) {
+  c->fetch_add(v, std::memory_order_relaxed);
+}
+
+uint64_t Load(const Counter &c) { return c.load(std::memory_order_relaxed); }
+
+template <size_t N>
+void AddHist(const std::array<Counter, N> &from,
+             std::array<uint64_t, N> *to) {
+  for (size_t i = 0; i < N; ++i) {
+    (*to)[i] += Load(from[i]);
+  }
+}
+
+template <size_t N>
+void ResetHist(std::array<Counter, N> *hist) {
+  for (auto &c : *hist) {
+    c.store(0, std::memory_order_relaxed);
+  }
+}
+
+std::atomic<uint32_t> g_sample_interval{OpStats::kDefaultSampleInterval};
+
+}  // namespace
+
+namespace internal {
+
+struct OpStatsCell {
+  Counter calls{0};
+  Counter elements{0};
+  std::array<Counter, kBitLenBuckets> bit_len_hist{};
+  std::array<Counter, kBatchBuckets> batch_hist{};
+  std::array<Counter, kLatencyBuckets> latency_hist{};
+  Counter sampled_calls{0};
+  Counter sampled_ns{0};
+
+  void AddTo(OpStatsEntry *e) const {
+    e->calls += Load(calls);
+    e->elements += Load(elements);
+    AddHist(bit_len_hist, &e->bit_len_hist);
+    AddHist(batch_hist, &e->batch_hist);
+    AddHist(latency_hist, &e->latency_hist);
+    e->sampled_calls += Load(sampled_calls);
+    e->sampled_ns += Load(sampled_ns);
+  }
+
+  void Reset() {
+    calls.store(0, std::memory_order_relaxed);
+    elements.store(0, std::memory_order_relaxed);
+    ResetHist(&bit_len_hist);
+    ResetHist(&batch_hist);
+    ResetHist(&latency_hist);
+    sampled_calls.store(0, std::memory_order_relaxed);
+    sampled_ns.store(0, std::memory_order_relaxed);
+  }
+};
+
+}  // namespace internal
+
+namespace {
+
+using Entries = std::array<std::array<OpStatsEntry, kNumKinds>, kNumSources>;
+
+struct ThreadStats {
+  std::array<std::array<internal::OpStatsCell, kNumKinds>, kNumSources> cells;
+  // calls left until the next sampled one, only used by the owner thread
+  uint32_t countdown = 0;
+};
+
+struct Registry {
+  std::mutex mu;
+  std::vector<ThreadStats *> live;
+  Entries retired{};  // counters of exited threads
+};
+
+// Leaked on purpose, threads may exit after static destruction
+Registry &GetRegistry() {
+  static auto *registry = new Registry();
+  return *registry;
+}
+
+void MergeInto(const ThreadStats &stats, Entries *entries) {
+  for (size_t s = 0; s < kNumSources; ++s) {
+    for (size_t k = 0; k < kNumKinds; ++k) {
+      stats.cells[s][k].AddTo(&(*entries)[s][k]);
+    }
+  }
+}
+
+class ThreadStatsHolder {
+ public:
+  ThreadStatsHolder() {
+    auto &registry = GetRegistry();
+    std::lock_guard<std::mutex> guard(registry.mu);
+    registry.live.push_back(&stats_);
+  }
+
+  ~ThreadStatsHolder() {
+    auto &registry = GetRegistry();
+    std::lock_guard<std::mutex> guard(registry.mu);
+    MergeInto(stats_, &registry.retired);
+    registry.live.erase(
+        std::find(registry.live.begin(), registry.live.end(), &stats_));
+  }
+
+  ThreadStats &stats() { return stats_; }
+
+ private:
+  ThreadStats stats_;
+};
+
+ThreadStats &LocalStats() {
+  thread_local ThreadStatsHolder holder;
+  return holder.stats();
+}
+
+}  // namespace
+
+void OpStats::Enable(uint32_t sample_interval) {
+  YACL_ENFORCE(sample_interval > 0, "sample interval must be positive");
+  g_sample_interval.store(sample_interval, std::memory_order_relaxed);
+  enabled_.store(true, std::memory_order_relaxed);
+}
+
+void OpStats::Disable() { enabled_.store(false, std::memory_order_relaxed); }
+
+OpStatsSnapshot OpStats::Snapshot() {
+  auto &registry = GetRegistry();
+  Entries sum{};
+  {
+    std::lock_guard<std::mutex> guard(registry.mu);
+    sum = registry.retired;
+    for (const auto *stats : registry.live) {
+      MergeInto(*stats, &sum);
+    }
+  }
+
+  OpStatsSnapshot res;
+  for (size_t s = 0; s < kNumSources; ++s) {
+    for (size_t k = 0; k < kNumKinds; ++k) {
+      auto &e = sum[s][k];
+      if (e.calls == 0) {
+        continue;
+      }
+      e.source = static_cast<OpSource>(s);
+      e.kind = static_cast<OpKind>(k);
+      e.name = fmt::format("{}.{}", SourceName(e.source), KindName(e.kind));
+      res.entries.push_back(std::move(e));
+    }
+  }
+  return res;
+}
+
+void OpStats::Reset() {
+  auto &registry = GetRegistry();
+  std::lock_guard<std::mutex> guard(registry.mu);
+  registry.retired = Entries{};
+  for (auto *stats : registry.live) {
+    for (auto &cells : stats->cells) {
+      for (auto &cell : cells) {
+        cell.Reset();
+      }
+    }
+  }
+}
+
+std::string OpStats::SourceName(OpSource source) {
+  switch (source) {
+    case OpSource::kPhe:
+      return "phe";
+    case OpSource::kNumpy:
+      return "numpy";
+    default:
+      YACL_THROW("unknown op source {}", static_cast<int>(source));
+  }
+}
+
+std::string OpStats::KindName(OpKind kind) {
+  switch (kind) {
+    case OpKind::kEncrypt:
+      return "Encrypt";
+    case OpKind::kDecrypt:
+      return "Decrypt";
+    case OpKind::kAdd:
+      return "Add";
+    case OpKind::kSub:
+      return "Sub";
+    case OpKind::kMul:
+      return "Mul";
+    case OpKind::kNegate:
+      return "Negate";
+    case OpKind::kRandomize:
+      return "Randomize";
+    case OpKind::kMatMul:
+      return "MatMul";
+    case OpKind::kSum:
+      return "Sum";
+    case OpKind::kBucketSum:
+      return "BucketSum";
+    default:
+      YACL_THROW("unknown op kind {}", static_cast<int>(kind));
+  }
+}
+
+const OpStatsEntry *OpStatsSnapshot::Find(OpSource source,
+                                          OpKind kind) const {
+  for (const auto &e : entries) {
+    if (e.source == source && e.kind == kind) {
+      return &e;
+    }
+  }
+  return nullptr;
+}
+
+std::string OpStatsSnapshot::ToString() const {
+  std::string res = fmt::format("{:<16} {:>12} {:>14} {:>16}\n", "op", "calls",
+                                "elements", "avg_us(sampled)");
+  for (const auto &e : entries) {
+    double avg_us = e.sampled_calls == 0
+                        ? 0
+                        : e.sampled_ns / 1000.0 / e.sampled_calls;
+    res += fmt::format("{:<16} {:>12} {:>14} {:>16.3f}\n", e.name, e.calls,
+                       e.elements, avg_us);
+  }
+  return res;
+}
+
+void OpStatsScope::Begin(OpSource source, OpKind kind, size_t num_elements) {
+  auto &stats = LocalStats();
+  cell_ = &stats.cells[static_cast<size_t>(source)][static_cast<size_t>(kind)];
+  Inc(&cell_->calls);
+  Inc(&cell_->elements, num_elements);
+  Inc(&cell_->batch_hist[Log2Bucket(num_elements, kBatchBuckets)]);
+
+  if (stats.countdown == 0) {
+    stats.countdown = g_sample_interval.load(std::memory_order_relaxed) - 1;
+    sampled_ = true;
+    start_ = std::chrono::steady_clock::now();
+  } else {
+    --stats.countdown;
+  }
+}
+
+void OpStatsScope::End() {
+  auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - start_)
+                .count();
+  Inc(&cell_->latency_hist[Log2Bucket(ns, kLatencyBuckets)]);
+  Inc(&cell_->sampled_calls);
+  Inc(&cell_->sampled_ns, ns);
+}
+
+void OpStatsScope::RecordBitLen(size_t bits) {
+  Inc(&cell_->bit_len_hist[Log2Bucket(bits, kBitLenBuckets)]);
+}
+
+}  // namespace heu::lib::phe
@@ -0,0 +1,179 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/types/span.h"
+
+#include "heu/library/phe/base/plaintext.h"
+
+namespace heu::lib::phe {
+
+namespace internal {
+struct OpStatsCell;
+}  // namespace internal
+
+// Optional per-operation counters of the phe facade (Encryptor, Decryptor,
+// Evaluator) and of numpy::Evaluator.
+//
+// Stats are off by default. When off, an instrumented call costs one relaxed
+// atomic load. When on, each thread updates its own counters, which are
+// merged by Snapshot(). The latency of one call out of every
+// 'sample_interval' calls of a thread is measured.
+//
+// Usage:
+//   OpStats::Enable();
+//   ... run HE ops ...
+//   fmt::print("{}", OpStats::Snapshot().ToString());
+
+// Which layer an op was called on
+enum class OpSource : uint8_t {
+  kPhe,    // phe::Encryptor/Decryptor/Evaluator
+  // numpy::Evaluator, one call processes a whole matrix. Some numpy ops (e.g.
+  // Sum) run on top of the phe facade and also show up in the phe counters.
+  kNumpy,
+  kNumSources,
+};
+
+enum class OpKind : uint8_t {
+  kEncrypt,
+  kDecrypt,
+  kAdd,
+  kSub,
+  kMul,
+  kNegate,
+  kRandomize,
+  kMatMul,
+  kSum,
+  kBucketSum,
+  kNumKinds,
+};
+
+// Histogram bucket i counts values v with bit_width(v) == i, i.e. bucket 0
+// holds v == 0 and bucket i > 0 holds v in [2^(i-1), 2^i). The last bucket
+// also holds all larger values.
+constexpr size_t kBitLenBuckets = 16;
+constexpr size_t kBatchBuckets = 32;
+constexpr size_t kLatencyBuckets = 40;  // in nanoseconds
+
+struct OpStatsEntry {
+  OpSource source;
+  OpKind kind;
+  // "phe.Encrypt", "numpy.MatMul", ...
+  std::string name;
+
+  // Number of API calls; a batch call counts once
+  uint64_t calls = 0;
+  // Number of elements processed, a batch call of n elements counts n.
+  // For numpy MatMul this is the number of element multiplications.
+  uint64_t elements = 0;
+  // Elements by bit length of the plaintext operand (or result of Decrypt).
+  // Ops without a plaintext operand and numpy ops are not counted here.
+  std::array<uint64_t, kBitLenBuckets> bit_len_hist{};
+  // Calls by number of elements
+  std::array<uint64_t, kBatchBuckets> batch_hist{};
+  // Sampled calls by latency in nanoseconds
+  std::array<uint64_t, kLatencyBuckets> latency_hist{};
+  uint64_t sampled_calls = 0;
+  uint64_t sampled_ns = 0;  // total latency of the sampled calls
+};
+
+struct OpStatsSnapshot {
+  // Only ops with at least one call are present
+  std::vector<OpStatsEntry> entries;
+
+  // Returns nullptr if the op has never been called
+  const OpStatsEntry *Find(OpSource source, OpKind kind) const;
+  std::string ToString() const;
+};
+
+class OpStats {
+ public:
+  static void Enable(uint32_t sample_interval = kDefaultSampleInterval);
+  static void Disable();
+  static bool IsEnabled() {
+    return enabled_.load(std::memory_order_relaxed);
+  }
+
+  // Sum of the counters of all threads, including threads that have exited
+  static OpStatsSnapshot Snapshot();
+  // Zero all counters. Calls that are in flight may still be recorded.
+  static void Reset();
+
+  static std::string SourceName(OpSource source);
+  static std::string KindName(OpKind kind);
+
+  static constexpr uint32_t kDefaultSampleInterval = 64;
+
+ private:
+  friend class OpStatsScope;
+
+  static inline std::atomic<bool> enabled_{false};
+};
+
+// Records one call of an op, the latency is taken between construction and
+// destruction if this call is sampled.
+//
+//   OpStatsScope stats(OpSource::kPhe, OpKind::kEncrypt, pts.size());
+//   stats.RecordOperands(pts);
+class OpStatsScope {
+ public:
+  explicit OpStatsScope(OpSource source, OpKind kind, size_t num_elements = 1) {
+    if (OpStats::IsEnabled()) {
+      Begin(source, kind, num_elements);
+    }
+  }
+
+  ~OpStatsScope() {
+    if (cell_ != nullptr && sampled_) {
+      End();
+    }
+  }
+
+  OpStatsScope(const OpStatsScope &) = delete;
+  OpStatsScope &operator=(const OpStatsScope &) = delete;
+
+  // The bit length is computed only if stats are on
+  void RecordOperand(const Plaintext &pt) {
+    if (cell_ != nullptr) {
+      RecordBitLen(pt.BitCount());
+    }
+  }
+
+  void RecordOperands(absl::Span<const Plaintext> pts) {
+    if (cell_ != nullptr) {
+      for (const auto &pt : pts) {
+        RecordBitLen(pt.BitCount());
+      }
+    }
+  }
+
+ private:
+  void Begin(OpSource source, OpKind kind, size_t num_elements);
+  void End();
+  void RecordBitLen(size_t bits);
+
+  internal::OpStatsCell *cell_ = nullptr;
+  bool sampled_ = false;
+  std::chrono::steady_clock::time_point start_;
+};
+
+}  // namespace heu::lib::phe
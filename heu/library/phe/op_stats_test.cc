@@ -0,0 +1,112 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "heu/library/phe/op_stats.h"
+
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "heu/library/phe/encoding/encoding.h"
+#include "heu/library/phe/phe.h"
+
+namespace heu::lib::phe::test {
+
+class OpStatsTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    OpStats::Reset();
+    OpStats::Enable(1);
+  }
+
+  void TearDown() override {
+    OpStats::Disable();
+    OpStats::Reset();
+  }
+
+  HeKit he_kit_ = HeKit(SchemaType::Mock, 2048);
+  PlainEncoder edr_ = he_kit_.GetEncoder<PlainEncoder>(1);
+};
+
+TEST_F(OpStatsTest, CountOps) {
+  auto encryptor = he_kit_.GetEncryptor();
+  auto evaluator = he_kit_.GetEvaluator();
+  auto decryptor = he_kit_.GetDecryptor();
+
+  auto ct = encryptor->Encrypt(edr_.Encode(255));
+  std::vector<Plaintext> pts = {edr_.Encode(1), edr_.Encode(2),
+                                edr_.Encode(3)};
+  auto cts = encryptor->Encrypt(pts);
+  evaluator->AddInplace(&ct, ct);
+  auto sums = evaluator->Add(cts, absl::MakeConstSpan(cts));
+  decryptor->Decrypt(sums);
+
+  auto snapshot = OpStats::Snapshot();
+  const auto *enc = snapshot.Find(OpSource::kPhe, OpKind::kEncrypt);
+  ASSERT_NE(enc, nullptr);
+  EXPECT_EQ(enc->calls, 2);
+  EXPECT_EQ(enc->elements, 4);
+  EXPECT_EQ(enc->batch_hist[1], 1);  // batch of 1
+  EXPECT_EQ(enc->batch_hist[2], 1);  // batch of 3
+  // 255 has 8 bits, in bucket [8, 16)
+  EXPECT_EQ(enc->bit_len_hist[4], 1);
+  // 1, 2, 3 have 1, 2, 2 bits
+  EXPECT_EQ(enc->bit_len_hist[1], 1);
+  EXPECT_EQ(enc->bit_len_hist[2], 2);
+  EXPECT_EQ(enc->sampled_calls, 2);
+
+  const auto *add = snapshot.Find(OpSource::kPhe, OpKind::kAdd);
+  ASSERT_NE(add, nullptr);
+  EXPECT_EQ(add->calls, 2);
+  EXPECT_EQ(add->elements, 4);
+
+  const auto *dec = snapshot.Find(OpSource::kPhe, OpKind::kDecrypt);
+  ASSERT_NE(dec, nullptr);
+  EXPECT_EQ(dec->elements, 3);
+  EXPECT_EQ(snapshot.Find(OpSource::kPhe, OpKind::kMul), nullptr);
+
+  OpStats::Reset();
+  EXPECT_TRUE(OpStats::Snapshot().entries.empty());
+}
+
+TEST_F(OpStatsTest, DisabledAndMultiThreads) {
+  auto encryptor = he_kit_.GetEncryptor();
+  OpStats::Disable();
+  encryptor->EncryptZero();
+  EXPECT_TRUE(OpStats::Snapshot().entries.empty());
+
+  OpStats::Enable(4);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&] {
+      for (int i = 0; i < 100; ++i) {
+        encryptor->EncryptZero();
+      }
+    });
+  }
+  for (auto &t : threads) {
+    t.join();
+  }
+
+  // counters of exited threads are kept
+  auto snapshot = OpStats::Snapshot();
+  const auto *enc = snapshot.Find(OpSource::kPhe, OpKind::kEncrypt);
+  ASSERT_NE(enc, nullptr);
+  EXPECT_EQ(enc->calls, 400);
+  EXPECT_EQ(enc->sampled_calls, 100);
+  EXPECT_NE(snapshot.ToString().find("phe.Encrypt"), std::string::npos);
+}
+
+}  // namespace heu::lib::phe::test
@@ -20,6 +20,7 @@
 #include "heu/library/phe/decryptor.h"
 #include "heu/library/phe/encryptor.h"
 #include "heu/library/phe/evaluator.h"
+#include "heu/library/phe/op_stats.h"
 
 namespace heu::lib::phe {
 
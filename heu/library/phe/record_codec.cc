@@ -0,0 +1,54 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "heu/library/phe/record_codec.h"
+
+#include <cstring>
+
+#include "yacl/base/exception.h"
+
+namespace heu::lib::phe {
+
+size_t SuggestCipherRecordBytes(size_t cipher_bytes) {
+  auto bytes = kCipherRecordLengthBytes + cipher_bytes + cipher_bytes / 8;
+  return (bytes + 63) / 64 * 64;
+}
+
+void DecodeCipherRecord(const uint8_t *record, size_t record_bytes,
+                        Ciphertext *out) {
+  YACL_ENFORCE(record_bytes > kCipherRecordLengthBytes,
+               "record_bytes {} is too small", record_bytes);
+  uint32_t len = LoadLittleEndian<uint32_t>(record);
+  YACL_ENFORCE(len > 0 && len <= record_bytes - kCipherRecordLengthBytes,
+               "cipher record is not written or corrupted");
+  out->Deserialize(yacl::ByteContainerView(record + kCipherRecordLengthBytes,
+                                           static_cast<size_t>(len)));
+}
+
+void EncodeCipherRecord(const Ciphertext &in, uint8_t *record,
+                        size_t record_bytes) {
+  YACL_ENFORCE(record_bytes > kCipherRecordLengthBytes,
+               "record_bytes {} is too small", record_bytes);
+  auto buf = in.Serialize();
+  auto payload_bytes = record_bytes - kCipherRecordLengthBytes;
+  YACL_ENFORCE(static_cast<size_t>(buf.size()) <= payload_bytes,
+               "ciphertext of {} bytes does not fit in a record of {} bytes",
+               buf.size(), record_bytes);
+  StoreLittleEndian(static_cast<uint32_t>(buf.size()), record);
+  std::memcpy(record + kCipherRecordLengthBytes, buf.data(), buf.size());
+  std::memset(record + kCipherRecordLengthBytes + buf.size(), 0,
+              payload_bytes - buf.size());
+}
+
+}  // namespace heu::lib::phe
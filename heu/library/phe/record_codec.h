@@ -0,0 +1,67 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "heu/library/phe/base/serializable_types.h"
+
+namespace heu::lib::phe {
+
+// A cipher record is a fixed-width slot of record_bytes bytes holding a
+// little-endian uint32 length followed by the serialized ciphertext, padded
+// with zeros. Arrays of records are the storage format of
+// numpy::MappedCMatrix and the buffers of the columnar C API.
+
+// Bytes of the length prefix of a record
+inline constexpr size_t kCipherRecordLengthBytes = sizeof(uint32_t);
+
+// A record width that fits ciphertexts of 'cipher_bytes' serialized bytes with
+// 1/8 headroom, so that results of the same key fit too, rounded up to a
+// cache line
+size_t SuggestCipherRecordBytes(size_t cipher_bytes);
+
+// Fixed-width little-endian integers, used for the length prefix of records
+// and the header of numpy::MappedCMatrix files
+template <typename T>
+void StoreLittleEndian(T value, uint8_t *out) {
+  static_assert(std::is_integral_v<T>);
+  auto v = static_cast<std::make_unsigned_t<T>>(value);
+  for (size_t i = 0; i < sizeof(T); ++i) {
+    out[i] = static_cast<uint8_t>(v >> (8 * i));
+  }
+}
+
+template <typename T>
+T LoadLittleEndian(const uint8_t *in) {
+  static_assert(std::is_integral_v<T>);
+  std::make_unsigned_t<T> v = 0;
+  for (size_t i = 0; i < sizeof(T); ++i) {
+    v |= static_cast<std::make_unsigned_t<T>>(in[i]) << (8 * i);
+  }
+  return static_cast<T>(v);
+}
+
+// Deserialize the record at 'record' into 'out', throws if the record is not
+// written or corrupted
+void DecodeCipherRecord(const uint8_t *record, size_t record_bytes,
+                        Ciphertext *out);
+// Serialize 'in' into the record at 'record', throws if it does not fit
+void EncodeCipherRecord(const Ciphertext &in, uint8_t *record,
+                        size_t record_bytes);
+
+}  // namespace heu::lib::phe
@@ -0,0 +1,83 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "heu/library/phe/record_codec.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "heu/library/phe/phe.h"
+
+namespace heu::lib::phe::test {
+
+class RecordCodecTest : public ::testing::Test {
+ protected:
+  HeKit he_kit_ = HeKit(SchemaType::ZPaillier, 2048);
+};
+
+TEST_F(RecordCodecTest, RoundTripWorks) {
+  Plaintext pt(he_kit_.GetSchemaType(), -123);
+  auto ct = he_kit_.GetEncryptor()->Encrypt(pt);
+  auto cipher_bytes = ct.Serialize().size();
+  auto record_bytes = SuggestCipherRecordBytes(cipher_bytes);
+  EXPECT_EQ(record_bytes % 64, 0);
+  EXPECT_GE(record_bytes, kCipherRecordLengthBytes + cipher_bytes);
+
+  std::vector<uint8_t> records(2 * record_bytes, 0xff);
+  EncodeCipherRecord(ct, records.data() + record_bytes, record_bytes);
+  // the padding is zeroed and the neighbour is untouched
+  EXPECT_EQ(records.back(), 0);
+  EXPECT_EQ(records[record_bytes - 1], 0xff);
+
+  Ciphertext res;
+  DecodeCipherRecord(records.data() + record_bytes, record_bytes, &res);
+  EXPECT_EQ(he_kit_.GetDecryptor()->Decrypt(res).GetValue<int64_t>(), -123);
+}
+
+TEST_F(RecordCodecTest, BadRecordThrows) {
+  auto ct = he_kit_.GetEncryptor()->EncryptZero();
+  auto cipher_bytes = ct.Serialize().size();
+
+  std::vector<uint8_t> records(cipher_bytes + kCipherRecordLengthBytes);
+  EXPECT_THROW(EncodeCipherRecord(ct, records.data(), records.size() - 1),
+               yacl::EnforceNotMet);
+  EXPECT_THROW(EncodeCipherRecord(ct, records.data(), 0), yacl::EnforceNotMet);
+  EncodeCipherRecord(ct, records.data(), records.size());
+
+  Ciphertext res;
+  // a record narrower than its length prefix says
+  EXPECT_THROW(DecodeCipherRecord(records.data(), records.size() - 1, &res),
+               yacl::EnforceNotMet);
+  // a record that is not written
+  std::fill(records.begin(), records.end(), 0);
+  EXPECT_THROW(DecodeCipherRecord(records.data(), records.size(), &res),
+               yacl::EnforceNotMet);
+}
+
+TEST(LittleEndianTest, Works) {
+  uint8_t buf[8];
+  StoreLittleEndian(uint32_t{0x01020304}, buf);
+  EXPECT_EQ(std::vector<uint8_t>(buf, buf + 4),
+            std::vector<uint8_t>({4, 3, 2, 1}));
+  EXPECT_EQ(LoadLittleEndian<uint32_t>(buf), 0x01020304u);
+
+  StoreLittleEndian(int64_t{-2}, buf);
+  EXPECT_EQ(buf[0], 0xfe);
+  EXPECT_EQ(buf[7], 0xff);
+  EXPECT_EQ(LoadLittleEndian<int64_t>(buf), -2);
+}
+
+}  // namespace heu::lib::phe::test
@@ -24,6 +24,11 @@
 
 namespace heu::pylib {
 
+// Release the GIL while a bound function runs, so that other python threads
+// are not blocked by long HE computations. Only for functions that never touch
+// python objects after their arguments are converted.
+using ReleaseGil = pybind11::call_guard<pybind11::gil_scoped_release>;
+
 class PyUtils {
  public:
   // py::int_ -> int128_t
@@ -50,17 +55,22 @@ class PyUtils {
   static decltype(auto) PickleSupport() {
     return pybind11::pickle(
         [](const T &obj) {  // __getstate__
-          auto buffer = obj.Serialize();
+          auto buffer = [&] {
+            pybind11::gil_scoped_release release;
+            return obj.Serialize();
+          }();
           return pybind11::bytes(buffer.template data<char>(), buffer.size());
         },
         [](const pybind11::bytes &buffer) {  // __setstate__
+          auto view = static_cast<std::string_view>(buffer);
+          pybind11::gil_scoped_release release;
           if constexpr (std::experimental::is_detected_v<kHasLoadFromMethod,
                                                          T>) {
             // T has a static LoadFrom() function
-            return T::LoadFrom(static_cast<std::string_view>(buffer));
+            return T::LoadFrom(view);
           } else {
             T obj;
-            obj.Deserialize(static_cast<std::string_view>(buffer));
+            obj.Deserialize(view);
             return obj;
           }
         });
@@ -40,10 +40,57 @@ template <typename T>
 void BindMatrixCommon(py::class_<hnp::DenseMatrix<T>> &clazz) {
   clazz.def("__str__", &hnp::DenseMatrix<T>::ToString)
       .def(PyUtils::PickleSupport<hnp::DenseMatrix<T>>())
+      .def(
+          "__reduce_ex__",
+          [](const py::object &self, int protocol) -> py::object {
+            if (protocol < 5) {
+              // fall back to __getstate__/__setstate__
+              return py::module::import("builtins")
+                  .attr("object")
+                  .attr("__reduce_ex__")(self, protocol);
+            }
+            // With protocol 5 the serialized matrix is handed to pickle as a
+            // PickleBuffer, which pickle can pass out-of-band without copying
+            // it into a bytes object
+            const auto &m = self.cast<const hnp::DenseMatrix<T> &>();
+            auto buffer = [&] {
+              py::gil_scoped_release release;
+              return m.Serialize();
+            }();
+            auto pickle_buffer = py::module::import("pickle").attr(
+                "PickleBuffer")(py::cast(std::move(buffer)));
+            return py::make_tuple(self.attr("__class__").attr("load_buffer"),
+                                  py::make_tuple(pickle_buffer));
+          },
+          py::arg("protocol"))
+      .def_static(
+          "load_buffer",
+          [](const py::buffer &buffer) {
+            // no copy of the input, the buffer may be a PickleBuffer,
+            // memoryview, bytes, numpy array...
+            auto info = buffer.request();
+            // the bytes are read as one block, strided views are refused
+            auto stride = info.itemsize;
+            for (auto i = info.ndim; i-- > 0;) {
+              YACL_ENFORCE(info.shape[i] == 1 || info.strides[i] == stride,
+                           "load_buffer needs a C-contiguous buffer, please "
+                           "pass bytes(buffer) instead");
+              stride *= info.shape[i];
+            }
+            yacl::ByteContainerView view(info.ptr, info.size * info.itemsize);
+            py::gil_scoped_release release;
+            return hnp::DenseMatrix<T>::LoadFrom(view);
+          },
+          py::arg("buffer"),
+          "Deserialize matrix from any object supporting the buffer protocol, "
+          "without copying it")
       .def(
           "serialize",
           [](const hnp::DenseMatrix<T> &m, hnp::MatrixSerializeFormat format) {
-            auto buffer = m.Serialize(format);
+            auto buffer = [&] {
+              py::gil_scoped_release release;
+              return m.Serialize(format);
+            }();
             return pybind11::bytes(buffer.template data<char>(), buffer.size());
           },
           py::arg("format") = hnp::MatrixSerializeFormat::Best,
@@ -51,14 +98,16 @@ void BindMatrixCommon(py::class_<hnp::DenseMatrix<T>> &clazz) {
       .def_static(
           "load_from",
           [](const pybind11::bytes &buffer, hnp::MatrixSerializeFormat format) {
+            auto view = static_cast<std::string_view>(buffer);
+            py::gil_scoped_release release;
             // T has a static LoadFrom() function
-            return hnp::DenseMatrix<T>::LoadFrom(
-                static_cast<std::string_view>(buffer), format);
+            return hnp::DenseMatrix<T>::LoadFrom(view, format);
           },
           py::arg("bytes_buffer"),
           py::arg("format") = hnp::MatrixSerializeFormat::Best,
           "deserialize matrix from bytes")
-      .def("transpose", &hnp::DenseMatrix<T>::Transpose, "Transpose the array")
+      .def("transpose", &hnp::DenseMatrix<T>::Transpose,
+           "Return a transposed copy of the array", ReleaseGil())
       .def_property_readonly("rows", &hnp::DenseMatrix<T>::rows,
                              "Get the number of rows")
       .def_property_readonly("cols", &hnp::DenseMatrix<T>::cols,
@@ -69,7 +118,8 @@ void BindMatrixCommon(py::class_<hnp::DenseMatrix<T>> &clazz) {
                              "The array's number of dimensions")
       .def_property_readonly("shape", &hnp::DenseMatrix<T>::shape,
                              "The array's shape")
-      .def("__getitem__", &PySlicer<T>::GetItem, "Return self[key]")
+      .def("__getitem__", &PySlicer<T>::GetItem,
+           "Return a copy of self[key], unlike numpy it is not a view")
       .def("__setitem__", &PySlicer<T>::SetItem, "Set self[key] to value");
 }
 
@@ -148,6 +198,66 @@ void BindArrayForClass(PyClassT &m, const PyArgT &edr_arg) {
           .c_str());
 }
 
+// A python call that runs on a HeExecutor thread. It holds python objects, so
+// it is always destroyed with the GIL held, see SubmitPyCall()
+struct PyCall {
+  py::object future;
+  py::object fn;
+  py::tuple args;
+  py::dict kwargs;
+};
+
+// Run fn(*args, **kwargs) in executor, returns a concurrent.futures.Future of
+// the result. Heavy bindings release the GIL, so python threads (including the
+// caller) go on while the HE op runs.
+py::object SubmitPyCall(hnp::HeExecutor &executor, const py::object &fn,
+                        const py::tuple &args, const py::dict &kwargs) {
+  auto future = py::module::import("concurrent.futures").attr("Future")();
+  std::shared_ptr<PyCall> call(new PyCall{future, fn, args, kwargs},
+                               [](PyCall *p) {
+                                 py::gil_scoped_acquire acquire;
+                                 delete p;
+                               });
+  hnp::HeFuture<void> task;
+  {
+    // Submit() blocks while the queue is full
+    py::gil_scoped_release release;
+    task = executor.Submit([call] {
+      py::gil_scoped_acquire acquire;
+      // returns false if the future is cancelled in python
+      if (!call->future.attr("set_running_or_notify_cancel")().cast<bool>()) {
+        return;
+      }
+      try {
+        call->future.attr("set_result")(call->fn(*call->args, **call->kwargs));
+      } catch (py::error_already_set &e) {
+        call->future.attr("set_exception")(e.value());
+      }
+    });
+  }
+  // Future.cancel() only marks the python future, cancel the queued task too
+  // so that its queue slot is freed and blocked producers are woken up
+  future.attr("add_done_callback")(py::cpp_function(
+      [task = std::make_shared<hnp::HeFuture<void>>(std::move(task))](
+          const py::object &f) {
+        if (f.attr("cancelled")().cast<bool>()) {
+          task->Cancel();
+        }
+      }));
+  return future;
+}
+
+// Workers need the GIL to complete python futures, so an executor must be
+// shut down without holding it
+struct ExecutorDeleter {
+  void operator()(hnp::HeExecutor *executor) const {
+    py::gil_scoped_release release;
+    delete executor;
+  }
+};
+
+using ExecutorHolder = std::unique_ptr<hnp::HeExecutor, ExecutorDeleter>;
+
 }  // namespace
 
 void PyBindNumpy(pybind11::module &m) {
@@ -190,6 +300,14 @@ void PyBindNumpy(pybind11::module &m) {
       .value("Interconnection", hnp::MatrixSerializeFormat::Interconnection)
       .export_values();
 
+  // serialized bytes exported by the buffer protocol without copy, see
+  // __reduce_ex__ of arrays
+  py::class_<yacl::Buffer>(m, "SerializedBuffer", py::buffer_protocol())
+      .def_buffer([](yacl::Buffer &buffer) {
+        return py::buffer_info(buffer.data<uint8_t>(), buffer.size(), true);
+      })
+      .def("__len__", [](const yacl::Buffer &buffer) { return buffer.size(); });
+
   // bind pmatrix
   auto pmatrix = py::class_<hnp::PMatrix>(m, "PlaintextArray");
   BindMatrixCommon(pmatrix);
@@ -202,8 +320,11 @@ void PyBindNumpy(pybind11::module &m) {
       "to_bytes",
       [](const hnp::PMatrix &pm, size_t bytes_per_int,
          const std::string &endian) {
-        auto buf = hnp::Toolbox::PMatrixToBytes(pm, bytes_per_int,
-                                                PyUtils::PyEndianToCpp(endian));
+        auto buf = [&] {
+          auto cpp_endian = PyUtils::PyEndianToCpp(endian);
+          py::gil_scoped_release release;
+          return hnp::Toolbox::PMatrixToBytes(pm, bytes_per_int, cpp_endian);
+        }();
         return py::bytes(buf.data<char>(), buf.size());  // this is a copy
       },
       py::arg("bytes_per_int"), py::arg("endian"),
@@ -218,6 +339,77 @@ void PyBindNumpy(pybind11::module &m) {
   auto strmatrix = py::class_<hnp::DenseMatrix<std::string>>(m, "StringArray");
   BindMatrixCommon(strmatrix);
 
+  // bind file-backed cmatrix
+  py::class_<hnp::MappedCMatrix>(m, "MappedCiphertextArray",
+                                 "A ciphertext array stored in a "
+                                 "memory-mapped file, for data larger than "
+                                 "memory")
+      .def_static("create", &hnp::MappedCMatrix::Create, py::arg("path"),
+                  py::arg("shape"), py::arg("record_bytes"),
+                  "Create a file for an array of 'shape', each ciphertext "
+                  "takes 'record_bytes' bytes",
+                  ReleaseGil())
+      .def_static("open", &hnp::MappedCMatrix::Open, py::arg("path"),
+                  py::arg("writable") = false, ReleaseGil())
+      .def_static(
+          "from_array",
+          [](const std::string &path, const hnp::CMatrix &array) {
+            return hnp::MappedCMatrix::FromMatrix(path, array);
+          },
+          py::arg("path"), py::arg("array"), ReleaseGil())
+      .def_property_readonly("shape", &hnp::MappedCMatrix::shape)
+      .def_property_readonly("record_bytes",
+                             &hnp::MappedCMatrix::record_bytes)
+      .def_property_readonly("path", &hnp::MappedCMatrix::path)
+      .def("load", &hnp::MappedCMatrix::Load,
+           "Decode the whole array into memory", ReleaseGil())
+      .def("read_rows", &hnp::MappedCMatrix::ReadRows, py::arg("row_begin"),
+           py::arg("num_rows"), ReleaseGil())
+      .def(
+          "write_rows",
+          [](hnp::MappedCMatrix &self, int64_t row_begin,
+             const hnp::CMatrix &block) { self.WriteRows(row_begin, block); },
+          py::arg("row_begin"), py::arg("block"), ReleaseGil())
+      .def("flush", &hnp::MappedCMatrix::Flush, ReleaseGil());
+
+  // bind sparse pmatrix
+  py::class_<hnp::PSparseMatrix>(m, "SparsePlaintextArray")
+      .def(py::init([](const std::vector<int64_t> &shape,
+                       const py::array_t<int64_t, py::array::c_style |
+                                                      py::array::forcecast>
+                           &indptr,
+                       const py::array_t<int64_t, py::array::c_style |
+                                                      py::array::forcecast>
+                           &indices,
+                       const hnp::PMatrix &data, const std::string &format) {
+             YACL_ENFORCE(shape.size() == 2,
+                          "sparse array must be 2-d, got shape of size {}",
+                          shape.size());
+             YACL_ENFORCE(format == "csr" || format == "csc",
+                          "unsupported sparse format '{}'", format);
+             return hnp::PSparseMatrix(
+                 shape[0], shape[1],
+                 format == "csr" ? hnp::PSparseMatrix::Layout::kCsr
+                                 : hnp::PSparseMatrix::Layout::kCsc,
+                 std::vector<int64_t>(indptr.data(),
+                                      indptr.data() + indptr.size()),
+                 std::vector<int64_t>(indices.data(),
+                                      indices.data() + indices.size()),
+                 std::vector<phe::Plaintext>(data.data(),
+                                             data.data() + data.size()));
+           }),
+           py::arg("shape"), py::arg("indptr"), py::arg("indices"),
+           py::arg("data"), py::arg("format") = "csr",
+           "Create from the buffers of a scipy.sparse csr_matrix/csc_matrix, "
+           "e.g. SparsePlaintextArray(s.shape, s.indptr, s.indices, "
+           "kit.array(s.data), s.format)")
+      .def_property_readonly("shape", &hnp::PSparseMatrix::shape)
+      .def_property_readonly("nnz", &hnp::PSparseMatrix::nnz)
+      .def_property_readonly("format", [](const hnp::PSparseMatrix &self) {
+        return self.layout() == hnp::PSparseMatrix::Layout::kCsr ? "csr"
+                                                                 : "csc";
+      });
+
   // Bind hnp.array()
   // Usage: hnp.array([1, 2, 3], he_kit.bigint_encoder())
   BindArrayForModule<PyBigintEncoder>(m);
@@ -231,11 +423,13 @@ void PyBindNumpy(pybind11::module &m) {
       .def_static("randint", &hnp::Random::RandInt, py::arg("min"),
                   py::arg("max"), py::arg("shape"),
                   "Return a random integer array from the “discrete uniform” "
-                  "distribution in interval [min, max)")
+                  "distribution in interval [min, max)",
+                  ReleaseGil())
       .def_static("randbits", &hnp::Random::RandBits, py::arg("schema"),
                   py::arg("bits"), py::arg("shape"),
                   "Return a random integer array where each element is 'bits' "
-                  "bits long");
+                  "bits long",
+                  ReleaseGil());
 
   /****** key management ******/
   // api for sk_keeper party
@@ -262,7 +456,8 @@ void PyBindNumpy(pybind11::module &m) {
       },
       py::arg("schema_type"), py::arg("key_size"),
       py::return_value_policy::move,
-      "Setup phe (numpy) environment by schema type and key size");
+      "Setup phe (numpy) environment by schema type and key size",
+      ReleaseGil());
 
   m.def(
       "setup",
@@ -272,7 +467,8 @@ void PyBindNumpy(pybind11::module &m) {
       },
       py::arg("schema_string"), py::arg("key_size"),
       py::return_value_policy::move,
-      "Setup phe (numpy) environment by schema string and key size");
+      "Setup phe (numpy) environment by schema string and key size",
+      ReleaseGil());
 
   m.def(
       "setup",
@@ -281,7 +477,7 @@ void PyBindNumpy(pybind11::module &m) {
       },
       py::arg("schema_type") = phe::SchemaType::ZPaillier,
       py::return_value_policy::move,
-      "Setup phe (numpy) environment by schema type");
+      "Setup phe (numpy) environment by schema type", ReleaseGil());
 
   m.def(
       "setup",
@@ -289,7 +485,7 @@ void PyBindNumpy(pybind11::module &m) {
         return hnp::HeKit(phe::HeKit(phe::ParseSchemaType(schema_string)));
       },
       py::arg("schema_string") = "z-paillier", py::return_value_policy::move,
-      "Setup phe (numpy) environment by schema string");
+      "Setup phe (numpy) environment by schema string", ReleaseGil());
 
   // api for evaluator party
   auto dhe_kit = py::class_<hnp::DestinationHeKit, phe::HeKitPublicBase>(
@@ -329,15 +525,16 @@ void PyBindNumpy(pybind11::module &m) {
            py::overload_cast<const phe::Plaintext &>(&hnp::Encryptor::Encrypt,
                                                      py::const_),
            py::arg("plaintext"),
-           "Encrypt plaintext (scalar) to ciphertext (scalar)")
+           "Encrypt plaintext (scalar) to ciphertext (scalar)", ReleaseGil())
       .def("encrypt",
            py::overload_cast<const hnp::PMatrix &>(&hnp::Encryptor::Encrypt,
                                                    py::const_),
            py::arg("plaintext_array"),
-           "Encrypt plaintext array to ciphertext array")
+           "Encrypt plaintext array to ciphertext array", ReleaseGil())
       .def("encrypt_with_audit", &hnp::Encryptor::EncryptWithAudit,
            "Encrypt and build audit string including "
-           "plaintext/random/ciphertext info");
+           "plaintext/random/ciphertext info",
+           ReleaseGil());
 
   /****** decryption ******/
   py::class_<hnp::Decryptor, std::shared_ptr<hnp::Decryptor>>(m, "Decryptor")
@@ -350,12 +547,12 @@ void PyBindNumpy(pybind11::module &m) {
            py::overload_cast<const phe::Ciphertext &>(&hnp::Decryptor::Decrypt,
                                                       py::const_),
            py::arg("ciphertext"),
-           "Decrypt ciphertext (scalar) to plaintext (scalar)")
+           "Decrypt ciphertext (scalar) to plaintext (scalar)", ReleaseGil())
       .def("decrypt",
            py::overload_cast<const hnp::CMatrix &>(&hnp::Decryptor::Decrypt,
                                                    py::const_),
            py::arg("ciphertext_array"),
-           "Decrypt ciphertext array to plaintext array")
+           "Decrypt ciphertext array to plaintext array", ReleaseGil())
       .def("decrypt_in_range",
            py::overload_cast<const phe::Ciphertext &, size_t>(
                &hnp::Decryptor::DecryptInRange, py::const_),
@@ -363,7 +560,8 @@ void PyBindNumpy(pybind11::module &m) {
            "Decrypt ciphertext (scalar) and make sure plaintext is in range "
            "(-2^range_bits, 2^range_bits). Range checking is used to block OU "
            "plaintext overflow attack, see HEU documentation for details.\n"
-           "throws an exception if plaintext is out of range.")
+           "throws an exception if plaintext is out of range.",
+           ReleaseGil())
       .def("decrypt_in_range",
            py::overload_cast<const hnp::CMatrix &, size_t>(
                &hnp::Decryptor::DecryptInRange, py::const_),
@@ -371,7 +569,8 @@ void PyBindNumpy(pybind11::module &m) {
            "Decrypt ciphertext array and make sure each plaintext is in range "
            "(-2^range_bits, 2^range_bits). Range checking is used to block OU "
            "plaintext overflow attack, see HEU documentation for details.\n"
-           "throws an exception if plaintext is out of range.");
+           "throws an exception if plaintext is out of range.",
+           ReleaseGil());
 
   /****** evaluation ******/
   py::class_<hnp::Evaluator, std::shared_ptr<hnp::Evaluator>>(m, "Evaluator")
@@ -380,43 +579,203 @@ void PyBindNumpy(pybind11::module &m) {
       // pybind11
       .def_property_readonly(
           "phe", [](hnp::Evaluator &self) -> phe::Evaluator & { return self; })
-      .def("add", py::overload_cast<const hnp::CMatrix &, const hnp::CMatrix &>(
-                      &hnp::Evaluator::Add, py::const_))
-      .def("add", py::overload_cast<const hnp::CMatrix &, const hnp::PMatrix &>(
-                      &hnp::Evaluator::Add, py::const_))
-      .def("add", py::overload_cast<const hnp::PMatrix &, const hnp::CMatrix &>(
-                      &hnp::Evaluator::Add, py::const_))
-      .def("add", py::overload_cast<const hnp::PMatrix &, const hnp::PMatrix &>(
-                      &hnp::Evaluator::Add, py::const_))
-
-      .def("sub", py::overload_cast<const hnp::CMatrix &, const hnp::CMatrix &>(
-                      &hnp::Evaluator::Sub, py::const_))
-      .def("sub", py::overload_cast<const hnp::CMatrix &, const hnp::PMatrix &>(
-                      &hnp::Evaluator::Sub, py::const_))
-      .def("sub", py::overload_cast<const hnp::PMatrix &, const hnp::CMatrix &>(
-                      &hnp::Evaluator::Sub, py::const_))
-      .def("sub", py::overload_cast<const hnp::PMatrix &, const hnp::PMatrix &>(
-                      &hnp::Evaluator::Sub, py::const_))
-
-      .def("mul", py::overload_cast<const hnp::CMatrix &, const hnp::PMatrix &>(
-                      &hnp::Evaluator::Mul, py::const_))
-      .def("mul", py::overload_cast<const hnp::PMatrix &, const hnp::CMatrix &>(
-                      &hnp::Evaluator::Mul, py::const_))
-      .def("mul", py::overload_cast<const hnp::PMatrix &, const hnp::PMatrix &>(
-                      &hnp::Evaluator::Mul, py::const_))
+      .def("add",
+           py::overload_cast<const hnp::CMatrix &, const hnp::CMatrix &>(
+               &hnp::Evaluator::Add, py::const_),
+           ReleaseGil())
+      .def("add",
+           py::overload_cast<const hnp::CMatrix &, const hnp::PMatrix &>(
+               &hnp::Evaluator::Add, py::const_),
+           ReleaseGil())
+      .def("add",
+           py::overload_cast<const hnp::PMatrix &, const hnp::CMatrix &>(
+               &hnp::Evaluator::Add, py::const_),
+           ReleaseGil())
+      .def("add",
+           py::overload_cast<const hnp::PMatrix &, const hnp::PMatrix &>(
+               &hnp::Evaluator::Add, py::const_),
+           ReleaseGil())
+
+      .def("sub",
+           py::overload_cast<const hnp::CMatrix &, const hnp::CMatrix &>(
+               &hnp::Evaluator::Sub, py::const_),
+           ReleaseGil())
+      .def("sub",
+           py::overload_cast<const hnp::CMatrix &, const hnp::PMatrix &>(
+               &hnp::Evaluator::Sub, py::const_),
+           ReleaseGil())
+      .def("sub",
+           py::overload_cast<const hnp::PMatrix &, const hnp::CMatrix &>(
+               &hnp::Evaluator::Sub, py::const_),
+           ReleaseGil())
+      .def("sub",
+           py::overload_cast<const hnp::PMatrix &, const hnp::PMatrix &>(
+               &hnp::Evaluator::Sub, py::const_),
+           ReleaseGil())
+
+      .def("mul",
+           py::overload_cast<const hnp::CMatrix &, const hnp::PMatrix &>(
+               &hnp::Evaluator::Mul, py::const_),
+           ReleaseGil())
+      .def("mul",
+           py::overload_cast<const hnp::PMatrix &, const hnp::CMatrix &>(
+               &hnp::Evaluator::Mul, py::const_),
+           ReleaseGil())
+      .def("mul",
+           py::overload_cast<const hnp::PMatrix &, const hnp::PMatrix &>(
+               &hnp::Evaluator::Mul, py::const_),
+           ReleaseGil())
 
       .def("matmul",
            py::overload_cast<const hnp::PMatrix &, const hnp::PMatrix &>(
-               &hnp::Evaluator::MatMul, py::const_))
+               &hnp::Evaluator::MatMul, py::const_),
+           ReleaseGil())
       .def("matmul",
            py::overload_cast<const hnp::PMatrix &, const hnp::CMatrix &>(
-               &hnp::Evaluator::MatMul, py::const_))
+               &hnp::Evaluator::MatMul, py::const_),
+           ReleaseGil())
       .def("matmul",
            py::overload_cast<const hnp::CMatrix &, const hnp::PMatrix &>(
-               &hnp::Evaluator::MatMul, py::const_))
+               &hnp::Evaluator::MatMul, py::const_),
+           ReleaseGil())
 
-      .def("sum", &hnp::Evaluator::Sum<phe::Plaintext>)
-      .def("sum", &hnp::Evaluator::Sum<phe::Ciphertext>)
+      .def(
+          "matmul",
+          [](const hnp::Evaluator &self, const hnp::PSparseMatrix &x,
+             const hnp::CMatrix &y) { return self.MatMul(x, y); },
+          py::arg("x"), py::arg("y"),
+          "Sparse matmul, only the non-zeros of x are visited", ReleaseGil())
+      .def(
+          "matmul",
+          [](const hnp::Evaluator &self, const hnp::CMatrix &x,
+             const hnp::PSparseMatrix &y) { return self.MatMul(x, y); },
+          py::arg("x"), py::arg("y"),
+          "Sparse matmul, only the non-zeros of y are visited", ReleaseGil())
+
+      // out-of-core ops on MappedCiphertextArray
+      .def(
+          "add",
+          [](const hnp::Evaluator &self, const hnp::MappedCMatrix &x,
+             const hnp::MappedCMatrix &y, hnp::MappedCMatrix *out,
+             int64_t chunk_size) { self.Add(x, y, out, chunk_size); },
+          py::arg("x"), py::arg("y"), py::arg("out"),
+          py::arg("chunk_size") = hnp::kMappedChunkSize,
+          "Streamed out = x + y, chunk by chunk", ReleaseGil())
+      .def(
+          "sum",
+          [](const hnp::Evaluator &self, const hnp::MappedCMatrix &x,
+             int64_t chunk_size) { return self.Sum(x, chunk_size); },
+          py::arg("x"), py::arg("chunk_size") = hnp::kMappedChunkSize,
+          ReleaseGil())
+      .def(
+          "matmul",
+          [](const hnp::Evaluator &self, const hnp::MappedCMatrix &x,
+             const hnp::PMatrix &y, hnp::MappedCMatrix *out,
+             int64_t chunk_size) { self.MatMul(x, y, out, chunk_size); },
+          py::arg("x"), py::arg("y"), py::arg("out"),
+          py::arg("chunk_size") = hnp::kMappedChunkSize,
+          "Streamed out = x @ y, x is read by row blocks", ReleaseGil())
+      .def(
+          "matmul",
+          [](const hnp::Evaluator &self, const hnp::PMatrix &x,
+             const hnp::MappedCMatrix &y, int64_t chunk_size) {
+            return self.MatMul(x, y, chunk_size);
+          },
+          py::arg("x"), py::arg("y"),
+          py::arg("chunk_size") = hnp::kMappedChunkSize,
+          "Streamed x @ y, y is read by row blocks", ReleaseGil())
+
+      .def(
+          "add_",
+          [](const hnp::Evaluator &self, hnp::CMatrix *x,
+             const hnp::CMatrix &y) { self.AddInplace(x, y); },
+          py::arg("x"), py::arg("y"), "In-place add, x += y", ReleaseGil())
+      .def(
+          "add_",
+          [](const hnp::Evaluator &self, hnp::CMatrix *x,
+             const hnp::PMatrix &y) { self.AddInplace(x, y); },
+          py::arg("x"), py::arg("y"), "In-place add, x += y", ReleaseGil())
+      .def(
+          "add_",
+          [](const hnp::Evaluator &self, hnp::PMatrix *x,
+             const hnp::PMatrix &y) { self.AddInplace(x, y); },
+          py::arg("x"), py::arg("y"), "In-place add, x += y", ReleaseGil())
+
+      .def(
+          "sub_",
+          [](const hnp::Evaluator &self, hnp::CMatrix *x,
+             const hnp::CMatrix &y) { self.SubInplace(x, y); },
+          py::arg("x"), py::arg("y"), "In-place sub, x -= y", ReleaseGil())
+      .def(
+          "sub_",
+          [](const hnp::Evaluator &self, hnp::CMatrix *x,
+             const hnp::PMatrix &y) { self.SubInplace(x, y); },
+          py::arg("x"), py::arg("y"), "In-place sub, x -= y", ReleaseGil())
+      .def(
+          "sub_",
+          [](const hnp::Evaluator &self, hnp::PMatrix *x,
+             const hnp::PMatrix &y) { self.SubInplace(x, y); },
+          py::arg("x"), py::arg("y"), "In-place sub, x -= y", ReleaseGil())
+
+      .def(
+          "mul_",
+          [](const hnp::Evaluator &self, hnp::CMatrix *x,
+             const hnp::PMatrix &y) { self.MulInplace(x, y); },
+          py::arg("x"), py::arg("y"), "In-place mul, x *= y", ReleaseGil())
+      .def(
+          "mul_",
+          [](const hnp::Evaluator &self, hnp::PMatrix *x,
+             const hnp::PMatrix &y) { self.MulInplace(x, y); },
+          py::arg("x"), py::arg("y"), "In-place mul, x *= y", ReleaseGil())
+
+      .def(
+          "axpy",
+          [](const hnp::Evaluator &self, const hnp::PMatrix &a,
+             const hnp::CMatrix &x,
+             hnp::CMatrix *y) { self.Axpy(a, x, y); },
+          py::arg("a"), py::arg("x"), py::arg("y"),
+          "Compute y = a * x + y in place without an intermediate array",
+          ReleaseGil())
+      .def(
+          "matmul_accumulate",
+          [](const hnp::Evaluator &self, const hnp::CMatrix &x,
+             const hnp::PMatrix &y,
+             hnp::CMatrix *out) { self.MatMulAccumulate(x, y, out); },
+          py::arg("x"), py::arg("y"), py::arg("out"),
+          "Compute out += x @ y in place", ReleaseGil())
+      .def(
+          "matmul_accumulate",
+          [](const hnp::Evaluator &self, const hnp::PMatrix &x,
+             const hnp::CMatrix &y,
+             hnp::CMatrix *out) { self.MatMulAccumulate(x, y, out); },
+          py::arg("x"), py::arg("y"), py::arg("out"),
+          "Compute out += x @ y in place", ReleaseGil())
+
+      .def("align_exponents",
+           py::overload_cast<hnp::CMatrix *>(
+               &hnp::Evaluator::AlignExponentsInplace, py::const_),
+           py::arg("x"),
+           "Align the exponents of all ciphertexts in x to a common value in "
+           "place. Only FPaillier ciphertexts carry an exponent, for other "
+           "schemas this is a no-op.",
+           ReleaseGil())
+      .def("align_exponents",
+           py::overload_cast<hnp::CMatrix *, hnp::CMatrix *>(
+               &hnp::Evaluator::AlignExponentsInplace, py::const_),
+           py::arg("x"), py::arg("y"),
+           "Align the exponents of all ciphertexts in x and y to a common "
+           "value in place, so that subsequent add/sub between x and y never "
+           "re-align.",
+           ReleaseGil())
+
+      .def("sum",
+           py::overload_cast<const hnp::PMatrix &>(
+               &hnp::Evaluator::Sum<phe::Plaintext>, py::const_),
+           ReleaseGil())
+      .def("sum",
+           py::overload_cast<const hnp::CMatrix &>(
+               &hnp::Evaluator::Sum<phe::Ciphertext>, py::const_),
+           ReleaseGil())
 
       .def("select_sum",
            &heu::pylib::ExtensionFunctions<phe::Plaintext>::SelectSum,
@@ -453,7 +812,8 @@ void PyBindNumpy(pybind11::module &m) {
           "bucket_num int. The number of buckets for each bin. \n"
           "cumsum bool. If apply cumulative sum to buckets for each feature.\n"
           "return dense matrix<T>, the row bin sum result. It has shape \n"
-          "(bucket_num * feature_num, x.cols()).")
+          "(bucket_num * feature_num, x.cols()).",
+          ReleaseGil())
       .def("feature_wise_bucket_sum",
            &heu::pylib::ExtensionFunctions<
                phe::Ciphertext>::FeatureWiseBucketSum,
@@ -472,7 +832,8 @@ void PyBindNumpy(pybind11::module &m) {
            "bucket_num int. The number of buckets for each bin.\n"
            "cumsum bool. If apply cumulative sum to buckets for each feature.\n"
            "return dense matrix<T>, the row bin sum result. It has shape\n"
-           "(bucket_num * feature_num, x.cols()).\n")
+           "(bucket_num * feature_num, x.cols()).\n",
+           ReleaseGil())
       .def(
           "batch_feature_wise_bucket_sum",
           &heu::pylib::ExtensionFunctions<
@@ -491,7 +852,8 @@ void PyBindNumpy(pybind11::module &m) {
           "bucket_num int. The number of buckets for each bin. \n"
           "cumsum bool. If apply cumulative sum to buckets for each feature.\n"
           "return list of dense matrix<T>, the row bin sum results. \n"
-          "Each element has shape (bucket_num * feature_num, x.cols()).\n")
+          "Each element has shape (bucket_num * feature_num, x.cols()).\n",
+          ReleaseGil())
       .def(
           "batch_feature_wise_bucket_sum",
           &heu::pylib::ExtensionFunctions<
@@ -510,7 +872,136 @@ void PyBindNumpy(pybind11::module &m) {
           "bucket_num int. The number of buckets for each bin. \n"
           "cumsum bool. If apply cumulative sum to buckets for each feature.\n"
           "return list of dense matrix<T>, the row bin sum results. \n"
-          "Each element has shape (bucket_num * feature_num, x.cols()).\n");
+          "Each element has shape (bucket_num * feature_num, x.cols()).\n",
+          ReleaseGil());
+
+  /****** lazy evaluation ******/
+  py::class_<hnp::LazyTensor>(m, "LazyTensor")
+      .def_property_readonly("shape", &hnp::LazyTensor::shape)
+      .def_property_readonly("ndim", &hnp::LazyTensor::ndim)
+      .def("is_ciphertext", &hnp::LazyTensor::IsCiphertext);
+
+  py::class_<hnp::LazyEvaluator>(
+      m, "LazyEvaluator",
+      "Record add/sub/mul/matmul/sum as an expression graph and compute it in "
+      "eval(). Chains of element-wise ops are fused into one pass, identical "
+      "sub-expressions are computed once.\n"
+      "Input arrays must not be modified until eval() returns.")
+      .def(py::init([](const std::shared_ptr<hnp::Evaluator> &evaluator) {
+             return std::make_unique<hnp::LazyEvaluator>(evaluator);
+           }),
+           py::arg("evaluator"))
+      // every tensor keeps its operands alive, so the input arrays outlive
+      // all tensors derived from them
+      .def(
+          "input",
+          [](hnp::LazyEvaluator &self, const hnp::CMatrix &x) {
+            return self.Input(x);
+          },
+          py::arg("x"), py::keep_alive<0, 2>())
+      .def(
+          "input",
+          [](hnp::LazyEvaluator &self, const hnp::PMatrix &x) {
+            return self.Input(x);
+          },
+          py::arg("x"), py::keep_alive<0, 2>())
+      .def("add", &hnp::LazyEvaluator::Add, py::keep_alive<0, 2>(),
+           py::keep_alive<0, 3>())
+      .def("sub", &hnp::LazyEvaluator::Sub, py::keep_alive<0, 2>(),
+           py::keep_alive<0, 3>())
+      .def("mul", &hnp::LazyEvaluator::Mul, py::keep_alive<0, 2>(),
+           py::keep_alive<0, 3>())
+      .def("matmul", &hnp::LazyEvaluator::MatMul, py::keep_alive<0, 2>(),
+           py::keep_alive<0, 3>())
+      .def("sum", &hnp::LazyEvaluator::Sum, py::keep_alive<0, 2>())
+      .def(
+          "eval",
+          [](const hnp::LazyEvaluator &self,
+             const hnp::LazyTensor &x) -> py::object {
+            auto to_py = [](auto &&m) -> py::object {
+              if (m.ndim() == 0) {
+                return py::cast(m(0, 0));
+              }
+              return py::cast(std::move(m));
+            };
+            auto eval = [&](auto type) {
+              py::gil_scoped_release release;
+              return self.Eval<decltype(type)>(x);
+            };
+            if (x.IsCiphertext()) {
+              return to_py(eval(phe::Ciphertext()));
+            }
+            return to_py(eval(phe::Plaintext()));
+          },
+          py::arg("x"),
+          "Compute x, returns an array, or a scalar if x is the result of "
+          "sum()");
+
+  /****** async execution ******/
+  py::class_<hnp::HeExecutor, ExecutorHolder>(
+      m, "HeExecutor",
+      "Threads dedicated to HE jobs. submit() and the encrypt/matmul/decrypt "
+      "shortcuts return a concurrent.futures.Future, use asyncio.wrap_future() "
+      "to await it. At most max_pending jobs wait in the queue, submitting "
+      "blocks while the queue is full. Future.cancel() cancels a job that has "
+      "not started.\n"
+      "Arrays passed to a job must not be modified until the job is done.")
+      .def(py::init<size_t, size_t>(), py::arg("num_workers") = 1,
+           py::arg("max_pending") = 4)
+      .def(
+          "submit",
+          [](hnp::HeExecutor &self, const py::object &fn, const py::args &args,
+             const py::kwargs &kwargs) {
+            return SubmitPyCall(self, fn, args, kwargs);
+          },
+          "Schedule fn(*args, **kwargs) to run in the executor, returns a "
+          "concurrent.futures.Future")
+      .def(
+          "encrypt",
+          [](hnp::HeExecutor &self, const py::object &encryptor,
+             const py::object &x) {
+            return SubmitPyCall(self, encryptor.attr("encrypt"),
+                                py::make_tuple(x), py::dict());
+          },
+          py::arg("encryptor"), py::arg("x"), "Async encryptor.encrypt(x)")
+      .def(
+          "matmul",
+          [](hnp::HeExecutor &self, const py::object &evaluator,
+             const py::object &x, const py::object &y) {
+            return SubmitPyCall(self, evaluator.attr("matmul"),
+                                py::make_tuple(x, y), py::dict());
+          },
+          py::arg("evaluator"), py::arg("x"), py::arg("y"),
+          "Async evaluator.matmul(x, y)")
+      .def(
+          "decrypt",
+          [](hnp::HeExecutor &self, const py::object &decryptor,
+             const py::object &x) {
+            return SubmitPyCall(self, decryptor.attr("decrypt"),
+                                py::make_tuple(x), py::dict());
+          },
+          py::arg("decryptor"), py::arg("x"), "Async decryptor.decrypt(x)")
+      .def_property_readonly("num_workers", &hnp::HeExecutor::NumWorkers)
+      .def_property_readonly("max_pending", &hnp::HeExecutor::MaxPending)
+      .def("shutdown", &hnp::HeExecutor::Shutdown, ReleaseGil(),
+           "Run the queued jobs and stop all workers")
+      .def("__enter__", [](const py::object &self) { return self; })
+      .def(
+          "__exit__",
+          [](hnp::HeExecutor &self, const py::args &) { self.Shutdown(); },
+          ReleaseGil());
+
+  /****** kernel tracing ******/
+  m.def("start_trace", &hnp::Tracer::Start,
+        "Start recording Chrome-trace spans of evaluator kernels and their "
+        "parallel chunks, previous spans are dropped. Raises an error if HEU "
+        "is built without --config=trace.");
+  m.def("stop_trace", &hnp::Tracer::Stop, "Stop recording trace spans");
+  m.def("dump_trace", &hnp::Tracer::DumpJson, py::arg("path"),
+        "Write the recorded spans to 'path' as Chrome trace JSON, which can be "
+        "loaded by https://ui.perfetto.dev",
+        ReleaseGil());
+  m.attr("trace_compiled_in") = hnp::Tracer::kCompiledIn;
 
   // pure numpy functions that support xgb
   m.def("tree_predict", &heu::pylib::PureNumpyExtensionFunctions::TreePredict,
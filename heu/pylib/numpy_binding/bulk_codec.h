@@ -0,0 +1,74 @@
+// Copyright 2024 Ant Group Co., Ltd.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstdint>
+
+#include "pybind11/numpy.h"
+#include "pybind11/pybind11.h"
+
+#include "heu/pylib/common/traits.h"
+
+// Helpers of infeed.h and outfeed.h to convert between ndarray buffers and
+// plaintext matrices without per-element index arithmetic of py::array
+namespace heu::pylib::bulk_codec {
+
+// Converting one element takes well under a microsecond, so work is split in
+// much larger chunks than kHeOpGrainSize
+inline constexpr int64_t kCodecGrainSize = 4096;
+
+struct ContiguousArray {
+  py::array array;  // keeps the buffer alive
+  bool c_order;
+};
+
+// Returns ndarray itself if it is C or Fortran contiguous, otherwise a C
+// contiguous copy of it
+inline ContiguousArray MakeContiguous(const py::array &ndarray) {
+  auto flags = ndarray.flags();
+  if (flags & (py::array::c_style | py::array::f_style)) {
+    return {ndarray, (flags & py::array::c_style) != 0};
+  }
+  return {py::array::ensure(ndarray, py::array::c_style), true};
+}
+
+// Visits the elements [beg, end) of a ColMajor rows*cols matrix, calls fn(i, j)
+// with i the index in the matrix and j the index of the same element in a
+// contiguous ndarray buffer of order c_order.
+template <typename Fn>
+void ForEachIndex(int64_t beg, int64_t end, int64_t rows, int64_t cols,
+                  bool c_order, Fn &&fn) {
+  if (!c_order || cols == 1) {
+    for (int64_t i = beg; i < end; ++i) {
+      fn(i, i);
+    }
+    return;
+  }
+
+  if (beg >= end) {
+    return;
+  }
+  int64_t row = beg % rows;
+  int64_t col = beg / rows;
+  for (int64_t i = beg; i < end; ++i) {
+    fn(i, row * cols + col);
+    if (++row == rows) {
+      row = 0;
+      ++col;
+    }
+  }
+}
+
+}  // namespace heu::pylib::bulk_codec
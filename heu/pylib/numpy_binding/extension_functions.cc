@@ -14,6 +14,7 @@
 
 #include "heu/pylib/numpy_binding/extension_functions.h"
 
+#include <optional>
 #include <tuple>
 
 #include "fmt/ranges.h"
@@ -25,11 +26,19 @@
 
 namespace heu::pylib {
 
-// todo: place make sure this function is thread safe.
+namespace {
+
+// Row and column indices parsed from a python slice key. No cols means all
+// columns are selected.
+struct SelectKey {
+  std::vector<int64_t> rows;
+  std::optional<std::vector<int64_t>> cols;
+};
+
+// Python objects are only accessed here, the GIL must be held
 template <typename T>
-T ExtensionFunctions<T>::SelectSum(const hnp::Evaluator &evaluator,
-                                   const hnp::DenseMatrix<T> &p_matrix,
-                                   const py::object &key) {
+SelectKey ParseSelectKey(const hnp::DenseMatrix<T> &p_matrix,
+                         const py::object &key) {
   if (py::isinstance<py::tuple>(key)) {
     auto idx_tuple = py::cast<py::tuple>(key);
 
@@ -45,7 +54,7 @@ T ExtensionFunctions<T>::SelectSum(const hnp::Evaluator &evaluator,
       auto s_row = slice_tool::Parse(idx_tuple[0], p_matrix.rows(), &sq_row);
       auto s_col = slice_tool::Parse(idx_tuple[1], p_matrix.cols(), &sq_col);
 
-      return evaluator.SelectSum(p_matrix, s_row.indices, s_col.indices);
+      return {std::move(s_row.indices), std::move(s_col.indices)};
     }
 
     // break if: continue to process 1-d case
@@ -55,10 +64,18 @@ T ExtensionFunctions<T>::SelectSum(const hnp::Evaluator &evaluator,
   // key dimension is less than tensor dimension
   bool sq_row;
   auto s_row = slice_tool::Parse(key, p_matrix.rows(), &sq_row);
-  return evaluator.SelectSum(p_matrix, s_row.indices, Eigen::placeholders::all);
+  return {std::move(s_row.indices), std::nullopt};
 }
 
-namespace {
+// Pure C++, runs without the GIL
+template <typename T>
+T DoSelectSum(const hnp::Evaluator &evaluator,
+              const hnp::DenseMatrix<T> &p_matrix, const SelectKey &key) {
+  if (key.cols) {
+    return evaluator.SelectSum(p_matrix, key.rows, *key.cols);
+  }
+  return evaluator.SelectSum(p_matrix, key.rows, Eigen::placeholders::all);
+}
 
 // we move this function here to avoid gcc warning:
 //    '<lambda(int64_t, int64_t)>' declared with greater visibility than the
@@ -66,12 +83,11 @@ namespace {
 template <typename T>
 hnp::DenseMatrix<T> DoBatchSelectSum(const hnp::Evaluator &evaluator,
                                      const hnp::DenseMatrix<T> &p_matrix,
-                                     const std::vector<py::object> &key) {
-  auto res = hnp::DenseMatrix<T>(key.size());
-  yacl::parallel_for(0, key.size(), 1, [&](int64_t beg, int64_t end) {
+                                     const std::vector<SelectKey> &keys) {
+  auto res = hnp::DenseMatrix<T>(keys.size());
+  yacl::parallel_for(0, keys.size(), 1, [&](int64_t beg, int64_t end) {
     for (int64_t x = beg; x < end; ++x) {
-      res.data()[x] =
-          ExtensionFunctions<T>::SelectSum(evaluator, p_matrix, key[x]);
+      res.data()[x] = DoSelectSum(evaluator, p_matrix, keys[x]);
     }
   });
   return res;
@@ -79,11 +95,27 @@ hnp::DenseMatrix<T> DoBatchSelectSum(const hnp::Evaluator &evaluator,
 
 }  // namespace
 
+template <typename T>
+T ExtensionFunctions<T>::SelectSum(const hnp::Evaluator &evaluator,
+                                   const hnp::DenseMatrix<T> &p_matrix,
+                                   const py::object &key) {
+  auto select_key = ParseSelectKey(p_matrix, key);
+  py::gil_scoped_release release;
+  return DoSelectSum(evaluator, p_matrix, select_key);
+}
+
 template <typename T>
 hnp::DenseMatrix<T> ExtensionFunctions<T>::BatchSelectSum(
     const hnp::Evaluator &evaluator, const hnp::DenseMatrix<T> &p_matrix,
     const std::vector<py::object> &key) {
-  return DoBatchSelectSum(evaluator, p_matrix, key);
+  // parse all keys before going parallel, worker threads never hold the GIL
+  std::vector<SelectKey> select_keys;
+  select_keys.reserve(key.size());
+  for (const auto &k : key) {
+    select_keys.push_back(ParseSelectKey(p_matrix, k));
+  }
+  py::gil_scoped_release release;
+  return DoBatchSelectSum(evaluator, p_matrix, select_keys);
 }
 
 template <typename T>
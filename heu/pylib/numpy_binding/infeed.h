@@ -14,16 +14,81 @@
 
 #pragma once
 
+#include <vector>
+
 #include "pybind11/numpy.h"
 #include "pybind11/pybind11.h"
+#include "yacl/utils/parallel.h"
 
 #include "heu/library/numpy/matrix.h"
 #include "heu/library/phe/phe.h"
 #include "heu/pylib/common/traits.h"
+#include "heu/pylib/numpy_binding/bulk_codec.h"
 #include "heu/pylib/phe_binding//py_encoders.h"
 
 namespace heu::pylib {
 
+namespace internal {
+
+template <typename EL_TYPE, typename Encoder_t>
+void EncodeNumeric(const py::array &ndarray, const Encoder_t &encoder,
+                   hnp::DenseMatrix<phe::Plaintext> *res) {
+  auto in = bulk_codec::MakeContiguous(ndarray);
+  const auto *buf = static_cast<const EL_TYPE *>(in.array.data());
+  auto *out = res->data();
+  auto rows = res->rows();
+  auto cols = res->cols();
+
+  py::gil_scoped_release release;
+  yacl::parallel_for(
+      0, res->size(), bulk_codec::kCodecGrainSize,
+      [&](int64_t beg, int64_t end) {
+        bulk_codec::ForEachIndex(
+            beg, end, rows, cols, in.c_order,
+            [&](int64_t i, int64_t j) { out[i] = encoder.Encode(buf[j]); });
+      });
+}
+
+// Python ints are read with the GIL held. The ones fitting in int64 are
+// turned into plaintexts in parallel without the GIL, only larger ones are
+// converted one by one through their string representation.
+template <typename Encoder_t>
+void EncodePyInts(const py::array &ndarray, const Encoder_t &encoder,
+                  hnp::DenseMatrix<phe::Plaintext> *res) {
+  auto in = bulk_codec::MakeContiguous(ndarray);
+  auto *const *buf = static_cast<PyObject *const *>(in.array.data());
+  auto *out = res->data();
+  auto size = res->size();
+
+  std::vector<int64_t> values(size);
+  std::vector<uint8_t> fits(size, 0);
+  bulk_codec::ForEachIndex(0, size, res->rows(), res->cols(), in.c_order,
+                           [&](int64_t i, int64_t j) {
+                             int overflow = 1;
+                             if (PyLong_Check(buf[j])) {
+                               values[i] = PyLong_AsLongLongAndOverflow(
+                                   buf[j], &overflow);
+                             }
+                             if (overflow == 0) {
+                               fits[i] = 1;
+                             } else {
+                               out[i] = encoder.Encode(buf[j]);
+                             }
+                           });
+
+  py::gil_scoped_release release;
+  yacl::parallel_for(0, size, bulk_codec::kCodecGrainSize,
+                     [&](int64_t beg, int64_t end) {
+                       for (int64_t i = beg; i < end; ++i) {
+                         if (fits[i]) {
+                           out[i] = encoder.Encode(values[i]);
+                         }
+                       }
+                     });
+}
+
+}  // namespace internal
+
 // scalar encoding
 template <
     typename EL_TYPE, typename Encoder_t,
@@ -47,11 +112,17 @@ hnp::DenseMatrix<phe::Plaintext> DoEncodeMatrix(const py::array &ndarray,
     return res;
   }
 
-  auto r = ndarray.unchecked<EL_TYPE, -1>();
-  res.ForEach([&](int64_t row, int64_t col,
-                  phe::Plaintext *pt) { *pt = encoder.Encode(r(row, col)); },
-              !std::is_same_v<Encoder_t, PyBigintEncoder> ||
-                  !std::is_same_v<EL_TYPE, PyObject *>);
+  if constexpr (!std::is_same_v<EL_TYPE, PyObject *>) {
+    internal::EncodeNumeric<EL_TYPE>(ndarray, encoder, &res);
+  } else if constexpr (std::is_same_v<Encoder_t, PyBigintEncoder>) {
+    internal::EncodePyInts(ndarray, encoder, &res);
+  } else {
+    // throws, only BigintEncoder accepts python objects
+    auto r = ndarray.unchecked<EL_TYPE, -1>();
+    res.ForEach([&](int64_t row, int64_t col,
+                    phe::Plaintext *pt) { *pt = encoder.Encode(r(row, col)); },
+                false);
+  }
   return res;
 }
 
@@ -81,17 +152,20 @@ hnp::DenseMatrix<phe::Plaintext> DoEncodeMatrix(const py::array &ndarray,
   auto rows = ndarray.ndim() == 1 ? 1 : ndarray.shape(0);
   auto cols = 1;
   hnp::DenseMatrix<phe::Plaintext> res(rows, cols, ndarray.ndim());
-  auto r = ndarray.unchecked<EL_TYPE, -1>();
-
-  if (ndarray.ndim() == 1) {
-    // input size must be 1x2
-    res(0, 0) = encoder.Encode(r(0), r(1));
-    return res;
-  }
 
-  res.ForEach([&](int64_t row, int64_t, phe::Plaintext *pt) {
-    *pt = encoder.Encode(r(row, 0), r(row, 1));
-  });
+  // pairs are adjacent in a C contiguous buffer
+  auto in = py::array::ensure(ndarray, py::array::c_style);
+  const auto *buf = static_cast<const EL_TYPE *>(in.data());
+  auto *out = res.data();
+
+  py::gil_scoped_release release;
+  yacl::parallel_for(0, rows, bulk_codec::kCodecGrainSize,
+                     [&](int64_t beg, int64_t end) {
+                       for (int64_t row = beg; row < end; ++row) {
+                         out[row] =
+                             encoder.Encode(buf[2 * row], buf[2 * row + 1]);
+                       }
+                     });
   return res;
 }
 
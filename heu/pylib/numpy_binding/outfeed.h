@@ -14,6 +14,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include "pybind11/numpy.h"
 #include "pybind11/pybind11.h"
 #include "yacl/utils/parallel.h"
@@ -21,15 +23,16 @@
 #include "heu/library/numpy/matrix.h"
 #include "heu/library/phe/phe.h"
 #include "heu/pylib/common/traits.h"
+#include "heu/pylib/numpy_binding/bulk_codec.h"
 #include "heu/pylib/phe_binding/py_encoders.h"
 
 namespace heu::pylib {
 
 // Decode PMatrix to python numpy.ndarray
 // Note: PyIntegerEncoder and PyFloatEncoder support parallel decoding,
-// PyBigintEncoder needs to call back python interpreter interface, so
-// parallel decoding is not supported.
-// (Because python interpreter is not thread safe)
+// PyBigintEncoder needs to call back python interpreter interface, so only
+// the extraction of small integers is parallel, python objects are created
+// serially. (Because python interpreter is not thread safe)
 template <typename Encoder_t>
 py::array DecodeNdarray(
     const lib::numpy::PMatrix &in,
@@ -59,32 +62,45 @@ py::array DecodeNdarray(
     res = py::array(py::dtype(Encoder_t::DefaultPyTypeFormat), {rows, cols});
   }
 
-  auto r = res.template mutable_unchecked<typename Encoder_t::DefaultPlainT>();
-
-  std::function<void(int64_t, int64_t)> pfunc;
-  if (in.ndim() == 1) {
-    pfunc = [&](int64_t beg, int64_t end) {
-      for (int64_t row = beg; row < end; ++row) {
-        r(row) = encoder.template Decode<typename Encoder_t::DefaultPlainT>(
-            in(row, 0));
-      }
-    };
+  using PlainT = typename Encoder_t::DefaultPlainT;
+  // res is a fresh C contiguous array, i.e. index j of res is row j / cols
+  auto *out = static_cast<PlainT *>(res.mutable_data());
+  const auto *pts = in.data();
+
+  if constexpr (std::is_same_v<Encoder_t, PyBigintDecoder>) {
+    // Extract the int64 values without the GIL first, so that only the
+    // creation of python objects is serial
+    std::vector<int64_t> values(in.size());
+    std::vector<uint8_t> fits(in.size(), 0);
+    {
+      py::gil_scoped_release release;
+      yacl::parallel_for(0, in.size(), bulk_codec::kCodecGrainSize,
+                         [&](int64_t beg, int64_t end) {
+                           for (int64_t i = beg; i < end; ++i) {
+                             if (pts[i].BitCount() < 64) {
+                               values[i] = pts[i].GetValue<int64_t>();
+                               fits[i] = 1;
+                             }
+                           }
+                         });
+    }
+
+    bulk_codec::ForEachIndex(0, in.size(), rows, cols, true,
+                             [&](int64_t i, int64_t j) {
+                               out[j] = fits[i] ? PyLong_FromLongLong(values[i])
+                                                : encoder.template Decode<
+                                                      PlainT>(pts[i]);
+                             });
   } else {
-    pfunc = [&](int64_t beg, int64_t end) {
-      for (int64_t i = beg; i < end; ++i) {
-        int64_t row = i / cols;
-        int64_t col = i % cols;
-        r(row, col) =
-            encoder.template Decode<typename Encoder_t::DefaultPlainT>(
-                in(row, col));
-      }
-    };
-  }
-
-  if constexpr (std::is_base_of_v<Encoder_t, PyBigintDecoder>) {
-    pfunc(0, in.size());
-  } else {
-    yacl::parallel_for(0, in.size(), kHeOpGrainSize, pfunc);
+    py::gil_scoped_release release;
+    yacl::parallel_for(0, in.size(), bulk_codec::kCodecGrainSize,
+                       [&](int64_t beg, int64_t end) {
+                         bulk_codec::ForEachIndex(
+                             beg, end, rows, cols, true,
+                             [&](int64_t i, int64_t j) {
+                               out[j] = encoder.template Decode<PlainT>(pts[i]);
+                             });
+                       });
   }
   return res;
 }
@@ -113,32 +129,20 @@ py::array DecodeNdarray(
     res = py::array(py::dtype(Encoder_t::DefaultPyTypeFormat), {rows, 2});
   }
 
-  auto r = res.template mutable_unchecked<typename Encoder_t::DefaultPlainT>();
-  if (in.ndim() <= 1 && in.rows() == 1) {
-    r(0) = encoder.template Decode<0>(in(0, 0));
-    r(1) = encoder.template Decode<1>(in(0, 0));
-    return res;
-  }
-
-  if (in.ndim() == 1 && in.rows() > 1) {
-    yacl::parallel_for(0, in.size(), kHeOpGrainSize,
-                       [&](int64_t beg, int64_t end) {
-                         for (int64_t row = beg; row < end; ++row) {
-                           const auto &pt = in(row);
-                           r(row, 0) = encoder.template Decode<0>(pt);
-                           r(row, 1) = encoder.template Decode<1>(pt);
-                         }
-                       });
-  } else {
-    yacl::parallel_for(0, in.size(), kHeOpGrainSize,
-                       [&](int64_t beg, int64_t end) {
-                         for (int64_t row = beg; row < end; ++row) {
-                           const auto &pt = in(row, 0);
-                           r(row, 0) = encoder.template Decode<0>(pt);
-                           r(row, 1) = encoder.template Decode<1>(pt);
-                         }
-                       });
-  }
+  // res is C contiguous, the pair of row i is at out[2 * i] and out[2 * i + 1]
+  auto *out = static_cast<typename Encoder_t::DefaultPlainT *>(
+      res.mutable_data());
+  const auto *pts = in.data();
+
+  py::gil_scoped_release release;
+  yacl::parallel_for(0, rows, bulk_codec::kCodecGrainSize,
+                     [&](int64_t beg, int64_t end) {
+                       for (int64_t row = beg; row < end; ++row) {
+                         out[2 * row] = encoder.template Decode<0>(pts[row]);
+                         out[2 * row + 1] =
+                             encoder.template Decode<1>(pts[row]);
+                       }
+                     });
 
   return res;
 }
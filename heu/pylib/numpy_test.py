@@ -11,9 +11,15 @@
 #  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
 #  See the License for the specific language governing permissions and
 #  limitations under the License.
+import json
+import os
 import pickle
 import sys
+import tempfile
+import threading
+import time
 import unittest
+from concurrent.futures import ThreadPoolExecutor
 
 import numpy as np
 
@@ -91,6 +97,26 @@ class BasicCase(unittest.TestCase):
             phe.BatchIntegerEncoder(self.kit.get_schema()),
         )
 
+    def test_encoder_layout(self):
+        input = np.random.randint(-10000, 10000, (300, 200))
+        for view in [input, input.T, input[::3, 1::2], np.asfortranarray(input)]:
+            self.assert_array_equal(self.kit.array(view), view)
+            edr = self.kit.integer_encoder()
+            self.assert_array_equal(self.kit.array(view, edr), view, edr)
+
+        # python ints of any size in one object array
+        big = 47509577600241629199431517033180053701475
+        input = np.array(
+            [[1, -(2**63)], [big, 2**63 - 1], [-big, 2**63]], dtype=object
+        )
+        for view in [input, input.T, input[::2]]:
+            self.assert_array_equal(self.kit.array(view), view)
+
+        input = np.random.randint(-10000, 10000, (2, 4000))
+        edr = self.kit.batch_integer_encoder()
+        harr = self.kit.array(input.T, phe.BatchIntegerEncoderParams())
+        self.assert_array_equal(harr, input.T, edr)
+
     def test_encoder_parallel(self):
         edr = self.kit.integer_encoder()
         for idx in range(10):
@@ -250,6 +276,237 @@ class BasicCase(unittest.TestCase):
         harr2 = self.kit.array(nparr2)
         self.assert_array_equal(self.evaluator.matmul(harr1, harr2), nparr1 @ nparr2)
 
+    def test_op_stats(self):
+        harr1 = self.encryptor.encrypt(self.kit.array(np.arange(4)))
+        harr2 = self.kit.array(np.ones((4, 3), dtype=np.int64))
+        phe.reset_op_stats()
+        phe.enable_op_stats()
+        try:
+            self.evaluator.matmul(harr1, harr2)
+            self.evaluator.add(harr1, harr1)
+        finally:
+            phe.disable_op_stats()
+
+        stats = phe.op_stats()
+        self.assertEqual(stats["numpy.MatMul"]["calls"], 1)
+        self.assertEqual(stats["numpy.MatMul"]["elements"], 12)
+        self.assertEqual(stats["numpy.Add"]["elements"], 4)
+        phe.reset_op_stats()
+
+    def test_trace(self):
+        if not hnp.trace_compiled_in:
+            with self.assertRaises(RuntimeError):
+                hnp.start_trace()
+            self.skipTest("built without --config=trace")
+
+        harr1 = self.encryptor.encrypt(self.kit.array(np.arange(16).reshape(4, 4)))
+        harr2 = self.kit.array(np.ones((4, 3), dtype=np.int64))
+        hnp.start_trace()
+        self.evaluator.matmul(harr1, harr2)
+        hnp.stop_trace()
+
+        with tempfile.TemporaryDirectory() as tmp:
+            path = os.path.join(tmp, "trace.json")
+            hnp.dump_trace(path)
+            with open(path) as f:
+                events = json.load(f)["traceEvents"]
+        kinds = {(e["name"], e["cat"]) for e in events}
+        self.assertIn(("MatMul", "kernel"), kinds)
+        self.assertIn(("MatMul", "chunk"), kinds)
+
+    def test_inplace_and_fused(self):
+        nparr1 = np.random.randint(-10000, 10000, (20, 30))
+        nparr2 = np.random.randint(-10000, 10000, (20, 1))
+        harr1 = self.encryptor.encrypt(self.kit.array(nparr1))
+        harr2 = self.kit.array(nparr2)
+
+        # broadcast y to the shape of x
+        self.evaluator.add_(harr1, harr2)
+        self.assert_array_equal(harr1, nparr1 + nparr2)
+        self.evaluator.sub_(harr1, self.encryptor.encrypt(harr2))
+        self.assert_array_equal(harr1, nparr1)
+        self.evaluator.mul_(harr1, harr2)
+        self.assert_array_equal(harr1, nparr1 * nparr2)
+
+        # y = a * x + y
+        nparr3 = np.random.randint(-10000, 10000, (20, 30))
+        harr3 = self.encryptor.encrypt(self.kit.array(nparr3))
+        self.evaluator.axpy(self.kit.array(np.array([[3]])), harr1, harr3)
+        self.assert_array_equal(harr3, nparr1 * nparr2 * 3 + nparr3)
+
+        # out += x @ w
+        nparr4 = np.random.randint(-100, 100, (30, 5))
+        acc = self.encryptor.encrypt(self.kit.array(np.zeros((20, 5), np.int64)))
+        self.evaluator.matmul_accumulate(harr3, self.kit.array(nparr4), acc)
+        self.evaluator.matmul_accumulate(harr3, self.kit.array(nparr4), acc)
+        self.assert_array_equal(acc, (nparr1 * nparr2 * 3 + nparr3) @ nparr4 * 2)
+
+    def test_lazy_evaluate(self):
+        nparr1 = np.random.randint(-10000, 10000, (20, 30))
+        nparr2 = np.random.randint(-10000, 10000, (20, 1))
+        nparr3 = np.random.randint(-100, 100, (30, 5))
+        harr1 = self.encryptor.encrypt(self.kit.array(nparr1))
+        harr2 = self.kit.array(nparr2)
+        harr3 = self.kit.array(nparr3)
+
+        lazy = hnp.LazyEvaluator(self.evaluator)
+        x = lazy.input(harr1)
+        y = lazy.add(lazy.mul(x, lazy.input(harr2)), x)
+        self.assertTrue(y.is_ciphertext())
+        self.assertEqual(tuple(y.shape), (20, 30))
+        self.assert_array_equal(lazy.eval(y), nparr1 * nparr2 + nparr1)
+
+        z = lazy.sum(lazy.matmul(y, lazy.input(harr3)))
+        self.assertEqual(z.ndim, 0)
+        self.assertEqual(
+            self.decryptor.phe.decrypt(lazy.eval(z)),
+            phe.Plaintext(
+                self.kit.get_schema(),
+                int(((nparr1 * nparr2 + nparr1) @ nparr3).sum()),
+            ),
+        )
+
+    def test_sparse_matmul(self):
+        # one-hot features, plus some other values
+        nparr1 = np.zeros((20, 30), dtype=np.int64)
+        nparr1[np.arange(20), np.random.randint(0, 30, 20)] = 1
+        nparr1[3, 4] = -1
+        nparr1[5, 6] = 7
+        nparr2 = np.random.randint(-10000, 10000, (30, 5))
+        harr2 = self.encryptor.encrypt(self.kit.array(nparr2))
+
+        # the csr buffers, same as scipy.sparse.csr_matrix
+        rows, cols = np.nonzero(nparr1)
+        indptr = np.searchsorted(rows, np.arange(21))
+        sparse = hnp.SparsePlaintextArray(
+            nparr1.shape, indptr, cols, self.kit.array(nparr1[rows, cols]), "csr"
+        )
+        self.assertEqual(sparse.nnz, len(rows))
+        self.assert_array_equal(self.evaluator.matmul(sparse, harr2), nparr1 @ nparr2)
+
+        # the csc buffers of nparr1.T
+        sparse_t = hnp.SparsePlaintextArray(
+            (30, 20), indptr, cols, self.kit.array(nparr1[rows, cols]), "csc"
+        )
+        harr3 = self.encryptor.encrypt(self.kit.array(nparr2.T))
+        self.assert_array_equal(
+            self.evaluator.matmul(harr3, sparse_t), nparr2.T @ nparr1.T
+        )
+
+    def test_mapped_array(self):
+        nparr1 = np.random.randint(-10000, 10000, (50, 3))
+        nparr2 = np.random.randint(-10000, 10000, (50, 3))
+        with tempfile.TemporaryDirectory() as tmpdir:
+            x = hnp.MappedCiphertextArray.from_array(
+                os.path.join(tmpdir, "x"),
+                self.encryptor.encrypt(self.kit.array(nparr1)),
+            )
+            y = hnp.MappedCiphertextArray.from_array(
+                os.path.join(tmpdir, "y"),
+                self.encryptor.encrypt(self.kit.array(nparr2)),
+            )
+            out = hnp.MappedCiphertextArray.create(
+                os.path.join(tmpdir, "out"), (50, 3), x.record_bytes
+            )
+            self.evaluator.add(x, y, out, chunk_size=16)
+            self.assert_array_equal(out.load(), nparr1 + nparr2)
+
+            nparr3 = np.random.randint(-100, 100, (4, 50))
+            self.assert_array_equal(
+                self.evaluator.matmul(self.kit.array(nparr3), y, chunk_size=16),
+                nparr3 @ nparr2,
+            )
+
+    def test_pickle_out_of_band(self):
+        nparr = np.random.randint(-10000, 10000, (20, 3))
+        ct = self.encryptor.encrypt(self.kit.array(nparr))
+
+        # protocol 5: the serialized array travels out-of-band
+        buffers = []
+        data = pickle.dumps(ct, protocol=5, buffer_callback=buffers.append)
+        self.assertEqual(len(buffers), 1)
+        self.assertLess(len(data), 1024)
+        ct2 = pickle.loads(data, buffers=buffers)
+        self.assert_array_equal(ct2, nparr)
+
+        # in-band protocol 5 and older protocols still work
+        for protocol in range(2, pickle.HIGHEST_PROTOCOL + 1):
+            pt = pickle.loads(pickle.dumps(self.kit.array(nparr), protocol=protocol))
+            self.assert_array_equal(pt, nparr)
+        self.assert_array_equal(
+            hnp.CiphertextArray.load_buffer(memoryview(ct.serialize())), nparr
+        )
+        # a strided view is not the serialized bytes
+        doubled = np.repeat(np.frombuffer(ct.serialize(), dtype=np.uint8), 2)
+        with self.assertRaises(RuntimeError):
+            hnp.CiphertextArray.load_buffer(doubled[::2])
+        self.assert_array_equal(
+            hnp.CiphertextArray.load_buffer(bytes(doubled[::2])), nparr
+        )
+
+    def test_concurrent_threads(self):
+        nparrs = [np.random.randint(-10000, 10000, (30, 30)) for _ in range(8)]
+        harrs = [self.kit.array(a) for a in nparrs]
+
+        # heavy calls release the GIL, so python threads really run in parallel
+        def work(i):
+            ct = self.encryptor.encrypt(harrs[i])
+            ct = self.evaluator.matmul(ct, harrs[i])
+            ct = hnp.CiphertextArray.load_from(ct.serialize())
+            return self.evaluator.sum(ct)
+
+        with ThreadPoolExecutor(max_workers=4) as pool:
+            results = list(pool.map(work, range(len(nparrs))))
+        for nparr, res in zip(nparrs, results):
+            self.assertEqual(
+                self.decryptor.phe.decrypt_raw(res), (nparr @ nparr).sum()
+            )
+
+    def test_executor(self):
+        w = np.random.randint(-100, 100, (4, 2))
+        batches = [np.random.randint(-100, 100, (6, 4)) for _ in range(5)]
+        with hnp.HeExecutor(num_workers=2, max_pending=4) as ex:
+            # encrypt batch i+1 while batch i is being computed
+            cts = [ex.encrypt(self.encryptor, self.kit.array(b)) for b in batches]
+            prods = [
+                ex.matmul(self.evaluator, ct.result(), self.kit.array(w)) for ct in cts
+            ]
+            for b, prod in zip(batches, prods):
+                self.assert_array_equal(prod.result(), b @ w)
+
+            f = ex.submit(self.evaluator.sum, prods[0].result())
+            self.assertEqual(
+                self.decryptor.phe.decrypt_raw(f.result()), (batches[0] @ w).sum()
+            )
+            # exceptions are raised from result()
+            with self.assertRaises(TypeError):
+                ex.decrypt(self.decryptor, self.kit.array(w)).result()
+
+    def test_executor_cancel(self):
+        started = threading.Event()
+        release = threading.Event()
+
+        def block():
+            started.set()
+            release.wait()
+
+        with hnp.HeExecutor(num_workers=1, max_pending=1) as ex:
+            running = ex.submit(block)
+            started.wait()
+            queued = ex.submit(lambda: None)  # takes the only queue slot
+
+            # blocks until the queued job frees its slot
+            producer = threading.Thread(target=lambda: ex.submit(lambda: None))
+            producer.start()
+            time.sleep(0.1)
+            self.assertTrue(queued.cancel())
+            producer.join(timeout=10)
+            self.assertFalse(producer.is_alive())
+
+            release.set()
+            running.result()
+            self.assertTrue(queued.cancelled())
+
     def test_evaluate_parallel(self):
         nparr1 = np.random.randint(-10000, 10000, (100, 100))
         harr1 = self.kit.array(nparr1)
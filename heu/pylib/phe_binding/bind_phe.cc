@@ -20,6 +20,7 @@
 #include "yacl/base/exception.h"
 
 #include "heu/library/phe/base/key_def.h"
+#include "heu/library/phe/op_stats.h"
 #include "heu/pylib/common/py_utils.h"
 #include "heu/pylib/phe_binding/py_encoders.h"
 
@@ -28,6 +29,35 @@ namespace heu::pylib {
 namespace py = ::pybind11;
 namespace phe = ::heu::lib::phe;
 
+namespace {
+
+template <size_t N>
+py::list ToPyList(const std::array<uint64_t, N> &hist) {
+  py::list res;
+  for (auto v : hist) {
+    res.append(v);
+  }
+  return res;
+}
+
+py::dict OpStatsToPyDict(const phe::OpStatsSnapshot &snapshot) {
+  py::dict res;
+  for (const auto &e : snapshot.entries) {
+    py::dict entry;
+    entry["calls"] = e.calls;
+    entry["elements"] = e.elements;
+    entry["bit_len_hist"] = ToPyList(e.bit_len_hist);
+    entry["batch_hist"] = ToPyList(e.batch_hist);
+    entry["latency_hist"] = ToPyList(e.latency_hist);
+    entry["sampled_calls"] = e.sampled_calls;
+    entry["sampled_ns"] = e.sampled_ns;
+    res[py::str(e.name)] = std::move(entry);
+  }
+  return res;
+}
+
+}  // namespace
+
 void PyBindPhe(pybind11::module &m) {
   py::register_local_exception<yacl::Exception>(m, "PheRuntimeError",
                                                 PyExc_RuntimeError);
@@ -240,7 +270,7 @@ void PyBindPhe(pybind11::module &m) {
       },
       py::arg("schema_type"), py::arg("key_size"),
       py::return_value_policy::move,
-      "Setup phe environment by schema type and key size");
+      "Setup phe environment by schema type and key size", ReleaseGil());
 
   m.def(
       "setup",
@@ -249,13 +279,14 @@ void PyBindPhe(pybind11::module &m) {
       },
       py::arg("schema_string"), py::arg("key_size"),
       py::return_value_policy::move,
-      "Setup phe environment by schema string and key size");
+      "Setup phe environment by schema string and key size", ReleaseGil());
 
   m.def(
       "setup",
       [](phe::SchemaType schema_type) { return phe::HeKit(schema_type); },
       py::arg("schema_type") = phe::SchemaType::ZPaillier,
-      py::return_value_policy::move, "Setup phe environment by schema type");
+      py::return_value_policy::move, "Setup phe environment by schema type",
+      ReleaseGil());
 
   m.def(
       "setup",
@@ -263,7 +294,7 @@ void PyBindPhe(pybind11::module &m) {
         return phe::HeKit(phe::ParseSchemaType(schema_string));
       },
       py::arg("schema_string") = "z-paillier", py::return_value_policy::move,
-      "Setup phe environment by schema string");
+      "Setup phe environment by schema string", ReleaseGil());
 
   m.def(
       "setup",
@@ -288,13 +319,17 @@ void PyBindPhe(pybind11::module &m) {
 
   /****** encryption ******/
   py::class_<phe::Encryptor, std::shared_ptr<phe::Encryptor>>(m, "Encryptor")
-      .def("encrypt", &phe::Encryptor::Encrypt, py::arg("plaintext"),
-           "Encrypt plaintext to ciphertext")
+      .def("encrypt",
+           py::overload_cast<const phe::Plaintext &>(&phe::Encryptor::Encrypt,
+                                                     py::const_),
+           py::arg("plaintext"), "Encrypt plaintext to ciphertext",
+           ReleaseGil())
       .def(
           "encrypt_raw",
           [](const phe::Encryptor &encryptor, const py::int_ &num) {
-            return encryptor.Encrypt(
-                PyUtils::PyIntToPlaintext(encryptor.GetSchemaType(), num));
+            auto pt = PyUtils::PyIntToPlaintext(encryptor.GetSchemaType(), num);
+            py::gil_scoped_release release;
+            return encryptor.Encrypt(pt);
           },
           py::arg("cleartext"),
           "Encode and encrypt an integer cleartext. The encoding behavior is "
@@ -302,24 +337,31 @@ void PyBindPhe(pybind11::module &m) {
       .def("encrypt_with_audit", &phe::Encryptor::EncryptWithAudit,
            py::arg("plaintext"),
            "Encrypt and build audit string including "
-           "plaintext/random/ciphertext");
+           "plaintext/random/ciphertext",
+           ReleaseGil());
 
   /****** decryption ******/
   py::class_<phe::Decryptor, std::shared_ptr<phe::Decryptor>>(m, "Decryptor")
       .def("decrypt",
            py::overload_cast<const phe::Ciphertext &>(&phe::Decryptor::Decrypt,
                                                       py::const_),
-           py::arg("ciphertext"), "Decrypt ciphertext to plaintext")
+           py::arg("ciphertext"), "Decrypt ciphertext to plaintext",
+           ReleaseGil())
       .def("decrypt_in_range", &phe::Decryptor::DecryptInRange,
            py::arg("ciphertext"), py::arg("range_bits") = 128,
            "Decrypt ciphertext and make sure plaintext is in range "
            "(-2^range_bits, 2^range_bits). Range checking is used to block OU "
            "plaintext overflow attack, see HEU documentation for details.\n"
-           "throws an exception if plaintext is out of range.")
+           "throws an exception if plaintext is out of range.",
+           ReleaseGil())
       .def(
           "decrypt_raw",
           [](const phe::Decryptor &decryptor, const phe::Ciphertext &ct) {
-            return PyUtils::PlaintextToPyInt(decryptor.Decrypt(ct));
+            auto pt = [&] {
+              py::gil_scoped_release release;
+              return decryptor.Decrypt(ct);
+            }();
+            return PyUtils::PlaintextToPyInt(pt);
           },
           py::arg("ciphertext"),
           "Decrypt and decoding. The decoding behavior is similar to "
@@ -329,35 +371,45 @@ void PyBindPhe(pybind11::module &m) {
   py::class_<phe::Evaluator, std::shared_ptr<phe::Evaluator>>(m, "Evaluator")
       .def("add",
            py::overload_cast<const phe::Ciphertext &, const phe::Plaintext &>(
-               &phe::Evaluator::Add, py::const_))
+               &phe::Evaluator::Add, py::const_),
+           ReleaseGil())
       .def("add",
            py::overload_cast<const phe::Plaintext &, const phe::Ciphertext &>(
-               &phe::Evaluator::Add, py::const_))
+               &phe::Evaluator::Add, py::const_),
+           ReleaseGil())
       .def("add",
            py::overload_cast<const phe::Ciphertext &, const phe::Ciphertext &>(
-               &phe::Evaluator::Add, py::const_))
+               &phe::Evaluator::Add, py::const_),
+           ReleaseGil())
       .def("add_inplace",
            py::overload_cast<phe::Ciphertext *, const phe::Plaintext &>(
-               &phe::Evaluator::AddInplace, py::const_))
+               &phe::Evaluator::AddInplace, py::const_),
+           ReleaseGil())
       .def("add_inplace",
            py::overload_cast<phe::Ciphertext *, const phe::Ciphertext &>(
-               &phe::Evaluator::AddInplace, py::const_))
+               &phe::Evaluator::AddInplace, py::const_),
+           ReleaseGil())
 
       .def("sub",
            py::overload_cast<const phe::Ciphertext &, const phe::Plaintext &>(
-               &phe::Evaluator::Sub, py::const_))
+               &phe::Evaluator::Sub, py::const_),
+           ReleaseGil())
       .def("sub",
            py::overload_cast<const phe::Plaintext &, const phe::Ciphertext &>(
-               &phe::Evaluator::Sub, py::const_))
+               &phe::Evaluator::Sub, py::const_),
+           ReleaseGil())
       .def("sub",
            py::overload_cast<const phe::Ciphertext &, const phe::Ciphertext &>(
-               &phe::Evaluator::Sub, py::const_))
+               &phe::Evaluator::Sub, py::const_),
+           ReleaseGil())
       .def("sub_inplace",
            py::overload_cast<phe::Ciphertext *, const phe::Plaintext &>(
-               &phe::Evaluator::SubInplace, py::const_))
+               &phe::Evaluator::SubInplace, py::const_),
+           ReleaseGil())
       .def("sub_inplace",
            py::overload_cast<phe::Ciphertext *, const phe::Ciphertext &>(
-               &phe::Evaluator::SubInplace, py::const_))
+               &phe::Evaluator::SubInplace, py::const_),
+           ReleaseGil())
 
       .def(
           "mul",
@@ -366,7 +418,7 @@ void PyBindPhe(pybind11::module &m) {
             return evaluator.Mul(ct,
                                  phe::Plaintext(evaluator.GetSchemaType(), p));
           },
-          py::arg("ciphertext"), py::arg("times"))
+          py::arg("ciphertext"), py::arg("times"), ReleaseGil())
       .def(
           "mul",
           [](const phe::Evaluator &evaluator, int64_t p,
@@ -374,18 +426,39 @@ void PyBindPhe(pybind11::module &m) {
             return evaluator.Mul(phe::Plaintext(evaluator.GetSchemaType(), p),
                                  ct);
           },
-          py::arg("ciphertext"), py::arg("times"))
+          py::arg("ciphertext"), py::arg("times"), ReleaseGil())
       .def(
           "mul_inplace",
           [](const phe::Evaluator &evaluator, phe::Ciphertext *ct, int64_t p) {
             evaluator.MulInplace(ct,
                                  phe::Plaintext(evaluator.GetSchemaType(), p));
           },
-          py::arg("ciphertext"), py::arg("times"))
+          py::arg("ciphertext"), py::arg("times"), ReleaseGil())
 
-      .def("negate", py::overload_cast<const phe::Ciphertext &>(
-                         &phe::Evaluator::Negate, py::const_))
-      .def("negate_inplace", py::overload_cast<phe::Ciphertext *>(
-                                 &phe::Evaluator::NegateInplace, py::const_));
+      .def("negate",
+           py::overload_cast<const phe::Ciphertext &>(
+               &phe::Evaluator::Negate, py::const_),
+           ReleaseGil())
+      .def("negate_inplace",
+           py::overload_cast<phe::Ciphertext *>(
+               &phe::Evaluator::NegateInplace, py::const_),
+           ReleaseGil());
+
+  /****** op stats ******/
+  m.def("enable_op_stats", &phe::OpStats::Enable,
+        py::arg("sample_interval") = phe::OpStats::kDefaultSampleInterval,
+        "Start counting the calls of encryptor/decryptor/evaluator, in both "
+        "heu.phe and heu.numpy. The latency of one out of every "
+        "'sample_interval' calls is measured.");
+  m.def("disable_op_stats", &phe::OpStats::Disable,
+        "Stop counting, the collected stats are kept");
+  m.def(
+      "op_stats",
+      [] { return OpStatsToPyDict(phe::OpStats::Snapshot()); },
+      "Get the op stats of all threads as a dict of {op_name: stats}, e.g. "
+      "{'phe.Encrypt': {'calls': 1, 'elements': 1, ...}}. Bucket i of the "
+      "*_hist lists counts values with bit width i, latencies are in "
+      "nanoseconds.");
+  m.def("reset_op_stats", &phe::OpStats::Reset, "Zero all op stats");
 }
 }  // namespace heu::pylib
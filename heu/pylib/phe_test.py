@@ -243,6 +243,30 @@ class BasicCase(unittest.TestCase):
             (123 - 789, 456 - 101112),
         )
 
+    def test_op_stats(self):
+        phe.reset_op_stats()
+        phe.enable_op_stats(sample_interval=1)
+        try:
+            ct = self.encryptor.encrypt_raw(255)
+            self.evaluator.add_inplace(ct, ct)
+            self.assertEqual(self.decryptor.decrypt_raw(ct), 510)
+        finally:
+            phe.disable_op_stats()
+
+        stats = phe.op_stats()
+        self.assertEqual(stats["phe.Encrypt"]["calls"], 1)
+        # 255 has 8 bits, bucket i holds bit lengths in [2^(i-1), 2^i)
+        self.assertEqual(stats["phe.Encrypt"]["bit_len_hist"][4], 1)
+        self.assertEqual(stats["phe.Add"]["elements"], 1)
+        self.assertEqual(stats["phe.Decrypt"]["sampled_calls"], 1)
+        self.assertNotIn("phe.Mul", stats)
+
+        # not counted after disable
+        self.encryptor.encrypt_raw(1)
+        self.assertEqual(phe.op_stats()["phe.Encrypt"]["calls"], 1)
+        phe.reset_op_stats()
+        self.assertEqual(phe.op_stats(), {})
+
     def test_ciphertext_serialize(self):
         # client
         ct1 = self.encryptor.encrypt_raw(123)
@@ -924,3 +924,106 @@ TEST(HEU, API_ElGamal_Evaluate4) {
   DestinationHeKitFree(dhandle);
   HeKitFree(handle);
 }
+
+TEST(HEU, API_OU_CipherRecords) {
+  HeKitHandle handle;
+  HeKitCreate(S_OU, 2048, &handle);
+  auto hekit = static_cast<heu::lib::phe::HeKit *>(handle);
+  std::size_t size = hekit->GetPublicKey()->Serialize().size();
+  PubKeyHandle pkhandle;
+  GetPubKey(hekit, &pkhandle);
+  DestinationHeKitHandle dhandle;
+  DestinationHeKitCreate(pkhandle, size, &dhandle);
+
+  std::size_t record_bytes, drecord_bytes;
+  ASSERT_EQ(HeKitCipherRecordBytes(handle, &record_bytes), 0);
+  ASSERT_EQ(DestinationHeKitCipherRecordBytes(dhandle, &drecord_bytes), 0);
+  EXPECT_EQ(record_bytes, drecord_bytes);
+
+  // more than one chunk of GRAIN_SIZE elements
+  const int64_t len = 1000;
+  std::vector<int64_t> a(len), b(len), weights(len);
+  std::vector<double> d(len);
+  int64_t sum = 0, dot = 0;
+  for (int64_t i = 0; i < len; ++i) {
+    a[i] = i - 300;
+    b[i] = 7 * i;
+    weights[i] = i % 11 - 5;
+    d[i] = i * 0.25 - 100;
+    sum += a[i];
+    dot += a[i] * weights[i];
+  }
+
+  // encrypt/decrypt round trip
+  std::vector<uint8_t> ra(len * record_bytes), rb(len * record_bytes);
+  std::vector<uint8_t> rd(len * record_bytes);
+  ASSERT_EQ(EncryptInt64Records(handle, a.data(), len, ra.data(),
+                                record_bytes),
+            0);
+  ASSERT_EQ(DestinationHeKitEncryptInt64Records(dhandle, b.data(), len,
+                                                rb.data(), record_bytes),
+            0);
+  ASSERT_EQ(EncryptDoubleRecords(handle, d.data(), len, rd.data(),
+                                 record_bytes),
+            0);
+  std::vector<int64_t> res(len);
+  std::vector<double> dres(len);
+  ASSERT_EQ(DecryptInt64Records(handle, ra.data(), len, record_bytes,
+                                res.data()),
+            0);
+  EXPECT_EQ(res, a);
+  ASSERT_EQ(DecryptDoubleRecords(handle, rd.data(), len, record_bytes,
+                                 dres.data()),
+            0);
+  for (int64_t i = 0; i < len; ++i) {
+    EXPECT_NEAR(dres[i], d[i], 1e-6);
+  }
+
+  // evaluate against the plaintext results, the output may alias an input
+  ASSERT_EQ(AddCipherRecords(dhandle, ra.data(), rb.data(), len, record_bytes,
+                             rb.data()),
+            0);
+  ASSERT_EQ(DecryptInt64Records(handle, rb.data(), len, record_bytes,
+                                res.data()),
+            0);
+  for (int64_t i = 0; i < len; ++i) {
+    EXPECT_EQ(res[i], a[i] + b[i]);
+  }
+
+  std::vector<uint8_t> out(record_bytes);
+  int64_t value;
+  ASSERT_EQ(SumCipherRecords(dhandle, ra.data(), len, record_bytes,
+                             out.data()),
+            0);
+  ASSERT_EQ(DecryptInt64Records(handle, out.data(), 1, record_bytes, &value),
+            0);
+  EXPECT_EQ(value, sum);
+  ASSERT_EQ(DotCipherRecords(dhandle, ra.data(), weights.data(), len,
+                             record_bytes, out.data()),
+            0);
+  ASSERT_EQ(DecryptInt64Records(handle, out.data(), 1, record_bytes, &value),
+            0);
+  EXPECT_EQ(value, dot);
+
+  // records that are too small fail instead of overflowing
+  EXPECT_EQ(EncryptInt64Records(handle, a.data(), len, ra.data(), 4), -1);
+  EXPECT_EQ(EncryptInt64Records(handle, a.data(), len, ra.data(), 64), -1);
+  EXPECT_EQ(SumCipherRecords(dhandle, ra.data(), len, 4, out.data()), -1);
+  EXPECT_EQ(DecryptInt64Records(handle, ra.data(), 1, 0, res.data()), -1);
+
+  // empty input
+  EXPECT_EQ(EncryptInt64Records(handle, a.data(), 0, ra.data(), record_bytes),
+            0);
+  EXPECT_EQ(DecryptInt64Records(handle, ra.data(), 0, record_bytes,
+                                res.data()),
+            0);
+  ASSERT_EQ(SumCipherRecords(dhandle, ra.data(), 0, record_bytes, out.data()),
+            0);
+  ASSERT_EQ(DecryptInt64Records(handle, out.data(), 1, record_bytes, &value),
+            0);
+  EXPECT_EQ(value, 0);
+
+  free(pkhandle);
+  DestinationHeKitFree(dhandle);
+  HeKitFree(handle);
+}